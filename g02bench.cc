@@ -0,0 +1,415 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/g02bench.cc
+/// \brief Navigation benchmark program of the persistency/gdml/G02 example
+//
+//
+//
+//
+// --------------------------------------------------------------
+//      GEANT 4 - g02bench
+//
+//  Usage: g02bench [options]
+//
+//    -g, --geometry <name>  builtin (default), a GDML file name
+//                           (e.g. test.gdml, Sphere_System_DEFMAT.gdml)
+//                           or step:<name> for the STEP model (step:mbb),
+//                           or chambers:<N>[:shared][:flat] for N
+//                           parameterised chambers (one solid per copy, or
+//                           one shared solid resized for each copy; in
+//                           blocks, or in a single volume)
+//    -n, --rays <N>         number of rays (default 10000)
+//    -s, --seed <S>         seed of the rays (default 12345)
+//    -r, --repeat <R>       navigation passes, the best is kept (default 3)
+//    -e, --events <M>       geantino events fully tracked (default 1000,
+//                           0 to skip)
+//    -t, --threads <T>      worker threads for the tracked events
+//                           (default 1, sequential run manager)
+//    -f, --flatten <0|1>    collapse the pass-through containers of the
+//                           example geometries (default 0)
+//    -m, --mirror <0|1>     replace the reflections of symmetric solids
+//                           by rotated placements (default 0)
+//    -i, --intern <0|1>     share identical solids and logical volumes
+//                           (default 0)
+//
+//  Results are printed as "key value" lines; the keys and their units
+//  are kept stable so that outputs of different commits can be compared.
+// --------------------------------------------------------------
+
+// Geant4 includes
+//
+#include "G4RunManagerFactory.hh"
+#include "G4UImanager.hh"
+#include "G4GeometryManager.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4VUserActionInitialization.hh"
+#include "G4VUserDetectorConstruction.hh"
+#include "G4NistManager.hh"
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4ParticleGun.hh"
+#include "G4ParticleTable.hh"
+#include "G4Event.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+// A pre-built physics list
+//
+#include "QGSP_BERT.hh"
+
+// Example includes
+//
+#include "G02DetectorConstruction.hh"
+#include "G02ChamberStack.hh"
+#include "G02NavigationBenchmark.hh"
+#include "G02ResourceUsage.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// --------------------------------------------------------------
+
+namespace
+{
+  typedef std::vector<G02NavigationBenchmark::Ray> RayList;
+
+  // Fires one geantino per event along the benchmark rays
+  //
+  class BenchPrimaryGenerator : public G4VUserPrimaryGeneratorAction
+  {
+    public:
+
+      BenchPrimaryGenerator(const RayList* rays)
+        : fRays(rays)
+      {
+        fParticleGun.SetParticleDefinition(
+          G4ParticleTable::GetParticleTable()->FindParticle("geantino"));
+        fParticleGun.SetParticleEnergy(1.0*MeV);
+      }
+
+      virtual void GeneratePrimaries(G4Event* anEvent)
+      {
+        const G02NavigationBenchmark::Ray& ray =
+          (*fRays)[anEvent->GetEventID() % fRays->size()];
+        fParticleGun.SetParticlePosition(ray.fPosition);
+        fParticleGun.SetParticleMomentumDirection(ray.fDirection);
+        fParticleGun.GeneratePrimaryVertex(anEvent);
+      }
+
+    private:
+
+      const RayList* fRays;
+      G4ParticleGun fParticleGun;
+  };
+
+  // The generator of each (worker) thread reads the same rays. The
+  // workers are started by the initialisation, before the rays exist:
+  // they are filled in later, before the first event
+  //
+  class BenchActionInitialization : public G4VUserActionInitialization
+  {
+    public:
+
+      BenchActionInitialization(const RayList* rays)
+        : fRays(rays) {}
+
+      virtual void Build() const
+      {
+        SetUserAction(new BenchPrimaryGenerator(fRays));
+      }
+
+    private:
+
+      const RayList* fRays;
+  };
+
+  // N chambers of G02ChamberStack filling a 2 m long tracker, for the
+  // scaling of the parameterised navigation; "flat" keeps a single
+  // parameterised volume instead of blocks of sqrt(N) chambers
+  //
+  class ChamberDetector : public G4VUserDetectorConstruction
+  {
+    public:
+
+      ChamberDetector(G4int nChambers, G4bool solidPerCopy, G4bool flat)
+        : fChambers(nChambers), fSolidPerCopy(solidPerCopy), fFlat(flat) {}
+
+      virtual G4VPhysicalVolume* Construct()
+      {
+        G4NistManager* nist = G4NistManager::Instance();
+        G4Material* air = nist->FindOrBuildMaterial("G4_AIR");
+        G4Material* aluminium = nist->FindOrBuildMaterial("G4_Al");
+
+        const G4double trackerLength = 2.*m;
+        const G4double spacing = trackerLength/(fChambers+1);
+
+        G02ChamberStack stack(fChambers, spacing, 0.5*spacing,
+                              10.*cm, 100.*cm);
+        stack.SetSolidPerCopy(fSolidPerCopy);
+        if (fFlat) { stack.SetMaxCopiesPerVolume(0); }
+        G4double halfXY = stack.GetMaxHalfLength();
+
+        G4Box* worldBox = new G4Box("World", 1.1*halfXY, 1.1*halfXY,
+                                    0.55*trackerLength);
+        G4LogicalVolume* worldLV =
+          new G4LogicalVolume(worldBox, air, "WorldLV");
+        G4VPhysicalVolume* worldPV =
+          new G4PVPlacement(0, G4ThreeVector(), worldLV, "World", 0,
+                            false, 0);
+
+        G4Box* trackerBox = new G4Box("Tracker", halfXY, halfXY,
+                                      0.5*trackerLength);
+        G4LogicalVolume* trackerLV =
+          new G4LogicalVolume(trackerBox, air, "TrackerLV");
+        new G4PVPlacement(0, G4ThreeVector(), trackerLV, "Tracker", worldLV,
+                          false, 0);
+
+        stack.Place(trackerLV, aluminium);
+
+        return worldPV;
+      }
+
+    private:
+
+      G4int fChambers;
+      G4bool fSolidPerCopy;
+      G4bool fFlat;
+  };
+
+  void PrintUsage()
+  {
+    G4cerr << "Usage: g02bench"
+           << " [-g builtin|<file.gdml>|step:<name>|chambers:<N>[:shared][:flat]]"
+           << " [-n rays] [-s seed] [-r repeat] [-e events] [-t threads]"
+           << " [-f 0|1] [-m 0|1] [-i 0|1]" << G4endl;
+  }
+
+  void PrintValue(const char* key, G4double value)
+  {
+    std::printf("%-28s %.6g\n", key, value);
+  }
+
+  void PrintValue(const char* key, G4long value)
+  {
+    std::printf("%-28s %ld\n", key, value);
+  }
+}
+
+// --------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+  G4String geometry = "builtin";
+  G4int nRays = 10000;
+  G4long seed = 12345;
+  G4int nRepeat = 3;
+  G4int nEvents = 1000;
+  G4int nThreads = 1;
+  G4bool flatten = false;
+  G4bool mirror = false;
+  G4bool intern = false;
+
+  for (G4int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (i+1 == argc)
+    {
+      PrintUsage();
+      return 1;
+    }
+    const char* value = argv[++i];
+    if (!std::strcmp(arg,"-g") || !std::strcmp(arg,"--geometry"))
+      { geometry = value; }
+    else if (!std::strcmp(arg,"-n") || !std::strcmp(arg,"--rays"))
+      { nRays = std::atoi(value); }
+    else if (!std::strcmp(arg,"-s") || !std::strcmp(arg,"--seed"))
+      { seed = std::atol(value); }
+    else if (!std::strcmp(arg,"-r") || !std::strcmp(arg,"--repeat"))
+      { nRepeat = std::max(1, std::atoi(value)); }
+    else if (!std::strcmp(arg,"-e") || !std::strcmp(arg,"--events"))
+      { nEvents = std::atoi(value); }
+    else if (!std::strcmp(arg,"-t") || !std::strcmp(arg,"--threads"))
+      { nThreads = std::max(1, std::atoi(value)); }
+    else if (!std::strcmp(arg,"-f") || !std::strcmp(arg,"--flatten"))
+      { flatten = std::atoi(value) != 0; }
+    else if (!std::strcmp(arg,"-m") || !std::strcmp(arg,"--mirror"))
+      { mirror = std::atoi(value) != 0; }
+    else if (!std::strcmp(arg,"-i") || !std::strcmp(arg,"--intern"))
+      { intern = std::atoi(value) != 0; }
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (nRays < 1)
+  {
+    PrintUsage();
+    return 1;
+  }
+
+  // The navigation benchmark runs on the master thread; the tracked events
+  // are shared among the worker threads, if any
+  //
+  auto* runManager = G4RunManagerFactory::CreateRunManager(
+    nThreads > 1 ? G4RunManagerType::MTOnly : G4RunManagerType::SerialOnly);
+  if (nThreads > 1) { runManager->SetNumberOfThreads(nThreads); }
+
+  if (geometry.compare(0, 9, "chambers:") == 0)
+  {
+    G4String spec = geometry.substr(9);
+    G4int nChambers = std::atoi(spec.c_str());
+    G4bool shared = spec.find(":shared") != std::string::npos;
+    G4bool flat = spec.find(":flat") != std::string::npos;
+    if (nChambers < 1)
+    {
+      PrintUsage();
+      return 1;
+    }
+    runManager->SetUserInitialization(
+      new ChamberDetector(nChambers, !shared, flat));
+  }
+  else
+  {
+    G02DetectorConstruction* detector = new G02DetectorConstruction;
+    detector->SetVerboseLevel(0);
+    detector->SetFlatten(flatten);
+    detector->SetOptimiseReflections(mirror);
+    detector->SetIntern(intern);
+    if (geometry == "builtin")
+    {
+      detector->SetWriteFile("");
+    }
+    else if (geometry.compare(0, 5, "step:") == 0)
+    {
+      detector->SetStepFile(geometry.substr(5));
+    }
+    else
+    {
+      detector->SetReadFile(geometry);
+    }
+    runManager->SetUserInitialization(detector);
+  }
+  runManager->SetUserInitialization(new QGSP_BERT);
+
+  // Set before the initialisation, which builds the user actions of the
+  // worker threads in multi-threaded mode
+  //
+  RayList rays;
+  runManager->SetUserInitialization(new BenchActionInitialization(&rays));
+
+  G4double startTime = G02ResourceUsage::WallTime();
+  runManager->Initialize();
+  G4double initTime = G02ResourceUsage::WallTime() - startTime;
+
+  // Navigation, on the optimised (voxelised) geometry
+  //
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()->GetWorldVolume();
+  G4GeometryManager* geomManager = G4GeometryManager::GetInstance();
+  startTime = G02ResourceUsage::WallTime();
+  geomManager->CloseGeometry(true);
+  G4double voxelTime = G02ResourceUsage::WallTime() - startTime;
+
+  G02NavigationBenchmark bench(world);
+  bench.GenerateRays(nRays, seed);
+  rays = bench.GetRays();
+
+  G02NavigationBenchmark::Result best;
+  for (G4int i = 0; i < nRepeat; ++i)
+  {
+    G02NavigationBenchmark::Result result = bench.Run();
+    if (i == 0 || result.fLocateTime < best.fLocateTime)
+      { best.fLocateTime = result.fLocateTime; }
+    if (i == 0 || result.fStepTime < best.fStepTime)
+      { best.fStepTime = result.fStepTime; }
+    if (i == 0 || result.fRelocateTime < best.fRelocateTime)
+      { best.fRelocateTime = result.fRelocateTime; }
+    best.fLocateCalls = result.fLocateCalls;
+    best.fStepCalls = result.fStepCalls;
+    best.fRelocateCalls = result.fRelocateCalls;
+    best.fPathLength = result.fPathLength;
+    best.fTruncatedRays = result.fTruncatedRays;
+  }
+
+  // Full tracking of geantinos along the same rays. The run set-up
+  // (physics tables, geometry optimisation) is done and timed apart,
+  // by an empty run
+  //
+  G4UImanager::GetUIpointer()->ApplyCommand("/tracking/verbose 0");
+  startTime = G02ResourceUsage::WallTime();
+  runManager->BeamOn(0);
+  G4double setupTime = G02ResourceUsage::WallTime() - startTime;
+
+  G4double trackingTime = 0.;
+  if (nEvents > 0)
+  {
+    startTime = G02ResourceUsage::WallTime();
+    runManager->BeamOn(nEvents);
+    trackingTime = G02ResourceUsage::WallTime() - startTime;
+  }
+
+  // Report
+  //
+  std::printf("# g02bench 1\n");
+  std::printf("%-28s %s\n", "geometry", geometry.c_str());
+  PrintValue("flatten", G4long(flatten));
+  PrintValue("mirror", G4long(mirror));
+  PrintValue("intern", G4long(intern));
+  PrintValue("rays", G4long(nRays));
+  PrintValue("seed", seed);
+  PrintValue("repeat", G4long(nRepeat));
+  PrintValue("init.s", initTime);
+  PrintValue("voxelisation.s", voxelTime);
+  PrintValue("timer.overhead_ns", 1.e9*bench.GetTimerOverhead());
+  PrintValue("locate.calls", best.fLocateCalls);
+  PrintValue("locate.ns_per_call",
+             1.e9*best.fLocateTime/std::max(1L, best.fLocateCalls));
+  PrintValue("computestep.calls", best.fStepCalls);
+  PrintValue("computestep.ns_per_call",
+             1.e9*best.fStepTime/std::max(1L, best.fStepCalls));
+  PrintValue("relocate.calls", best.fRelocateCalls);
+  PrintValue("relocate.ns_per_call",
+             1.e9*best.fRelocateTime/std::max(1L, best.fRelocateCalls));
+  PrintValue("walk.path_length_mm", best.fPathLength/mm);
+  PrintValue("walk.truncated_rays", best.fTruncatedRays);
+  PrintValue("run_setup.s", setupTime);
+  PrintValue("tracking.threads", G4long(nThreads));
+  PrintValue("tracking.events", G4long(nEvents));
+  PrintValue("tracking.s", trackingTime);
+  PrintValue("tracking.events_per_s",
+             trackingTime > 0. ? nEvents/trackingTime : 0.);
+  PrintValue("peak_rss_kb", G02ResourceUsage::PeakResidentMemory());
+
+  delete runManager;
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/g02client.cc
+/// \brief Client program of the geotest server of the G02 example
+//
+//
+//
+//
+// --------------------------------------------------------------
+//      GEANT 4 - g02client
+//
+//  Usage: g02client <socket> [<macro> ...]
+//         g02client <socket> --stop
+//
+//  Sends the commands of the macro files (of the standard input if none
+//  is given) as one job to a server started with
+//  "geotest --server <socket>", and writes the output of the job to the
+//  standard output and error. The exit code is 0 if all the commands
+//  succeeded, 1 otherwise. With --stop, the server is stopped.
+// --------------------------------------------------------------
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// --------------------------------------------------------------
+
+namespace
+{
+  bool SendAll(int fd, const std::string& data)
+  {
+    std::size_t sent = 0;
+    while (sent < data.size())
+    {
+      ssize_t n = send(fd, data.data()+sent, data.size()-sent, 0);
+      if (n < 0 && errno == EINTR) { continue; }
+      if (n <= 0) { return false; }
+      sent += std::size_t(n);
+    }
+    return true;
+  }
+
+  // Writes one line received from the server; returns the status of the
+  // job when the line is the final one, -1 otherwise
+  //
+  int Dispatch(const std::string& line)
+  {
+    if (line.size() < 2) { return -1; }
+    std::string text = line.substr(2);
+    switch (line[0])
+    {
+      case 'o':
+        std::cout << text << '\n';
+        break;
+      case 'e':
+        std::cerr << text << '\n';
+        break;
+      case 's':
+        if (text.compare(0, 5, "done ") == 0)
+        {
+          std::istringstream status(text.substr(5));
+          int executed = 0, code = -1;
+          status >> executed >> code;
+          return code;
+        }
+        std::cerr << "g02client: " << text << '\n';
+        break;
+      default:
+        break;
+    }
+    return -1;
+  }
+}
+
+// --------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: g02client <socket> [<macro> ...]" << std::endl
+              << "       g02client <socket> --stop" << std::endl;
+    return 2;
+  }
+
+  // The job: the macro files, or the standard input
+  //
+  std::string job;
+  if (argc > 2 && std::string(argv[2]) == "--stop")
+  {
+    job = "exit\n";
+  }
+  else if (argc > 2)
+  {
+    for (int i = 2; i < argc; ++i)
+    {
+      std::ifstream macro(argv[i]);
+      if (!macro)
+      {
+        std::cerr << "g02client: cannot open " << argv[i] << std::endl;
+        return 2;
+      }
+      std::ostringstream content;
+      content << macro.rdbuf();
+      job += content.str();
+      job += '\n';
+    }
+  }
+  else
+  {
+    std::ostringstream content;
+    content << std::cin.rdbuf();
+    job = content.str();
+  }
+
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, argv[1], sizeof(address.sun_path)-1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0)
+  {
+    std::cerr << "g02client: cannot connect to " << argv[1] << ": "
+              << std::strerror(errno) << std::endl;
+    return 2;
+  }
+
+  // The end of the job is marked by closing the sending side
+  //
+  if (!SendAll(fd, job) || shutdown(fd, SHUT_WR) != 0)
+  {
+    std::cerr << "g02client: cannot send the job: "
+              << std::strerror(errno) << std::endl;
+    close(fd);
+    return 2;
+  }
+
+  int code = -1;
+  std::string pending;
+  char buffer[4096];
+  for (;;)
+  {
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0) { break; }
+    pending.append(buffer, std::size_t(n));
+
+    std::size_t newline;
+    while ((newline = pending.find('\n')) != std::string::npos)
+    {
+      int status = Dispatch(pending.substr(0, newline));
+      if (status >= 0) { code = status; }
+      pending.erase(0, newline+1);
+    }
+  }
+  close(fd);
+  std::cout << std::flush;
+
+  // A stopped server sends no status
+  //
+  if (job == "exit\n") { return 0; }
+  return code == 0 ? 0 : 1;
+}
@@ -0,0 +1,280 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/g02diff.cc
+/// \brief Geometry comparison program of the persistency/gdml/G02 example
+//
+//
+//
+//
+// --------------------------------------------------------------
+//      GEANT 4 - g02diff
+//
+//  Usage: g02diff [options] <first.gdml> <second.gdml>
+//
+//    -t, --tolerance <mm>   tolerance on the solid parameters and the
+//                           translations (default 1e-6 mm)
+//    -M, --mass-tolerance <r>
+//                           relative tolerance on the masses (default 1e-6)
+//    -m, --mass <0|1>       compute the masses (default 1); the volumes
+//                           of Boolean solids are Monte Carlo estimates,
+//                           with fixed seeds
+//    -p, --parallel <0|1>   read the two files at the same time, in two
+//                           processes (default 1, not on Windows)
+//    -v, --verbose <0|1>    keep the output of the GDML reader (default 0)
+//
+//  The two files are read with G02DetectorConstruction, summarised with
+//  G02GeometrySummary and compared volume by volume. The placements
+//  added, removed or changed (solid, material, mass without daughters,
+//  transform) are printed, in the order of the first geometry. The exit
+//  code is 0 for identical geometries, 1 if they differ, 2 on errors.
+// --------------------------------------------------------------
+
+// Geant4 includes
+//
+#include "G4VPhysicalVolume.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+// Example includes
+//
+#include "G02DetectorConstruction.hh"
+#include "G02GeometrySummary.hh"
+#include "G02ResourceUsage.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#if !defined(_WIN32)
+#  include <fcntl.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+// --------------------------------------------------------------
+
+namespace
+{
+  void PrintUsage()
+  {
+    G4cerr << "Usage: g02diff"
+           << " [-t mm] [-M relative] [-m 0|1] [-p 0|1] [-v 0|1]"
+           << " <first.gdml> <second.gdml>" << G4endl;
+  }
+
+  // Reads the file with the detector construction, releasing the geometry
+  // read before by it, if any
+  //
+  void Summarise(G02DetectorConstruction& detector, const G4String& file,
+                 G4bool masses, G02GeometrySummary& summary)
+  {
+    detector.SetReadFile(file);
+    summary.Build(detector.Construct(), masses);
+  }
+
+#if !defined(_WIN32)
+  // Summary built by a child process, sent back in its text form
+  //
+  struct Child
+  {
+    pid_t fPid;
+    int fFd;
+  };
+
+  G4bool Start(const G4String& file, G4bool masses, G4bool verbose,
+               Child& child)
+  {
+    int fds[2];
+    if (pipe(fds) != 0) { return false; }
+    child.fPid = fork();
+    if (child.fPid < 0)
+    {
+      close(fds[0]);
+      close(fds[1]);
+      return false;
+    }
+    if (child.fPid == 0)
+    {
+      close(fds[0]);
+      if (!verbose)
+      {
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0) { dup2(devNull, STDOUT_FILENO); close(devNull); }
+      }
+      G02DetectorConstruction detector;
+      detector.SetVerboseLevel(0);
+      G02GeometrySummary summary;
+      Summarise(detector, file, masses, summary);
+
+      std::ostringstream out;
+      summary.Write(out);
+      const std::string data = out.str();
+      std::size_t sent = 0;
+      while (sent < data.size())
+      {
+        ssize_t n = write(fds[1], data.data()+sent, data.size()-sent);
+        if (n < 0 && errno == EINTR) { continue; }
+        if (n <= 0) { _exit(2); }
+        sent += std::size_t(n);
+      }
+      close(fds[1]);
+
+      // The stores are left to the end of the process
+      //
+      std::fflush(stdout);
+      _exit(0);
+    }
+    close(fds[1]);
+    child.fFd = fds[0];
+    return true;
+  }
+
+  G4bool Finish(Child& child, G02GeometrySummary& summary)
+  {
+    std::string data;
+    char buffer[65536];
+    for (;;)
+    {
+      ssize_t n = read(child.fFd, buffer, sizeof(buffer));
+      if (n < 0 && errno == EINTR) { continue; }
+      if (n <= 0) { break; }
+      data.append(buffer, std::size_t(n));
+    }
+    close(child.fFd);
+
+    int status = 0;
+    while (waitpid(child.fPid, &status, 0) < 0 && errno == EINTR) {}
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) { return false; }
+
+    std::istringstream in(data);
+    return summary.Read(in);
+  }
+#endif
+}
+
+// --------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+  G02GeometrySummary::Tolerances tolerances;
+  G4bool masses = true;
+  G4bool parallel = true;
+  G4bool verbose = false;
+  G4String files[2];
+  G4int nFiles = 0;
+
+  for (G4int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (arg[0] != '-')
+    {
+      if (nFiles == 2)
+      {
+        PrintUsage();
+        return 2;
+      }
+      files[nFiles++] = arg;
+      continue;
+    }
+    if (i+1 == argc)
+    {
+      PrintUsage();
+      return 2;
+    }
+    const char* value = argv[++i];
+    if (!std::strcmp(arg,"-t") || !std::strcmp(arg,"--tolerance"))
+      { tolerances.fLength = std::atof(value)*mm; }
+    else if (!std::strcmp(arg,"-M") || !std::strcmp(arg,"--mass-tolerance"))
+      { tolerances.fMass = std::atof(value); }
+    else if (!std::strcmp(arg,"-m") || !std::strcmp(arg,"--mass"))
+      { masses = std::atoi(value) != 0; }
+    else if (!std::strcmp(arg,"-p") || !std::strcmp(arg,"--parallel"))
+      { parallel = std::atoi(value) != 0; }
+    else if (!std::strcmp(arg,"-v") || !std::strcmp(arg,"--verbose"))
+      { verbose = std::atoi(value) != 0; }
+    else
+    {
+      PrintUsage();
+      return 2;
+    }
+  }
+  if (nFiles != 2)
+  {
+    PrintUsage();
+    return 2;
+  }
+
+  G4double startTime = G02ResourceUsage::WallTime();
+  G02GeometrySummary summaries[2];
+
+#if !defined(_WIN32)
+  if (parallel)
+  {
+    // The Geant4 stores are global: each file is read by its own process
+    //
+    Child children[2];
+    for (G4int k = 0; k < 2; ++k)
+    {
+      if (!Start(files[k], masses, verbose, children[k]))
+      {
+        G4cerr << "g02diff: cannot start the reading of " << files[k]
+               << ": " << std::strerror(errno) << G4endl;
+        return 2;
+      }
+    }
+    G4bool ok = true;
+    for (G4int k = 0; k < 2; ++k)
+    {
+      if (!Finish(children[k], summaries[k]))
+      {
+        G4cerr << "g02diff: cannot read " << files[k] << G4endl;
+        ok = false;
+      }
+    }
+    if (!ok) { return 2; }
+  }
+  else
+#endif
+  {
+    G02DetectorConstruction detector;
+    detector.SetVerboseLevel(verbose ? 1 : 0);
+    for (G4int k = 0; k < 2; ++k)
+    {
+      Summarise(detector, files[k], masses, summaries[k]);
+    }
+  }
+
+  G4int differences = summaries[0].Compare(summaries[1], std::cout,
+                                           tolerances);
+  std::printf("compared in %.2f s\n",
+              G02ResourceUsage::WallTime() - startTime);
+
+  return differences > 0 ? 1 : 0;
+}
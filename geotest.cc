@@ -32,12 +32,19 @@
 // --------------------------------------------------------------
 //      GEANT 4 - geotest
 //
+//  Usage: geotest                      interactive session
+//         geotest <macro>              batch job
+//         geotest --server <socket> [<macro>]
+//                                      server of jobs sent by g02client
+//                                      over a Unix domain socket, after
+//                                      the optional set-up macro
 // --------------------------------------------------------------
 
 // Geant4 includes
 //
 #include "G4RunManagerFactory.hh"
 #include "G4UImanager.hh"
+#include "G4StateManager.hh"
 #include "globals.hh"
 
 // A pre-built physics list
@@ -47,8 +54,9 @@
 // Example includes
 //
 #include "G02DetectorConstruction.hh"
-#include "G02PrimaryGeneratorAction.hh"
-#include "G02RunAction.hh"
+#include "G02ActionInitialization.hh"
+#include "G02StartupProfiler.hh"
+#include "G02MacroServer.hh"
 
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
@@ -57,18 +65,28 @@
 
 int main(int argc, char** argv)
 {
-  // Construct a serial run manager
+  // Start-up profiling; the table is printed at the end of the job
+  // if enabled with /mydet/profile/enable
   //
-  auto* runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::SerialOnly);
+  G02StartupProfiler* profiler = G02StartupProfiler::Instance();
+
+  // Construct the run manager: serial by default, multi-threaded or
+  // tasking if selected with the G4RUN_MANAGER_TYPE environment variable
+  // (the number of threads is then set with /run/numberOfThreads or
+  // G4FORCENUMBEROFTHREADS)
+  //
+  profiler->BeginPhase("geotest/run manager");
+  auto* runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Serial);
+  profiler->EndPhase();
 
   // Set mandatory initialization and user action classes
   //
+  profiler->BeginPhase("geotest/user initialisation");
   G02DetectorConstruction* detector = new G02DetectorConstruction;
   runManager->SetUserInitialization(detector);
   runManager->SetUserInitialization(new QGSP_BERT);
-  runManager->SetUserAction(new G02PrimaryGeneratorAction);
-  G02RunAction* runAction = new G02RunAction;
-  runManager->SetUserAction(runAction);
+  runManager->SetUserInitialization(new G02ActionInitialization);
+  profiler->EndPhase();
 
   // Initialisation of runManager via macro for the interactive mode
   // This gives possibility to give different names for GDML file to READ
@@ -83,21 +101,59 @@ int main(int argc, char** argv)
 
   if ( argc==1 )   // Automatically run default macro for writing...
   {
+     profiler->BeginPhase("geotest/vis initialisation");
      visManager = new G4VisExecutive;
      visManager->Initialize();
+     profiler->EndPhase();
      G4UIExecutive* ui = new G4UIExecutive(argc, argv);
     ui->SessionStart();
     delete ui;
   }
+  else if ( G4String(argv[1]) == "--server" )   // Serves jobs
+  {
+    if ( argc < 3 )
+    {
+      G4cerr << "Usage: geotest --server <socket> [<macro>]" << G4endl;
+      delete runManager;
+      return 1;
+    }
+    if ( argc > 3 )
+    {
+      G4String fileName = argv[3];
+      profiler->BeginPhase("geotest/macro "+fileName);
+      UImanager->ApplyCommand("/control/execute "+fileName);
+      profiler->EndPhase();
+    }
+
+    // The kernel, the physics list and the geometry are initialised once,
+    // before the first job
+    //
+    if ( G4StateManager::GetStateManager()->GetCurrentState()
+         == G4State_PreInit )
+    {
+      UImanager->ApplyCommand("/run/initialize");
+    }
+    profiler->Finish();
+
+    G02MacroServer* server = new G02MacroServer(argv[2]);
+    server->SessionStart();
+    delete server;
+    delete runManager;
+    return 0;
+  }
   else             // Interactive, provides macro in input
   {
     G4String command = "/control/execute ";
     G4String fileName = argv[1];
+    profiler->BeginPhase("geotest/macro "+fileName);
     UImanager->ApplyCommand(command+fileName);
+    profiler->EndPhase();
   }
 
   // Job termination
   //
+  profiler->Finish();
+
   if (visManager) {
     delete visManager;
   }
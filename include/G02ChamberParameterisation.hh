@@ -34,12 +34,30 @@
 // The boxes have equal width; their lengths are a linear equation.
 // They are spaced an equal distance apart, starting from a given location.
 //
+// The positions and half-lengths of all the copies are tabulated at
+// construction. By default one G4Box is also built per copy and returned
+// by ComputeSolid(), so that the navigation never modifies a solid; with
+// solidPerCopy=false the solid of the logical volume is shared and resized
+// for each copy, as in the original N02 parameterisation.
+//
+// Thread safety: the tables and the per-copy solids are filled once, by
+// the master thread, and only read afterwards, so that worker threads
+// share them without locks. What the navigation modifies is private to
+// each thread in multi-threaded mode: the translation and rotation set
+// by ComputeTransformation() are kept per thread by G4VPhysicalVolume,
+// and the solid of the logical volume, resized by ComputeDimensions() in
+// shared-solid mode, is cloned for each worker by the kernel.
+//
 // ----------------------------------------------------------------------------
 
 #ifndef G02ChamberParameterisation_H
 #define G02ChamberParameterisation_H 1
 
+#include <unordered_set>
+#include <vector>
+
 #include "globals.hh"
+#include "G4ThreeVector.hh"
 #include "G4VPVParameterisation.hh"
 
 class G4VPhysicalVolume;
@@ -73,16 +91,23 @@ class G02ChamberParameterisation : public G4VPVParameterisation
                             G4double spacing,
                             G4double widthChamber, 
                             G4double lengthInitial,
-                            G4double lengthFinal );
+                            G4double lengthFinal,
+                            G4bool   solidPerCopy = true );
 
    ~G02ChamberParameterisation();
    
     void ComputeTransformation (const G4int copyNo,
                                 G4VPhysicalVolume* physVol) const;
     
+    G4VSolid* ComputeSolid (const G4int copyNo, G4VPhysicalVolume* physVol);
+
     void ComputeDimensions (G4Box & trackerLayer, const G4int copyNo,
                             const G4VPhysicalVolume* physVol) const;
 
+    // Largest chamber half-length, to size the mother volume
+    //
+    G4double GetMaxHalfLength() const;
+
   private:  // Dummy declarations to get rid of warnings ...
 
     void ComputeDimensions (G4Trd&,const G4int,const G4VPhysicalVolume*) const {}
@@ -101,11 +126,13 @@ class G02ChamberParameterisation : public G4VPVParameterisation
   private:
 
     G4int    fNoChambers;   
-    G4double fStartZ;
     G4double fHalfWidth;        //  The half-width of each tracker chamber
-    G4double fSpacing;          //  The distance between the chambers' center
-    G4double fHalfLengthFirst;  //  The first half-length 
-    G4double fHalfLengthIncr;   //  The Increment for the half-length 
+
+    std::vector<G4ThreeVector> fTranslations;  //  Per copy
+    std::vector<G4double> fHalfLengths;        //  Per copy
+    std::vector<G4Box*> fSolids;               //  Per copy, if requested;
+                                               //  owned by the solid store
+    std::unordered_set<const G4Box*> fSolidSet; //  The same, for lookups
 };
 
 // ----------------------------------------------------------------------------
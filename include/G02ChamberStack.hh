@@ -0,0 +1,121 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02ChamberStack.hh
+/// \brief Definition of the G02ChamberStack class
+//
+//
+//
+// Class G02ChamberStack
+//
+// Builds the stack of tracker chambers of the example, N boxes along Z
+// described by a G02ChamberParameterisation, for any number of chambers.
+//
+// A parameterised volume is voxelised along its axis (Z here) into at most
+// about one thousand slices, so that a single G4PVParameterised with many
+// more copies leaves many chambers per voxel and the navigation cost grows
+// with N. Above a given number of copies the chambers are therefore grouped
+// in about sqrt(N) consecutive blocks of sqrt(N) chambers: each block is a
+// box, tight around its chambers, holding its own parameterisation. Both
+// levels then stay well within the voxel limits, giving one or two
+// candidates per voxel and a locate/step cost independent of N.
+//
+// In the grouped layout the chamber with global index i is the copy
+// i % B of the block with copy number i / B, B being GetChambersPerBlock().
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02ChamberStack_h
+#define G02ChamberStack_h 1
+
+#include "globals.hh"
+
+class G4LogicalVolume;
+class G4Material;
+class G02GeometryArena;
+
+// ----------------------------------------------------------------------------
+
+/// Builder of the chamber stack used in GDML read/write example
+
+class G02ChamberStack
+{
+  public:
+
+    G02ChamberStack(G4int    nChambers,
+                    G4double spacing,        // Z spacing of the centres
+                    G4double width,          // Z width of each chamber
+                    G4double lengthInitial,  // X/Y length of the first one
+                    G4double lengthFinal);
+   ~G02ChamberStack();
+
+    // Number of copies above which the chambers are grouped in blocks
+    // (default 1000); 0 keeps a single parameterised volume for any N
+    //
+    inline void SetMaxCopiesPerVolume(G4int val) { fMaxCopiesPerVolume = val; }
+    inline void SetSolidPerCopy(G4bool val) { fSolidPerCopy = val; }
+
+    // Full length of the stack along Z, (N+1)*spacing, and half-length in
+    // X/Y of the largest chamber: the extent of the box filled by Place()
+    //
+    inline G4double GetLength() const { return (fChambers+1)*fSpacing; }
+    G4double GetMaxHalfLength() const;
+
+    // Sum of the cubic volumes of the chambers, in closed form
+    //
+    G4double GetChambersVolume() const;
+
+    // Chambers per block, equal to N when they are not grouped
+    //
+    G4int GetChambersPerBlock() const;
+
+    // Places the chambers centred on the origin of the mother volume;
+    // the blocks, if any, are filled with the material of the mother. The
+    // parameterisations are adopted by the arena, if given.
+    //
+    void Place(G4LogicalVolume* motherLV, G4Material* chamberMaterial,
+               G02GeometryArena* arena = 0) const;
+
+  private:
+
+    G4double ChamberZ(G4int index) const;
+    G4double ChamberHalfLength(G4int index) const;
+    G4LogicalVolume* NewChamberLV(G4Material* material) const;
+
+  private:
+
+    G4int    fChambers;
+    G4double fSpacing;
+    G4double fWidth;
+    G4double fLengthInitial;
+    G4double fLengthFinal;
+
+    G4int    fMaxCopiesPerVolume;
+    G4bool   fSolidPerCopy;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02CoherentNavigator.hh
+/// \brief Definition of the G02CoherentNavigator class
+//
+//
+//
+// Class G02CoherentNavigator
+//
+// Navigator for streams of point locations where consecutive points are
+// close to each other (voxel rows, scans on a grid). Locate() starts from
+// the touchable history left by the previous location instead of the top
+// of the geometry:
+//
+//  - a point still inside the current volume, and outside its daughters,
+//    is accepted after a few Inside() calls, without any search;
+//  - otherwise the search goes up the mother chain, to the first ancestor
+//    containing the point, and down again from there (relative location);
+//  - only the points that left every ancestor but the world are searched
+//    from the top.
+//
+// The outcome of every location is counted, to report the hit rates.
+// The shortcut is taken for placements only: replicas and parameterised
+// volumes, current or daughters, always go through the relative location.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02CoherentNavigator_h
+#define G02CoherentNavigator_h 1
+
+#include <iosfwd>
+#include <vector>
+
+#include "globals.hh"
+#include "G4Navigator.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Incremental point location used in GDML read/write example
+
+class G02CoherentNavigator : public G4Navigator
+{
+  public:
+
+    struct Statistics
+    {
+      Statistics();
+
+      void Add(const Statistics& other);
+      void Print(std::ostream& out) const;
+
+      G4long fLocations;
+      G4long fSameVolume;    // Accepted in the current volume, no search
+      G4long fMotherChain;   // Resumed below the world
+      G4long fTopDown;       // Resumed at the world
+      G4long fOutside;       // Outside the world
+      G4long fLevelsUp;      // Levels left, summed over the searches
+    };
+
+  public:
+
+    G02CoherentNavigator();
+    virtual ~G02CoherentNavigator();
+
+    // Locates the point starting from the previous location; the direction,
+    // if given, is used for the points on a boundary
+    //
+    G4VPhysicalVolume* Locate(const G4ThreeVector& point,
+                              const G4ThreeVector* direction = 0);
+
+    // Keeps track of the locations made directly through the navigator
+    //
+    virtual G4VPhysicalVolume*
+    LocateGlobalPointAndSetup(const G4ThreeVector& point,
+                              const G4ThreeVector* direction = 0,
+                              const G4bool relativeSearch = true,
+                              const G4bool ignoreDirection = true);
+
+    // Daughters of the current volume checked one by one before giving up
+    // the shortcut (default 8)
+    //
+    inline void SetMaxDaughterTests(G4int n) { fMaxDaughterTests = n; }
+
+    inline const Statistics& GetStatistics() const { return fStatistics; }
+    inline void ResetStatistics() { fStatistics = Statistics(); }
+
+  private:
+
+    // True if the point is inside the current volume and outside all its
+    // daughters, as far as can be told without a search
+    //
+    G4bool InCurrentVolume(const G4ThreeVector& point) const;
+
+  private:
+
+    struct Level
+    {
+      const G4VPhysicalVolume* fVolume;
+      G4int fReplicaNo;
+    };
+
+    G4int fMaxDaughterTests;
+    G4bool fOutsideWorld;        // The last location left the world
+    std::vector<Level> fPath;    // Levels before a search
+    Statistics fStatistics;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -45,6 +45,16 @@
 
 #include "globals.hh"
 
+#include "G02SolidInterner.hh"
+#include "G02GeometryArena.hh"
+#include "G02LazyGDMLReader.hh"
+#include "G02LevelOfDetail.hh"
+#include "G02PrimitiveRecogniser.hh"
+#include "G02MassReport.hh"
+#include "G02VoxelMap.hh"
+
+#include <map>
+
 class G02DetectorMessenger;
 
 // ----------------------------------------------------------------------------
@@ -73,15 +83,106 @@ class G02DetectorConstruction : public G4VUserDetectorConstruction
     //
     void ListOfMaterials();
 
+    // Printout of the element and material tables: level 0 is silent,
+    // 1 prints one-line summaries, 2 prints the full tables. The verbose
+    // level (default 2) is used for the printout done at construction.
+    //
+    void SetVerboseLevel( G4int level ) { fVerboseLevel = level; }
+    G4int GetVerboseLevel() const { return fVerboseLevel; }
+    void PrintElements( G4int level ) const;
+    void PrintMaterials( G4int level ) const;
+
     // Writing and Reading GDML
     //
     void SetReadFile( const G4String& File );
+
+    // Replacement of the geometry in the Idle state by the one of a GDML
+    // file, keeping the physics tables of the unchanged materials
+    //
+    void SwapGeometry( const G4String& File );
+
+    // Lazy GDML reading: the tessellated solids are built when first
+    // needed by the navigation
+    //
+    void SetLazy( G4bool val ) { fReader.SetLazy(val); }
+
+    // Export of the tessellated solids of the geometry to a mesh file, and
+    // replacement of the tessellated solids of the GDML files read next
+    // by the meshes of such a file, mapped in memory
+    //
+    G4bool ExportMeshes( const G4String& File ) const;
+    void SetMeshFile( const G4String& File ) { fMeshFile = File; }
     void SetWriteFile( const G4String& File );
 
+    // Replacement of the tessellated solids of the geometries read next
+    // by the primitives they tessellate
+    //
+    void SetRecognisePrimitives( G4bool val ) { fRecogniser.SetEnabled(val); }
+    void SetPrimitiveTolerance( G4double val ) { fRecogniser.SetTolerance(val); }
+
+    // Simplified proxies of the tessellated solids, built at the import of
+    // the geometries read next and selected in place of the full solids
+    // between runs
+    //
+    void SetLevelOfDetail( G4bool val ) { fLevelOfDetail.SetEnabled(val); }
+    void SetLODTargetFacets( G4int n ) { fLevelOfDetail.SetTargetFacets(n); }
+    void SetLODTolerance( G4double val ) { fLevelOfDetail.SetTolerance(val); }
+    void SetLODMaxVolumeError( G4double val )
+      { fLevelOfDetail.SetMaxVolumeError(val); }
+    void SelectProxies( G4bool val );
+    void ApplyProxySelection() const { fLevelOfDetail.Apply(); }
+
     // Reading STEP File
     //
     void SetStepFile( const G4String& File );
 
+    // Chamber stack of ConstructParametrisationChamber()
+    //
+    void SetChamberCount( G4int n ) { fChamberCount = n; }
+    void SetChamberSpacing( G4double val ) { fChamberSpacing = val; }
+    void SetChamberWidth( G4double val ) { fChamberWidth = val; }
+
+    // Flattening of the pass-through containers after construction
+    //
+    void SetFlatten( G4bool val ) { fFlatten = val; }
+
+    // Replacement of the reflected solids by rigid placements, or their
+    // sharing, after construction
+    //
+    void SetOptimiseReflections( G4bool val ) { fOptimiseReflections = val; }
+
+    // Interning of the duplicate solids and logical volumes, at creation
+    // and after construction
+    //
+    void SetIntern( G4bool val ) { fInterner.SetEnabled(val); }
+
+    // Cubic volume and mass of the logical volumes of the current geometry
+    //
+    G4bool MassReport( const G4String& File );
+    void SetMassPoints( G4long n ) { fMassReport.SetPoints(n); }
+    void SetMassThreads( G4int n ) { fMassReport.SetThreads(n); }
+
+    // Export of the materials of the current geometry on a regular grid
+    //
+    G4bool ExportVoxelMap( const G4String& File );
+    void SetVoxelBins( G4int nx, G4int ny, G4int nz )
+      { fVoxelMap.SetBins(nx, ny, nz); }
+    void SetVoxelThreads( G4int n ) { fVoxelMap.SetThreads(n); }
+
+  private:
+
+    // Replacement of the tessellated solids by the meshes of fMeshFile
+    //
+    G4int MapMeshes();
+
+    // Gives the logical volumes the replacements of their solids, as
+    // G02SolidInterner::SwapSolids() does, and frees the solids replaced
+    // that no other solid or volume refers to; returns the number of
+    // logical volumes changed
+    //
+    G4int ReplaceSolids( const std::map<G4VSolid*, G4VSolid*>& replacements,
+                         G4int& freed );
+
   private:
 
     G4Material* fAir ;
@@ -89,8 +190,9 @@ class G02DetectorConstruction : public G4VUserDetectorConstruction
     G4Material* fPb;
     G4Material* fXenon;
 
-    // GDMLparser
+    // GDMLparser, with the reader deferring the tessellated solids
     //
+    G02LazyGDMLReader fReader;
     G4GDMLParser fParser;
         
     // Reading and Writing Settings
@@ -99,6 +201,27 @@ class G02DetectorConstruction : public G4VUserDetectorConstruction
     G4String fWriteFile;
     G4String fStepFile;
     G4int fWritingChoice;
+    G4int fVerboseLevel;
+    G4String fMeshFile;
+
+    // Chamber stack settings
+    //
+    G4int fChamberCount;
+    G4double fChamberSpacing;
+    G4double fChamberWidth;
+    G4double fChamberMass;    // Of the built-in stack, 0 for GDML files
+    G4bool fFlatten;
+    G4bool fOptimiseReflections;
+    G02SolidInterner fInterner;
+    G02PrimitiveRecogniser fRecogniser;
+    G02LevelOfDetail fLevelOfDetail;
+    G02MassReport fMassReport;
+    G02VoxelMap fVoxelMap;
+
+    // Owner of the geometry built, released when it is rebuilt
+    //
+    G02GeometryArena fArena;
+    G4VPhysicalVolume* fSwappedWorld;   // Swapped in, not yet initialised
 
     // Detector Messenger
     //
@@ -44,6 +44,11 @@ class G02DetectorConstruction;
 class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWith3Vector;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
 
 // ----------------------------------------------------------------------------
 
@@ -64,8 +69,46 @@ class G02DetectorMessenger: public G4UImessenger
     G02DetectorConstruction*      fTheDetector;
     G4UIdirectory*             fTheDetectorDir;
     G4UIcmdWithAString*        fTheReadCommand;
+    G4UIcmdWithAString*        fTheSwapCommand;
+    G4UIcmdWithABool*          fTheLazyCommand;
+    G4UIcmdWithAString*        fTheExportMeshesCommand;
+    G4UIcmdWithAString*        fTheMeshFileCommand;
     G4UIcmdWithAString*        fTheWriteCommand;
     G4UIcmdWithAString*        fTheStepCommand;
+    G4UIcmdWithAnInteger*      fTheVerboseCommand;
+    G4UIcmdWithAnInteger*      fThePrintElementsCommand;
+    G4UIcmdWithAnInteger*      fThePrintMaterialsCommand;
+    G4UIcmdWithABool*          fTheFlattenCommand;
+    G4UIcmdWithABool*          fTheReflectionsCommand;
+    G4UIcmdWithABool*          fTheInternCommand;
+    G4UIcmdWithAString*        fTheMassReportCommand;
+    G4UIcmdWithAnInteger*      fTheMassPointsCommand;
+    G4UIcmdWithAnInteger*      fTheMassThreadsCommand;
+    G4UIcmdWithAString*        fTheVoxelMapCommand;
+    G4UIcmdWith3Vector*        fTheVoxelBinsCommand;
+    G4UIcmdWithAnInteger*      fTheVoxelThreadsCommand;
+
+    G4UIdirectory*             fTheProfileDir;
+    G4UIcmdWithABool*          fTheProfileCommand;
+    G4UIcmdWithAString*        fTheTraceFileCommand;
+    G4UIcmdWithABool*          fTheTrialVoxelCommand;
+    G4UIcmdWithoutParameter*   fThePrintProfileCommand;
+
+    G4UIdirectory*             fThePrimitivesDir;
+    G4UIcmdWithABool*          fTheRecogniseCommand;
+    G4UIcmdWithADoubleAndUnit* fThePrimitiveToleranceCommand;
+
+    G4UIdirectory*             fTheLODDir;
+    G4UIcmdWithABool*          fTheLODBuildCommand;
+    G4UIcmdWithAnInteger*      fTheLODTargetCommand;
+    G4UIcmdWithADoubleAndUnit* fTheLODToleranceCommand;
+    G4UIcmdWithADouble*        fTheLODVolumeErrorCommand;
+    G4UIcmdWithAString*        fTheLODSelectCommand;
+
+    G4UIdirectory*             fTheChambersDir;
+    G4UIcmdWithAnInteger*      fTheChamberNumberCommand;
+    G4UIcmdWithADoubleAndUnit* fTheChamberSpacingCommand;
+    G4UIcmdWithADoubleAndUnit* fTheChamberWidthCommand;
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02EventAction.hh
+/// \brief Definition of the G02EventAction class
+//
+//
+//
+// Class G02EventAction
+//
+// Event action recording the wall time of each event in G02Run, for the
+// latency percentiles of the end-of-run throughput report.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02EventAction_h
+#define G02EventAction_h 1
+
+#include "globals.hh"
+#include "G4UserEventAction.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Event action used in GDML read/write example
+
+class G02EventAction : public G4UserEventAction
+{
+  public:
+
+    G02EventAction();
+   ~G02EventAction();
+
+    virtual void BeginOfEventAction(const G4Event*);
+    virtual void EndOfEventAction(const G4Event*);
+
+  private:
+
+    G4double fStartTime;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
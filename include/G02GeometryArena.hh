@@ -0,0 +1,111 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02GeometryArena.hh
+/// \brief Definition of the G02GeometryArena class
+//
+//
+//
+// Class G02GeometryArena
+//
+// Owner of one geometry built by the example, released in one step when
+// the geometry is replaced (e.g. "/mydet/readFile" in the Idle state).
+//
+// The solids, logical and physical volumes are owned by the Geant4 stores,
+// which delete them with their own "delete": Release() empties the stores
+// in bulk, the assemblies first since they delete their imprinted
+// placements. The objects that no store owns, the rotation matrices and
+// visualisation attributes given by pointer to the volumes and the volume
+// parameterisations, are allocated here: the rotations and attributes in
+// contiguous pools of fixed-size blocks, freed all together, the
+// parameterisations adopted and deleted at the release.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02GeometryArena_h
+#define G02GeometryArena_h 1
+
+#include <deque>
+#include <vector>
+
+#include "globals.hh"
+#include "G4RotationMatrix.hh"
+#include "G4VisAttributes.hh"
+
+class G4Colour;
+class G4VPVParameterisation;
+
+// ----------------------------------------------------------------------------
+
+/// Geometry arena used in GDML read/write example
+
+class G02GeometryArena
+{
+  public:
+
+    G02GeometryArena();
+   ~G02GeometryArena();
+
+    // Objects owned by the arena, valid until Release()
+    //
+    G4RotationMatrix* NewRotation();
+    G4RotationMatrix* NewRotation(const G4RotationMatrix& rotation);
+    G4VisAttributes* NewVisAttributes(const G4Colour& colour);
+    G4VPVParameterisation* Adopt(G4VPVParameterisation* parameterisation);
+
+    // Deletes the whole geometry: the content of the assembly, physical
+    // volume, logical volume and solid stores, the reflection factory maps,
+    // the optical surface tables and the objects of the arena. The geometry
+    // must not be in use.
+    //
+    void Release();
+
+    // True when objects have been allocated since the last release
+    //
+    inline G4bool IsInUse() const { return fInUse; }
+
+    // Marks the arena as holding a geometry, e.g. one built only from
+    // store-owned objects
+    //
+    inline void SetInUse() { fInUse = true; }
+
+  private:
+
+    G02GeometryArena(const G02GeometryArena&);
+    G02GeometryArena& operator=(const G02GeometryArena&);
+
+  private:
+
+    // A deque allocates by blocks and never moves its elements
+    //
+    std::deque<G4RotationMatrix> fRotations;
+    std::deque<G4VisAttributes> fVisAttributes;
+    std::vector<G4VPVParameterisation*> fParameterisations;
+    G4bool fInUse;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
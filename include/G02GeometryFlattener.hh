@@ -0,0 +1,114 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02GeometryFlattener.hh
+/// \brief Definition of the G02GeometryFlattener class
+//
+//
+//
+// Class G02GeometryFlattener
+//
+// Optional optimisation pass run on the geometry tree after its
+// construction or GDML reading. Every level of the tree crossed by a
+// track costs a coordinate transformation at each step and a relocation
+// at each boundary; containers made of the material of their mother
+// ("air in air") only add such levels. The pass removes the placements of
+// these pass-through containers and places their daughters directly in
+// the mother, with the composed transformation. Assembly imprints, whose
+// components are placed in the imprint target, are flattened in the same
+// way when the target is such a container.
+//
+// A container is collapsed only if:
+//  - it is a simple placement, not a replica or parameterised volume;
+//  - its logical volume has the material and the field manager of the
+//    mother one, and no sensitive detector, user limits or region of its
+//    own;
+//  - its solid is convex and all its daughters are simple placements whose
+//    bounding boxes lie inside it, so that no overlap with the siblings of
+//    the container can appear.
+//
+// The removed placements are detached from their mother but are left in
+// the physical volume store, as they may be owned by an assembly.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02GeometryFlattener_h
+#define G02GeometryFlattener_h 1
+
+#include "globals.hh"
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+// ----------------------------------------------------------------------------
+
+/// Geometry flattening pass used in GDML read/write example
+
+class G02GeometryFlattener
+{
+  public:
+
+    G02GeometryFlattener();
+   ~G02GeometryFlattener();
+
+    // Flattens the tree below the world volume; returns the number of
+    // collapsed containers
+    //
+    G4int Flatten(G4VPhysicalVolume* world);
+
+    // Depth and volume counts before and after the last Flatten()
+    //
+    void PrintReport() const;
+
+  private:
+
+    struct Summary
+    {
+      G4int    fMaxDepth;         // Levels, the world one included
+      G4int    fLogicalVolumes;   // Distinct logical volumes
+      G4int    fPlacements;       // Distinct physical volumes
+      G4double fExpanded;         // Volumes of the expanded tree
+    };
+
+    static Summary Summarise(const G4VPhysicalVolume* world);
+
+    G4bool IsPassThrough(const G4VPhysicalVolume* container,
+                         const G4LogicalVolume* mother) const;
+    G4bool HasDaughtersInside(const G4VPhysicalVolume* container) const;
+    void Collapse(G4VPhysicalVolume* container, G4LogicalVolume* mother);
+
+  private:
+
+    Summary  fBefore;
+    Summary  fAfter;
+    G4int    fCollapsed;   // Container placements removed
+    G4int    fLifted;      // Placements moved one or more levels up
+    G4int    fRejected;    // Pass-through containers kept for their shape
+    G4double fTime;        // Wall time of the pass [s]
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
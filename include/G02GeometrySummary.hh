@@ -0,0 +1,165 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02GeometrySummary.hh
+/// \brief Definition of the G02GeometrySummary class
+//
+//
+//
+// Class G02GeometrySummary
+//
+// Plain-data summary of a geometry tree, independent of the stores: one
+// record per logical volume (solid type and parameters, material,
+// computed masses) and one per daughter placement (name, copy number,
+// transform in the mother). Records are keyed by structural paths of
+// placement names and copy numbers below the world ("/Det#0/Box#3"),
+// with the pointer suffixes of the names removed; a logical volume is
+// keyed by the path of its first placement in depth-first order. Two
+// summaries, e.g. of two versions of a GDML file, are compared record by
+// record. Summaries are written to and read from a line-oriented text
+// form, so that they can be built by other processes.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02GeometrySummary_h
+#define G02GeometrySummary_h 1
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "globals.hh"
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+// ----------------------------------------------------------------------------
+
+/// Structural summary and comparison of geometries used in GDML example
+
+class G02GeometrySummary
+{
+  public:
+
+    struct Volume
+    {
+      std::string fKey;
+      std::string fName;                 // Of the logical volume
+      std::string fSolidType;
+      std::vector<G4double> fParameters; // Or the bounding box, see below
+      std::string fMaterial;
+      G4double fDensity;
+      G4double fSelfMass;                // Without the daughters
+      G4double fMass;                    // With the daughters
+    };
+
+    struct Placement
+    {
+      std::string fKey;
+      std::string fMotherKey;
+      std::string fVolumeKey;            // Of the placed logical volume
+      std::string fKind;                 // placement, replica, parameterised
+      G4int fMultiplicity;
+      G4double fTransform[12];           // Translation, then rotation rows
+    };
+
+    // Differences between two summaries and the tolerances used to find
+    // them; lengths are in internal units, the mass tolerance is relative
+    //
+    struct Tolerances
+    {
+      Tolerances() : fLength(1.e-6), fRelative(1.e-9), fMass(1.e-6) {}
+      G4double fLength;                  // Solid parameters, translations
+      G4double fRelative;                // Rotations, densities
+      G4double fMass;
+    };
+
+  public:
+
+    G02GeometrySummary();
+   ~G02GeometrySummary();
+
+    // Summarises the tree below the world; masses are computed only if
+    // requested, which for Boolean solids means Monte Carlo estimates of
+    // their volumes, with the fixed seeds of G02MassReport::CubicVolume()
+    // so that the same geometry always gets the same masses
+    //
+    void Build(const G4VPhysicalVolume* world, G4bool computeMasses = true);
+    void Clear();
+
+    // Text form
+    //
+    void Write(std::ostream& out) const;
+    G4bool Read(std::istream& in);
+
+    // Prints the differences of the other summary to this one and
+    // returns their number
+    //
+    G4int Compare(const G02GeometrySummary& other, std::ostream& out,
+                  const Tolerances& tolerances = Tolerances()) const;
+
+    // Accessors
+    //
+    inline const std::vector<Volume>& GetVolumes() const { return fVolumes; }
+    inline const std::vector<Placement>& GetPlacements() const
+      { return fPlacements; }
+    inline G4bool HasMasses() const { return fHasMasses; }
+
+    // Name without the "0x..." suffix appended by the GDML writer
+    //
+    static std::string StripPointer(const std::string& name);
+
+  private:
+
+    // Masses of a logical volume; the content (daughters and volume they
+    // displace) gives the mass of the copies of a parameterisation
+    //
+    struct Mass
+    {
+      G4double fSelf;
+      G4double fTotal;
+      G4double fDaughters;
+      G4double fDisplaced;
+    };
+
+    void Visit(const G4LogicalVolume* lv, const std::string& key);
+    const Mass& ComputeMass(const G4LogicalVolume* lv);
+    void Describe(const G4VSolid* solid, Volume& volume) const;
+
+  private:
+
+    std::vector<Volume> fVolumes;        // In depth-first order
+    std::vector<Placement> fPlacements;
+    std::map<const G4LogicalVolume*, std::string> fKeys;
+    std::map<const G4LogicalVolume*, Mass> fMasses;
+    G4bool fComputeMasses;
+    G4bool fHasMasses;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
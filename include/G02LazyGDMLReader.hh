@@ -0,0 +1,81 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02LazyGDMLReader.hh
+/// \brief Definition of the G02LazyGDMLReader class
+//
+//
+//
+// Class G02LazyGDMLReader
+//
+// GDML reader which, when lazy reading is enabled, reads the tessellated
+// solids as G02LazySolid stand-ins: their facets are only recorded, and
+// the G4TessellatedSolid is built when the navigation first needs it. The
+// other solids, the structure and the materials are read as usual. The
+// reader is given to the G4GDMLParser of the detector construction.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02LazyGDMLReader_h
+#define G02LazyGDMLReader_h 1
+
+#include "globals.hh"
+#include "G4GDMLReadStructure.hh"
+
+class G02LazySolid;
+
+// ----------------------------------------------------------------------------
+
+/// Lazy GDML reader used in GDML read/write example
+
+class G02LazyGDMLReader : public G4GDMLReadStructure
+{
+  public:
+
+    G02LazyGDMLReader();
+   ~G02LazyGDMLReader();
+
+    inline void SetLazy(G4bool val) { fLazy = val; }
+    inline G4bool IsLazy() const { return fLazy; }
+
+    // Reads the <solids> section, the tessellated solids first
+    //
+    virtual void SolidsRead(const xercesc::DOMElement* const solidsElement);
+
+  private:
+
+    void LazyTessellatedRead(const xercesc::DOMElement* const element);
+    void FacetRead(const xercesc::DOMElement* const element,
+                   G4double lunit, G02LazySolid* solid);
+    G4double LengthUnit(const G4String& unit) const;
+
+  private:
+
+    G4bool fLazy;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
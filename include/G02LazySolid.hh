@@ -0,0 +1,146 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02LazySolid.hh
+/// \brief Definition of the G02LazySolid class
+//
+//
+//
+// Class G02LazySolid
+//
+// Stand-in for a tessellated solid read from GDML, built when the solid is
+// first needed by the navigation. The stand-in keeps only the facet
+// vertices, in a compact array, and their bounding box: the extent of the
+// solid, used by the voxelisation of the mother volume, does not need the
+// real solid. The first call of a navigation, visualisation or volume
+// method builds the G4TessellatedSolid (facets and their own voxels) and
+// frees the vertex array; all the calls are then forwarded to it. Solids
+// never reached by the tracks of a job are never built.
+//
+// The build is done once, under a lock shared by all the stand-ins, and
+// published with an atomic pointer, so that the first worker thread
+// reaching the solid builds it for all. The real solid is owned by the
+// stand-in and is not registered in the solid store.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02LazySolid_h
+#define G02LazySolid_h 1
+
+#include <atomic>
+#include <vector>
+
+#include "globals.hh"
+#include "G4VSolid.hh"
+#include "G4ThreeVector.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Tessellated solid built on first use, used in GDML read/write example
+
+class G02LazySolid : public G4VSolid
+{
+  public:
+
+    explicit G02LazySolid(const G4String& name);
+   ~G02LazySolid();
+
+    // Description of the solid, before its first use: facets of three or
+    // four vertices, in absolute coordinates
+    //
+    void AddTriangle(const G4ThreeVector& v1, const G4ThreeVector& v2,
+                     const G4ThreeVector& v3);
+    void AddQuadrangle(const G4ThreeVector& v1, const G4ThreeVector& v2,
+                       const G4ThreeVector& v3, const G4ThreeVector& v4);
+
+    // The real solid, built if needed
+    //
+    G4VSolid* GetSolid() const;
+    inline G4bool IsBuilt() const { return fSolid.load() != 0; }
+
+    // Number of triangles of the facets, the quadrangles counting two
+    //
+    inline G4int GetNumberOfTriangles() const { return fTriangles; }
+
+    // Numbers of stand-ins created and of real solids built in the job
+    //
+    static G4int GetNumberOfDeferred();
+    static G4int GetNumberOfBuilt();
+    static void PrintStatistics();
+
+    // G4VSolid interface; the extent is computed from the bounding box,
+    // everything else is forwarded to the real solid
+    //
+    virtual void BoundingLimits(G4ThreeVector& pMin, G4ThreeVector& pMax) const;
+    virtual G4bool CalculateExtent(const EAxis pAxis,
+                                   const G4VoxelLimits& pVoxelLimit,
+                                   const G4AffineTransform& pTransform,
+                                   G4double& pMin, G4double& pMax) const;
+
+    virtual EInside Inside(const G4ThreeVector& p) const;
+    virtual G4ThreeVector SurfaceNormal(const G4ThreeVector& p) const;
+    virtual G4double DistanceToIn(const G4ThreeVector& p,
+                                  const G4ThreeVector& v) const;
+    virtual G4double DistanceToIn(const G4ThreeVector& p) const;
+    virtual G4double DistanceToOut(const G4ThreeVector& p,
+                                   const G4ThreeVector& v,
+                                   const G4bool calcNorm = false,
+                                   G4bool* validNorm = 0,
+                                   G4ThreeVector* n = 0) const;
+    virtual G4double DistanceToOut(const G4ThreeVector& p) const;
+
+    virtual G4double GetCubicVolume();
+    virtual G4double GetSurfaceArea();
+    virtual G4ThreeVector GetPointOnSurface() const;
+    virtual G4String GetEntityType() const;
+    virtual G4VSolid* Clone() const;
+    virtual std::ostream& StreamInfo(std::ostream& os) const;
+
+    virtual void DescribeYourselfTo(G4VGraphicsScene& scene) const;
+    virtual G4Polyhedron* CreatePolyhedron() const;
+
+  private:
+
+    G02LazySolid(const G02LazySolid&);
+    G02LazySolid& operator=(const G02LazySolid&);
+
+    G4VSolid* Build() const;
+
+  private:
+
+    // Vertices of the facets, four per facet; the fourth one of a
+    // triangle repeats the third. Freed once the solid is built.
+    //
+    mutable std::vector<G4ThreeVector> fVertices;
+    G4ThreeVector fMin, fMax;
+    G4int fFacets;
+    G4int fTriangles;
+
+    mutable std::atomic<G4VSolid*> fSolid;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
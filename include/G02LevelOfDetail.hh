@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02LevelOfDetail.hh
+/// \brief Definition of the G02LevelOfDetail class
+//
+//
+//
+// Class G02LevelOfDetail
+//
+// Simplified proxies of the tessellated solids of a geometry, for the
+// scans and views that do not need their full detail. Build() decimates
+// every tessellated solid of the logical volumes (G02MeshSimplifier) once,
+// when the geometry is imported; Select() then gives the logical volumes
+// either their full solids or their proxies, and can be called between
+// runs. The lazy stand-ins (G02LazySolid) not built at import are only
+// simplified, and so built, when the proxies are first selected. A
+// proxy whose volume differs from the one of the full solid by more than
+// the maximum relative volume error is not kept.
+//
+// The proxies are registered in the solid store, and deleted with the
+// geometry: Clear() must be called when the geometry is released.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02LevelOfDetail_h
+#define G02LevelOfDetail_h 1
+
+#include <vector>
+
+#include "globals.hh"
+
+class G4VSolid;
+class G4LogicalVolume;
+
+// ----------------------------------------------------------------------------
+
+/// Level of detail of the tessellated solids used in GDML read/write example
+
+class G02LevelOfDetail
+{
+  public:
+
+    G02LevelOfDetail();
+   ~G02LevelOfDetail();
+
+    // Settings of the proxies built next; a target of 0 facets or a
+    // tolerance of 0 disables the criterion
+    //
+    inline void SetEnabled(G4bool val) { fEnabled = val; }
+    inline G4bool IsEnabled() const { return fEnabled; }
+    inline void SetTargetFacets(G4int n) { fTargetFacets = n; }
+    inline void SetTolerance(G4double val) { fTolerance = val; }
+    inline void SetMaxVolumeError(G4double val) { fMaxVolumeError = val; }
+
+    // Builds the proxies of the tessellated solids of the logical volume
+    // store, except the lazy stand-ins not built yet, and applies the
+    // current selection; returns the number built
+    //
+    G4int Build();
+
+    // Gives the logical volumes their proxies, or their full solids,
+    // building the deferred proxies; called by the master between runs
+    //
+    void Select(G4bool proxies);
+    inline G4bool IsProxySelected() const { return fProxySelected; }
+
+    // Gives the logical volumes the solids of the current selection. The
+    // solids of the logical volumes are per thread: the worker threads
+    // apply the selection of the master at the start of each run.
+    //
+    void Apply() const;
+
+    // Forgets the proxies, deleted with the geometry
+    //
+    void Clear();
+
+    void PrintReport() const;
+
+  private:
+
+    struct Entry
+    {
+      G4VSolid* fFull;
+      G4VSolid* fProxy;          // 0 if rejected
+      std::vector<G4LogicalVolume*> fVolumes;
+      G4int fFacetsFull;
+      G4int fFacetsProxy;
+      G4double fVolumeError;     // Relative
+      G4double fMaxError;        // Distance bound of the collapses
+      G4bool fDone;              // Simplification attempted
+    };
+
+    // Builds the proxy of the entry; false if none is kept
+    //
+    G4bool Simplify(Entry& entry) const;
+
+  private:
+
+    G4bool fEnabled;
+    G4bool fProxySelected;
+    G4int fTargetFacets;
+    G4double fTolerance;
+    G4double fMaxVolumeError;
+
+    std::vector<Entry> fEntries;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
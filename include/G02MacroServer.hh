@@ -0,0 +1,102 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02MacroServer.hh
+/// \brief Definition of the G02MacroServer class
+//
+//
+//
+// Class G02MacroServer
+//
+// UI session serving batches of commands received on a Unix domain
+// socket, so that jobs are run by a process which has already built the
+// kernel, the physics list and the geometry. Clients (see g02client) are
+// served one at a time; each connection is one job:
+//
+//  - the client sends the commands, one per line, as in a macro file
+//    (empty lines and "#" comments are skipped), and ends the batch by
+//    closing its side of the connection or with a line "."; a line
+//    "exit" ends the batch and stops the server after it;
+//  - the server executes the commands in order, stopping at the first
+//    one which fails, and streams back the output they produce as lines
+//    prefixed by their channel: "o " for G4cout, "e " for G4cerr and
+//    "s " for the status lines of the server;
+//  - the last line is "s done <executed> <status>", where status is 0
+//    or the G4UImanager code of the command which failed.
+//
+// Only the output of the master thread goes to the client; the worker
+// threads of a multi-threaded run write to the console of the server.
+// The socket is created with user-only permissions.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02MacroServer_h
+#define G02MacroServer_h 1
+
+#include <vector>
+
+#include "globals.hh"
+#include "G4UIsession.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Socket command server used in GDML read/write example
+
+class G02MacroServer : public G4UIsession
+{
+  public:
+
+    explicit G02MacroServer(const G4String& socketPath);
+   ~G02MacroServer();
+
+    // Serves the clients until a job asks the server to stop
+    //
+    virtual G4UIsession* SessionStart();
+    virtual void PauseSessionStart(const G4String& msg);
+
+    // Output of the commands, sent to the client of the current job
+    //
+    virtual G4int ReceiveG4cout(const G4String& coutString);
+    virtual G4int ReceiveG4cerr(const G4String& cerrString);
+
+  private:
+
+    G4bool Listen();
+    void Close();
+    G4bool ReadBatch(std::vector<G4String>& commands, G4bool& stop);
+    void RunBatch(const std::vector<G4String>& commands);
+    void Send(char channel, const G4String& text);
+
+  private:
+
+    G4String fSocketPath;
+    G4int fListener;    // Listening socket, -1 if none
+    G4int fClient;      // Connection of the current job, -1 if none
+    G4int fJobs;        // Jobs served
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
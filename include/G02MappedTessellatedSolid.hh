@@ -0,0 +1,137 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02MappedTessellatedSolid.hh
+/// \brief Definition of the G02MappedTessellatedSolid class
+//
+//
+//
+// Class G02MappedTessellatedSolid
+//
+// Closed triangle mesh navigated directly on the read-only arrays of a
+// G02MeshFile mapping: the vertices, triangles, normals and the BVH are
+// shared by all the processes mapping the file, and the solid itself
+// only holds a pointer to them. The solid replaces a G4TessellatedSolid
+// of the same name, whose facets and voxels are then no longer allocated
+// in each process.
+//
+// Distances along a direction are given by the nearest crossing of a
+// triangle facing the direction (entering or exiting), found through the
+// BVH; safeties are the exact distances to the nearest triangle. Inside()
+// is decided by the parity of the crossings of three rays (majority), and
+// points within half the tolerance of a triangle are on the surface. The
+// triangles must be oriented, their normals pointing outwards.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02MappedTessellatedSolid_h
+#define G02MappedTessellatedSolid_h 1
+
+#include <cstdint>
+
+#include "globals.hh"
+#include "G4VSolid.hh"
+#include "G4ThreeVector.hh"
+#include "G02MeshFile.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Tessellated solid on a memory-mapped mesh, used in GDML read/write example
+
+class G02MappedTessellatedSolid : public G4VSolid
+{
+  public:
+
+    G02MappedTessellatedSolid(const G4String& name,
+                              const G02MeshFile::Mesh* mesh);
+   ~G02MappedTessellatedSolid();
+
+    inline const G02MeshFile::Mesh* GetMesh() const { return fMesh; }
+
+    // G4VSolid interface
+    //
+    virtual void BoundingLimits(G4ThreeVector& pMin, G4ThreeVector& pMax) const;
+    virtual G4bool CalculateExtent(const EAxis pAxis,
+                                   const G4VoxelLimits& pVoxelLimit,
+                                   const G4AffineTransform& pTransform,
+                                   G4double& pMin, G4double& pMax) const;
+
+    virtual EInside Inside(const G4ThreeVector& p) const;
+    virtual G4ThreeVector SurfaceNormal(const G4ThreeVector& p) const;
+    virtual G4double DistanceToIn(const G4ThreeVector& p,
+                                  const G4ThreeVector& v) const;
+    virtual G4double DistanceToIn(const G4ThreeVector& p) const;
+    virtual G4double DistanceToOut(const G4ThreeVector& p,
+                                   const G4ThreeVector& v,
+                                   const G4bool calcNorm = false,
+                                   G4bool* validNorm = 0,
+                                   G4ThreeVector* n = 0) const;
+    virtual G4double DistanceToOut(const G4ThreeVector& p) const;
+
+    virtual G4double GetCubicVolume();
+    virtual G4double GetSurfaceArea();
+    virtual G4ThreeVector GetPointOnSurface() const;
+    virtual G4String GetEntityType() const;
+    virtual G4VSolid* Clone() const;
+    virtual std::ostream& StreamInfo(std::ostream& os) const;
+
+    virtual void DescribeYourselfTo(G4VGraphicsScene& scene) const;
+    virtual G4Polyhedron* CreatePolyhedron() const;
+
+  private:
+
+    G4ThreeVector Vertex(std::uint32_t index) const;
+    G4ThreeVector Normal(std::uint32_t triangle) const;
+
+    // Distance along v to the nearest crossing of a triangle whose normal
+    // has the sign "sense" along v (-1 entering, +1 exiting), not further
+    // back than half the tolerance; false if there is none
+    //
+    G4bool Intersect(const G4ThreeVector& p, const G4ThreeVector& v,
+                     G4int sense, G4double& distance,
+                     std::uint32_t& triangle) const;
+
+    // Number of triangles crossed by the half-line from p along v
+    //
+    G4int CountCrossings(const G4ThreeVector& p, const G4ThreeVector& v) const;
+
+    // Distance to the nearest triangle
+    //
+    G4double Nearest(const G4ThreeVector& p, std::uint32_t& triangle) const;
+
+    G4bool RayTriangle(const G4ThreeVector& p, const G4ThreeVector& v,
+                       std::uint32_t triangle, G4double& t) const;
+    G4double PointTriangle(const G4ThreeVector& p,
+                           std::uint32_t triangle) const;
+
+  private:
+
+    const G02MeshFile::Mesh* fMesh;
+    G4double fHalfTolerance;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
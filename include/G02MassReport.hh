@@ -0,0 +1,176 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02MassReport.hh
+/// \brief Definition of the G02MassReport class
+//
+//
+//
+// Class G02MassReport
+//
+// Cubic volume and mass of every logical volume of a geometry. Volumes
+// are exact where possible: analytic for the CSG solids, by the
+// divergence theorem for the tessellated ones, through the displaced,
+// reflected and scaled solids; the other solids (Boolean ones, ...) are
+// estimated by Monte Carlo sampling of their bounding boxes. The solids
+// are evaluated by a pool of threads, the Monte Carlo sampling of a solid
+// being split in chunks; results are cached by solid fingerprint, so that
+// identical solids, in the same or in later geometries, are evaluated
+// once. The masses are summed as in G4LogicalVolume::GetMass().
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02MassReport_h
+#define G02MassReport_h 1
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+// ----------------------------------------------------------------------------
+
+/// Parallel volume and mass report used in GDML read/write example
+
+class G02MassReport
+{
+  public:
+
+    G02MassReport();
+   ~G02MassReport();
+
+    // Prints the report of the geometry below the world and, if a file
+    // name is given, writes it in CSV format; returns false if the file
+    // cannot be written
+    //
+    G4bool Run(const G4VPhysicalVolume* world,
+               const G4String& fileName = "");
+
+    // Settings: Monte Carlo points per solid, and threads (0 for the
+    // number of cores)
+    //
+    inline void SetPoints(G4long n) { fPoints = n; }
+    inline void SetThreads(G4int n) { fThreads = n; }
+    inline void ClearCache() { fCache.clear(); }
+
+    // Mass with the daughters of the logical volume of the last report
+    // with this name, negative if there is none
+    //
+    G4double GetMass(const G4String& name) const;
+
+    // Content of the solid, empty if not supported (no caching)
+    //
+    static std::string Fingerprint(const G4VSolid* solid);
+
+    // Cubic volume of one solid, computed as in the report but in the
+    // calling thread. The Monte Carlo sampling is seeded by the
+    // fingerprint, so that a solid gets the same estimate in any process,
+    // unlike G4VSolid::GetCubicVolume() for the Boolean solids
+    //
+    static G4double CubicVolume(const G4VSolid* solid,
+                                G4long points = 1000000);
+
+  private:
+
+    enum Method { kAnalytic, kTessellated, kMonteCarlo };
+
+    struct Result
+    {
+      G4double fVolume;
+      G4double fError;     // Standard deviation of the Monte Carlo estimates
+      G4int fMethod;
+      G4long fPoints;
+    };
+
+    // One solid to evaluate, with the chunks of its Monte Carlo sampling
+    //
+    struct Item
+    {
+      const G4VSolid* fSolid;
+      std::string fKey;
+      Result fResult;
+      G4bool fDone;
+      G4ThreeVector fMin, fMax;
+      std::vector<G4double> fHits;
+    };
+
+    struct Task
+    {
+      std::size_t fItem;
+      G4int fChunk;
+    };
+
+    struct Row
+    {
+      const G4LogicalVolume* fVolume;
+      G4double fCubicVolume;
+      G4double fError;
+      G4int fMethod;
+      G4double fSelfMass;
+      G4double fMass;
+      G4double fDaughters;   // Mass of the daughters
+      G4double fDisplaced;   // Cubic volume of the daughters
+      G4bool fMassDone;
+    };
+
+    static const G4VSolid* Unwrap(const G4VSolid* solid, G4double& scale);
+    static G4bool IsAnalytic(const G4VSolid* solid);
+    static G4double TessellatedVolume(const G4VSolid* solid);
+    static G4double Sample(const G4VSolid* solid, std::uint64_t seed,
+                           const G4ThreeVector& min, const G4ThreeVector& max,
+                           G4int chunk, G4long points);
+
+    void Execute(Task task);
+    G4double ComputeMass(const G4LogicalVolume* lv, G4double& selfMass);
+    void Collect(const G4LogicalVolume* lv);
+
+  private:
+
+    std::map<std::string, Result> fCache;
+    G4long fPoints;
+    G4int fThreads;
+
+    // State of one report
+    //
+    std::vector<Item> fItems;
+    std::map<const G4VSolid*, std::size_t> fBases;   // Item of each solid
+
+    // Item and volume scale of the solids of the logical volumes
+    //
+    std::map<const G4VSolid*, std::pair<std::size_t, G4double> > fSolids;
+    std::map<const G4LogicalVolume*, std::size_t> fRows;
+    std::vector<Row> fRowList;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
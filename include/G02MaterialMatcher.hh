@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02MaterialMatcher.hh
+/// \brief Definition of the G02MaterialMatcher class
+//
+//
+//
+// Class G02MaterialMatcher
+//
+// Materials cannot be deleted during the job: every GDML reading adds its
+// materials to the material table, even when an identical material was
+// defined by a previous file. Each new material gets its own production
+// cuts couple at the next run, and the physics tables are computed for it
+// again. The matcher replaces, in the logical volumes of a geometry, every
+// material by the first identical one of the material table, i.e. the one
+// of the previous geometry, so that its couple and physics tables are
+// reused. Only the materials actually changed by a new file get new
+// tables.
+//
+// Two materials are identical when they have the same name, state,
+// density, temperature, pressure and mean excitation energy, and the same
+// elements (Z, N, A) with the same mass fractions. Materials with optical
+// properties, a base material or a chemical formula used by the physics
+// are never replaced.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02MaterialMatcher_h
+#define G02MaterialMatcher_h 1
+
+#include <map>
+
+#include "globals.hh"
+
+class G4Material;
+class G4Element;
+class G4VPhysicalVolume;
+
+// ----------------------------------------------------------------------------
+
+/// Reuse of the identical materials used in GDML read/write example
+
+class G02MaterialMatcher
+{
+  public:
+
+    G02MaterialMatcher();
+   ~G02MaterialMatcher();
+
+    // Replaces the materials of the logical volumes below the world
+    // volume; returns the number of logical volumes changed
+    //
+    G4int Match(G4VPhysicalVolume* world);
+
+    // Numbers of distinct materials used, and reused, by the last Match()
+    //
+    void PrintReport() const;
+
+    static G4bool Identical(const G4Material* a, const G4Material* b);
+
+  private:
+
+    static G4bool Identical(const G4Element* a, const G4Element* b);
+    static G4bool Close(G4double a, G4double b);
+
+    const G4Material* Earliest(const G4Material* material);
+
+  private:
+
+    std::map<const G4Material*, const G4Material*> fMatches;
+    G4int fMaterials;     // Distinct materials used by the geometry
+    G4int fReused;        // Of them, replaced by an earlier material
+    G4int fVolumes;       // Logical volumes whose material was replaced
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
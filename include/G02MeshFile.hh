@@ -0,0 +1,172 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02MeshFile.hh
+/// \brief Definition of the G02MeshFile class
+//
+//
+//
+// Class G02MeshFile
+//
+// Flat, relocatable file of triangle meshes, mapped read-only in memory
+// by the jobs using it, so that the processes of a node running on the
+// same geometry share its pages. One file holds the tessellated solids of
+// a geometry, by name, each with its vertex pool, its triangles, their
+// normals and a bounding volume hierarchy (BVH) built at export: nothing
+// is computed, copied or allocated per process when a mesh is used by a
+// G02MappedTessellatedSolid.
+//
+// File layout (native byte order, every array 8-byte aligned, all the
+// offsets from the start of the file):
+//
+//   Header        char[8] "G02MESH1", uint32 version, uint32 nMeshes,
+//                 uint64 meshTableOffset, uint64 fileSize
+//   MeshRecord[nMeshes]
+//   per mesh:     char name[], double vertices[3*nVertices] (mm),
+//                 uint32 triangles[3*nTriangles] (vertex indices, in the
+//                 order of the BVH leaves), double normals[3*nTriangles],
+//                 Node nodes[nNodes]
+//
+// The BVH nodes are in depth-first order: the first child of an inner
+// node follows it, the index of the second one is stored. A leaf holds a
+// contiguous range of triangles. Files with a BVH deeper than kMaxDepth
+// are rejected, the traversals using stacks of fixed size.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02MeshFile_h
+#define G02MeshFile_h 1
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4VSolid;
+class G4TessellatedSolid;
+
+// ----------------------------------------------------------------------------
+
+/// Memory-mapped mesh file used in GDML read/write example
+
+class G02MeshFile
+{
+  public:
+
+    struct Header
+    {
+      char          fMagic[8];
+      std::uint32_t fVersion;
+      std::uint32_t fMeshes;
+      std::uint64_t fMeshTableOffset;
+      std::uint64_t fFileSize;
+    };
+
+    struct MeshRecord
+    {
+      std::uint64_t fNameOffset;
+      std::uint32_t fNameLength;
+      std::uint32_t fVertices;
+      std::uint32_t fTriangles;
+      std::uint32_t fNodes;
+      std::uint64_t fVerticesOffset;
+      std::uint64_t fTrianglesOffset;
+      std::uint64_t fNormalsOffset;
+      std::uint64_t fNodesOffset;
+      double        fMin[3];
+      double        fMax[3];
+      double        fCubicVolume;
+      double        fSurfaceArea;
+    };
+
+    struct Node
+    {
+      double        fMin[3];
+      double        fMax[3];
+      std::uint32_t fFirst;   // Leaf: first triangle; inner: second child
+      std::uint32_t fCount;   // Leaf: number of triangles; inner: 0
+    };
+
+    // Bound on the depth of the BVH nodes, the root being at depth 0
+    //
+    static const G4int kMaxDepth = 63;
+
+    // View of one mesh in the mapped file
+    //
+    struct Mesh
+    {
+      G4String             fName;
+      const MeshRecord*    fRecord;
+      const double*        fVertices;
+      const std::uint32_t* fTriangles;
+      const double*        fNormals;
+      const Node*          fNodes;
+    };
+
+    // Writes the meshes of the solids; returns false on failure
+    //
+    static G4bool Write(const G4String& fileName,
+                       const std::vector<const G4TessellatedSolid*>& solids);
+
+    // Maps a file, or returns the mapping done before; 0 on failure. The
+    // mappings are kept until the end of the job.
+    //
+    static const G02MeshFile* Map(const G4String& fileName);
+
+    // The mesh of a solid name, 0 if none
+    //
+    const Mesh* Find(const G4String& name) const;
+
+    // True if the solid, tessellated or lazy stand-in, has the number of
+    // triangles and the bounding box of the mesh
+    //
+    static G4bool Matches(const Mesh& mesh, const G4VSolid* solid);
+
+    inline const G4String& GetFileName() const { return fFileName; }
+    inline std::size_t GetNumberOfMeshes() const { return fMeshes.size(); }
+    inline std::size_t GetSize() const { return fSize; }
+
+  private:
+
+    G02MeshFile(const G4String& fileName);
+   ~G02MeshFile();
+
+    G4bool Open();
+    G4bool Validate();
+
+  private:
+
+    G4String fFileName;
+    const char* fData;
+    std::size_t fSize;
+    G4bool fMapped;                  // false: read in memory (no mmap)
+    std::map<G4String, Mesh> fMeshes;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,161 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02MeshSimplifier.hh
+/// \brief Definition of the G02MeshSimplifier class
+//
+//
+//
+// Class G02MeshSimplifier
+//
+// Decimation of a closed tessellated solid by quadric error edge
+// collapses (Garland and Heckbert). Each vertex carries the sum of the
+// squared-distance quadrics of the planes of its original facets; the
+// edges are collapsed in order of increasing error of their best point,
+// the point minimising the summed quadric of their two vertices. A
+// collapse is refused when it would make the surface non-manifold (link
+// condition) or turn a facet over.
+//
+// The simplification stops at the target number of facets, or before the
+// first collapse with an error above the tolerance, whichever comes first.
+// The error of a collapse is the square root of the sum of the squared
+// distances of the new point to the original planes: it bounds from above
+// the distance of the point to each of these planes.
+//
+// The quadrangular facets are split in two triangles. Solids whose surface
+// is not closed and 2-manifold (each edge shared by exactly two facets)
+// are not simplified.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02MeshSimplifier_h
+#define G02MeshSimplifier_h 1
+
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4TessellatedSolid;
+
+// ----------------------------------------------------------------------------
+
+/// Quadric error mesh simplification used in GDML read/write example
+
+class G02MeshSimplifier
+{
+  public:
+
+    G02MeshSimplifier();
+   ~G02MeshSimplifier();
+
+    // Stopping criteria; 0 disables a criterion
+    //
+    inline void SetTargetFacets(G4int n) { fTargetFacets = n; }
+    inline void SetTolerance(G4double val) { fTolerance = val; }
+
+    // Returns a new closed tessellated solid of the given name, or 0 when
+    // the solid cannot be simplified or no facet could be removed
+    //
+    G4TessellatedSolid* Simplify(const G4TessellatedSolid* solid,
+                                 const G4String& name);
+
+    // Results of the last Simplify(); the facets are counted in triangles,
+    // after the split of the quadrangles
+    //
+    inline G4int GetFacetsBefore() const { return fFacetsBefore; }
+    inline G4int GetFacetsAfter() const { return fFacetsAfter; }
+    inline G4double GetVolumeBefore() const { return fVolumeBefore; }
+    inline G4double GetVolumeAfter() const { return fVolumeAfter; }
+    inline G4double GetMaxError() const { return fMaxError; }
+
+  private:
+
+    // Symmetric 4x4 matrix: xx xy xz xw yy yz yw zz zw ww
+    //
+    struct Quadric
+    {
+      G4double fQ[10];
+    };
+
+    struct Vertex
+    {
+      G4ThreeVector fPosition;
+      Quadric fQuadric;
+      std::vector<G4int> fFaces;
+      G4int fVersion;
+      G4bool fAlive;
+    };
+
+    struct Face
+    {
+      G4int fV[3];
+      G4bool fAlive;
+    };
+
+    struct Candidate
+    {
+      G4double fCost;
+      G4int fU, fV;
+      G4int fVersionU, fVersionV;
+      G4ThreeVector fPosition;
+
+      // Ordering of a min-heap on the cost
+      //
+      G4bool operator<(const Candidate& other) const
+        { return fCost > other.fCost; }
+    };
+
+    G4bool Load(const G4TessellatedSolid* solid);
+    G4bool IsClosedManifold() const;
+    void Decimate();
+    Candidate Evaluate(G4int u, G4int v) const;
+    G4bool CanCollapse(G4int u, G4int v, const G4ThreeVector& position) const;
+    void Collapse(G4int u, G4int v, const G4ThreeVector& position);
+    void Neighbours(G4int u, std::vector<G4int>& neighbours) const;
+    G4double Volume() const;
+
+    static void AddPlane(Quadric& q, const G4ThreeVector& normal, G4double d);
+    static G4double Error(const Quadric& q, const G4ThreeVector& p);
+
+  private:
+
+    G4int fTargetFacets;
+    G4double fTolerance;
+
+    std::vector<Vertex> fVertices;
+    std::vector<Face> fFaces;
+    G4int fAliveFaces;
+
+    G4int fFacetsBefore;
+    G4int fFacetsAfter;
+    G4double fVolumeBefore;
+    G4double fVolumeAfter;
+    G4double fMaxError;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
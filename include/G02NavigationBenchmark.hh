@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02NavigationBenchmark.hh
+/// \brief Definition of the G02NavigationBenchmark class
+//
+//
+//
+// Class G02NavigationBenchmark
+//
+// Reproducible navigation benchmark on a constructed geometry. A set of
+// straight rays (random origin inside the world extent, isotropic
+// direction) is generated from a given seed with a portable generator, so
+// that the same rays are obtained on every platform and for every commit.
+// Each ray is then walked through the geometry with a dedicated navigator,
+// timing separately the initial LocateGlobalPointAndSetup() calls, the
+// ComputeStep() calls and the relative re-locations done at each boundary.
+// The per-call timer overhead is measured and subtracted.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02NavigationBenchmark_h
+#define G02NavigationBenchmark_h 1
+
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4VPhysicalVolume;
+class G4Navigator;
+
+// ----------------------------------------------------------------------------
+
+/// Geometry navigation benchmark used in GDML read/write example
+
+class G02NavigationBenchmark
+{
+  public:
+
+    struct Ray
+    {
+      G4ThreeVector fPosition;
+      G4ThreeVector fDirection;
+    };
+
+    struct Result
+    {
+      Result();
+
+      G4long   fLocateCalls;     // Initial locations, one per ray
+      G4double fLocateTime;      // Seconds
+      G4long   fStepCalls;       // ComputeStep() calls
+      G4double fStepTime;
+      G4long   fRelocateCalls;   // Relative locations after each step
+      G4double fRelocateTime;
+      G4double fPathLength;      // Sum of the step lengths, a checksum
+      G4long   fTruncatedRays;   // Rays stopped at the step limit
+    };
+
+  public:
+
+    G02NavigationBenchmark(G4VPhysicalVolume* world);
+   ~G02NavigationBenchmark();
+
+    // Generates nRays rays from the seed
+    //
+    void GenerateRays(G4int nRays, G4long seed);
+    inline const std::vector<Ray>& GetRays() const { return fRays; }
+
+    // Walks all the rays once. The geometry must be closed
+    //
+    Result Run();
+
+    inline void SetMaxStepsPerRay(G4int val) { fMaxSteps = val; }
+    inline G4double GetTimerOverhead() const { return fTimerOverhead; }
+
+  private:
+
+    G4double MeasureTimerOverhead() const;
+
+  private:
+
+    G4VPhysicalVolume* fWorld;
+    G4Navigator* fNavigator;
+    std::vector<Ray> fRays;
+    G4int fMaxSteps;
+    G4double fTimerOverhead;   // Seconds per timed call
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
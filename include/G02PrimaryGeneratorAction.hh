@@ -30,7 +30,14 @@
 //
 // Class G02PrimaryGeneratorAction
 //
-// Simple primary-generator action class.
+// Simple primary-generator action class. By default one geantino is fired
+// per event with the particle gun. In the scan modes, selected with
+// /mygen/mode, many geantinos are injected per event, one per ray: rays
+// on a grid, isotropic rays from a point, rays from a point at the centres
+// of an eta/phi grid, or rays read from a file. The
+// rays of an event are filled in bulk in a pre-allocated buffer; ray
+// number eventID*K+k is the k-th primary of the event, K being the number
+// of rays per event, so that scans are reproducible in any threading mode.
 //
 // ----------------------------------------------------------------------------
 
@@ -42,6 +49,11 @@
 #include "G4Event.hh"
 
 #include "G4VUserPrimaryGeneratorAction.hh"
+#include "G02RayBuffer.hh"
+
+#include <memory>
+
+class G02PrimaryGeneratorMessenger;
 
 // ----------------------------------------------------------------------------
 
@@ -60,10 +72,61 @@ class G02PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     //
     virtual void GeneratePrimaries(G4Event* anEvent);
 
+    // Scan modes
+    //
+    enum ScanMode { kGun, kGrid, kSphere, kEtaPhi, kFile };
+
+    void SetScanMode( const G4String& mode );
+    inline ScanMode GetScanMode() const { return fScanMode; }
+    inline void SetRaysPerEvent( G4int val ) { fRaysPerEvent = val; }
+    inline void SetPosition( const G4ThreeVector& val ) { fPosition = val; }
+    inline void SetDirection( const G4ThreeVector& val )
+      { fDirection = val.unit(); }
+    inline void SetGridPoints( G4int nx, G4int ny ) { fGridNx = nx; fGridNy = ny; }
+    inline void SetGridHalfWidth( G4double val ) { fGridHalfWidth = val; }
+    inline void SetSphereRays( G4long val ) { fSphereRays = val; }
+    inline void SetEtaPhiPoints( G4int nEta, G4int nPhi )
+      { fEtaBins = nEta; fPhiBins = nPhi; }
+    inline void SetEtaRange( G4double etaMin, G4double etaMax )
+      { fEtaMin = etaMin; fEtaMax = etaMax; }
+    inline void SetSeed( G4long val ) { fSeed = val; }
+    void SetRayFile( const G4String& fileName );
+
+    // Number of rays of the scan, and per event (1 in gun mode)
+    //
+    G4long GetNumberOfRays() const;
+    inline G4int GetRaysPerEvent() const
+      { return fScanMode == kGun ? 1 : fRaysPerEvent; }
+
+  private:
+
+    // Fills the buffer with the n rays starting at ray number first
+    //
+    void FillGrid( G4long first, G4int n );
+    void FillSphere( G4long first, G4int n );
+    void FillEtaPhi( G4long first, G4int n );
+    void FillFromFile( G4long first, G4int n );
+
   private:
 
     G4ParticleGun* fParticleGun;
     G4ParticleTable * fParticleTable;
+    G02PrimaryGeneratorMessenger* fMessenger;
+
+    ScanMode fScanMode;
+    G4int fRaysPerEvent;
+    G4ThreeVector fPosition;
+    G4ThreeVector fDirection;
+    G4int fGridNx, fGridNy;
+    G4double fGridHalfWidth;
+    G4long fSphereRays;
+    G4int fEtaBins, fPhiBins;
+    G4double fEtaMin, fEtaMax;
+    G4long fSeed;
+    G4bool fWarnedEndOfScan;
+
+    G02RayBuffer fBuffer;
+    std::shared_ptr<const G02RayBuffer> fRayFile;  // rays read from file
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02PrimaryGeneratorMessenger.hh
+/// \brief Definition of the G02PrimaryGeneratorMessenger class
+//
+//
+//
+// Class G02PrimaryGeneratorMessenger
+//
+// Messenger defining the /mygen/ commands selecting and configuring the
+// scan modes of G02PrimaryGeneratorAction.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02PrimaryGeneratorMessenger_h
+#define G02PrimaryGeneratorMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G02PrimaryGeneratorAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWith3Vector;
+class G4UIcmdWith3VectorAndUnit;
+
+// ----------------------------------------------------------------------------
+
+/// Primary generator messenger class used in GDML read/write example
+
+class G02PrimaryGeneratorMessenger: public G4UImessenger
+{
+
+  public:
+
+    G02PrimaryGeneratorMessenger( G02PrimaryGeneratorAction* );
+   ~G02PrimaryGeneratorMessenger();
+
+    virtual void SetNewValue( G4UIcommand*, G4String );
+
+  private:
+
+    G02PrimaryGeneratorAction*    fTheGenerator;
+    G4UIdirectory*             fTheGeneratorDir;
+    G4UIcmdWithAString*        fTheModeCommand;
+    G4UIcmdWithAnInteger*      fTheRaysPerEventCommand;
+    G4UIcmdWith3VectorAndUnit* fThePositionCommand;
+    G4UIcmdWith3Vector*        fTheDirectionCommand;
+    G4UIcommand*               fTheGridPointsCommand;
+    G4UIcmdWithADoubleAndUnit* fTheGridHalfWidthCommand;
+    G4UIcmdWithAnInteger*      fTheSphereRaysCommand;
+    G4UIcommand*               fTheEtaPhiPointsCommand;
+    G4UIcommand*               fTheEtaRangeCommand;
+    G4UIcmdWithAnInteger*      fTheSeedCommand;
+    G4UIcmdWithAString*        fTheRayFileCommand;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
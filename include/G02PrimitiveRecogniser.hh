@@ -0,0 +1,159 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02PrimitiveRecogniser.hh
+/// \brief Definition of the G02PrimitiveRecogniser class
+//
+//
+//
+// Class G02PrimitiveRecogniser
+//
+// Recognition of the tessellated solids, e.g. exported from CAD systems,
+// that are the tessellation of a primitive: box, full sphere (orb or
+// spherical shell), full tube or truncated cone, in any position and
+// orientation. Such a solid is replaced by the primitive, displaced when
+// needed (G4DisplacedSolid); the primitive navigates without visiting
+// the facets.
+//
+// The primitive frame is found from the facets: the normals of a box take
+// six orthogonal directions; the lines along the normals of a sphere meet
+// at its centre; a tube or cone has two planar caps of opposite normals
+// and the lines along the normals of its other facets meet its axis. A fit
+// is accepted when every vertex, and the centre of every facet, is within
+// the tolerance of the primitive surface, with the facets oriented as
+// its surface, and when the volume of the solid differs from the one of
+// the primitive by less than its surface area times the tolerance, which
+// rejects partial primitives.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02PrimitiveRecogniser_h
+#define G02PrimitiveRecogniser_h 1
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4VSolid;
+class G4TessellatedSolid;
+
+// ----------------------------------------------------------------------------
+
+/// Recognition of the tessellated primitives used in GDML read/write example
+
+class G02PrimitiveRecogniser
+{
+  public:
+
+    G02PrimitiveRecogniser();
+   ~G02PrimitiveRecogniser();
+
+    inline void SetEnabled(G4bool val) { fEnabled = val; }
+    inline G4bool IsEnabled() const { return fEnabled; }
+    inline void SetTolerance(G4double val) { fTolerance = val; }
+
+    // Primitives of the tessellated solids of the logical volume store,
+    // keyed by the solid they replace; returns the number of solids
+    // recognised. The lazy stand-ins are examined only if already built:
+    // the others are skipped, to keep their reading deferred.
+    //
+    G4int Run(std::map<G4VSolid*, G4VSolid*>& replacements);
+
+    // The primitive, displaced if needed, equivalent to a closed
+    // tessellated solid within the tolerance, or 0
+    //
+    G4VSolid* Recognise(const G4TessellatedSolid* solid, const G4String& name);
+
+    void PrintReport() const;
+
+  private:
+
+    struct Triangle
+    {
+      G4int fV[3];
+      G4ThreeVector fNormal;
+      G4ThreeVector fCentre;
+      G4double fArea;
+    };
+
+    struct Cluster
+    {
+      G4ThreeVector fNormal;
+      G4double fArea;
+      std::vector<G4int> fTriangles;
+    };
+
+    typedef std::map<std::tuple<long,long,long>, Cluster> ClusterMap;
+
+    G4bool Load(const G4TessellatedSolid* solid);
+    G4VSolid* FitBox(const G4String& name);
+    G4VSolid* FitSphere(const G4String& name);
+    G4VSolid* FitTubeOrCone(const G4String& name);
+    G4VSolid* FitTubeOrCone(const G4String& name, const Cluster& top,
+                            const Cluster& bottom);
+    G4bool VolumeMatches(G4double volume, G4double area) const;
+    // The primitive, displaced when its axes (columns of its rotation)
+    // or centre are not the ones of the solid
+    //
+    G4VSolid* Place(G4VSolid* primitive, const G4String& name,
+                    const G4ThreeVector& axisX, const G4ThreeVector& axisY,
+                    const G4ThreeVector& axisZ, const G4ThreeVector& centre);
+
+    // Groups of values closer than the tolerance; false if a group is
+    // wider than twice the tolerance
+    //
+    G4bool Group(std::vector<G4double> values,
+                 std::vector<G4double>& means) const;
+
+  private:
+
+    G4bool fEnabled;
+    G4double fTolerance;
+
+    // Mesh of the solid examined
+    //
+    std::vector<G4ThreeVector> fVertices;
+    std::vector<Triangle> fTriangles;
+    ClusterMap fClusters;        // Facets by quantised normal
+    G4double fVolume;
+    G4double fArea;
+    G4double fSize;              // Bounding box diagonal
+
+    // Report
+    //
+    G4int fExamined;
+    G4int fDeferred;             // Lazy stand-ins skipped
+    G4int fFacetsRemoved;
+    std::map<G4String, G4int> fReplacedByType;
+    std::vector<std::pair<G4String, G4String> > fReplaced;
+    G4String fLastType;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02RayBuffer.hh
+/// \brief Definition of the G02RayBuffer class
+//
+//
+//
+// Class G02RayBuffer
+//
+// Structure-of-arrays storage of ray origins and unit directions, used by
+// the scan modes of G02PrimaryGeneratorAction. The arrays are allocated
+// once and refilled in bulk for each event.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02RayBuffer_h
+#define G02RayBuffer_h 1
+
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Ray buffer used in GDML read/write example
+
+class G02RayBuffer
+{
+  public:
+
+    G02RayBuffer() {}
+
+    inline void Resize(std::size_t n);
+    inline std::size_t Size() const { return fX.size(); }
+
+    inline void Set(std::size_t i, const G4ThreeVector& position,
+                    const G4ThreeVector& direction);
+    inline G4ThreeVector GetPosition(std::size_t i) const
+      { return G4ThreeVector(fX[i], fY[i], fZ[i]); }
+    inline G4ThreeVector GetDirection(std::size_t i) const
+      { return G4ThreeVector(fDx[i], fDy[i], fDz[i]); }
+
+    // Direct access to the arrays, for the bulk fills
+    //
+    inline G4double* X()  { return fX.data(); }
+    inline G4double* Y()  { return fY.data(); }
+    inline G4double* Z()  { return fZ.data(); }
+    inline G4double* Dx() { return fDx.data(); }
+    inline G4double* Dy() { return fDy.data(); }
+    inline G4double* Dz() { return fDz.data(); }
+
+  private:
+
+    std::vector<G4double> fX, fY, fZ;
+    std::vector<G4double> fDx, fDy, fDz;
+};
+
+// ----------------------------------------------------------------------------
+
+inline void G02RayBuffer::Resize(std::size_t n)
+{
+  fX.resize(n); fY.resize(n); fZ.resize(n);
+  fDx.resize(n); fDy.resize(n); fDz.resize(n);
+}
+
+inline void G02RayBuffer::Set(std::size_t i, const G4ThreeVector& position,
+                              const G4ThreeVector& direction)
+{
+  fX[i] = position.x(); fY[i] = position.y(); fZ[i] = position.z();
+  fDx[i] = direction.x(); fDy[i] = direction.y(); fDz[i] = direction.z();
+}
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02ReflectionOptimiser.hh
+/// \brief Definition of the G02ReflectionOptimiser class
+//
+//
+//
+// Class G02ReflectionOptimiser
+//
+// Optional pass run on the geometry tree after its construction or GDML
+// reading, removing the cost of the reflections. G4ReflectionFactory
+// places a reflected logical volume, whose solid is a G4ReflectedSolid of
+// the original one, and reflects in the same way the whole tree below it:
+// every navigation call on these solids goes through the wrapper.
+//
+// When the original solid S is itself symmetric under a reflection M about
+// one of its planes (boxes, tubes and cones with a symmetric phi segment,
+// ...) the reflected solid D(S) is D(M(S)), where D*M is a proper
+// rotation and translation. The wrapper is then dropped: the logical
+// volume is replaced by a copy with the solid S (as the worker threads
+// take the solid given to the constructor), its placements are composed
+// with D*M and its daughters with the inverse transformation. A reflected volume without
+// daughters is replaced by its original logical volume, when known to the
+// reflection factory.
+//
+// The reflected solids that remain are shared: logical volumes reflecting
+// the same solid with the same transformation use a single wrapper.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02ReflectionOptimiser_h
+#define G02ReflectionOptimiser_h 1
+
+#include <vector>
+
+#include "globals.hh"
+#include "G4Transform3D.hh"
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+// ----------------------------------------------------------------------------
+
+/// Reflection optimisation pass used in GDML read/write example
+
+class G02ReflectionOptimiser
+{
+  public:
+
+    G02ReflectionOptimiser();
+   ~G02ReflectionOptimiser();
+
+    // Optimises the tree below the world volume; returns the number of
+    // reflected solids removed
+    //
+    G4int Optimise(G4VPhysicalVolume* world);
+
+    void PrintReport() const;
+
+    // Reflections about the planes x=0 (bit 0), y=0 (bit 1) and z=0 (bit 2)
+    // leaving the solid unchanged; 0 when unknown
+    //
+    static G4int SymmetryMask(const G4VSolid* solid);
+
+  private:
+
+    typedef std::vector<G4LogicalVolume*> LVList;
+
+    static LVList CollectVolumes(G4VPhysicalVolume* world);
+    static G4Transform3D ObjectTransform(const G4VPhysicalVolume* pv);
+    static G4VPhysicalVolume* Replace(G4VPhysicalVolume* pv,
+                                      G4LogicalVolume* lv,
+                                      const G4Transform3D& transform);
+
+    G4bool Unreflect(G4LogicalVolume* reflectedLV, LVList& volumes);
+    void ShareReflectedSolids(const LVList& volumes);
+
+  private:
+
+    G4int fUnreflected;   // Reflected solids replaced by their constituent
+    G4int fReplacedLVs;   // Reflected volumes replaced by the original ones
+    G4int fPlacements;    // Placements recomposed
+    G4int fShared;        // Reflected solids shared with an identical one
+    G4int fKept;          // Reflected solids left as they are
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
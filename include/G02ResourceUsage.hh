@@ -0,0 +1,67 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02ResourceUsage.hh
+/// \brief Definition of the G02ResourceUsage class
+//
+//
+//
+// Class G02ResourceUsage
+//
+// Small set of static helpers returning the wall-clock time, the process
+// CPU time and the peak resident memory of the running job.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02ResourceUsage_h
+#define G02ResourceUsage_h 1
+
+#include "globals.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Process resource probes used by the G02 profiling tools
+
+class G02ResourceUsage
+{
+  public:
+
+    // Monotonic wall-clock time in seconds, since an arbitrary origin
+    //
+    static G4double WallTime();
+
+    // CPU time (user + system) consumed by the process, in seconds
+    //
+    static G4double CpuTime();
+
+    // Peak resident set size of the process in kilobytes, or 0 when
+    // the information is not available on the platform
+    //
+    static G4long PeakResidentMemory();
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,157 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02Run.hh
+/// \brief Definition of the G02Run class
+//
+//
+//
+// Class G02Run
+//
+// Run object accumulating the number of steps and the per-event wall time,
+// used for the end-of-run throughput report, the per-volume step
+// statistics collected by G02SteppingAction, and the material budget of
+// the geantino scans: per ray and per material sums of the path length,
+// of the thickness in radiation lengths (X0) and in nuclear interaction
+// lengths (lambda). In multi-threaded mode each
+// worker fills its own run, and the worker runs are merged into the master
+// one at end of run.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02Run_h
+#define G02Run_h 1
+
+#include <map>
+#include <vector>
+
+#include "globals.hh"
+#include "G4Run.hh"
+
+#include "G4ThreeVector.hh"
+
+class G4LogicalVolume;
+class G4Material;
+
+// ----------------------------------------------------------------------------
+
+/// Run used in GDML read/write example
+
+class G02Run : public G4Run
+{
+  public:
+
+    // Statistics of the steps done in a logical volume
+    //
+    struct VolumeStats
+    {
+      VolumeStats() : fSteps(0), fBoundarySteps(0), fTime(0.) {}
+
+      G4long   fSteps;          // Steps done in the volume
+      G4long   fBoundarySteps;  // Steps limited by the geometry, i.e.
+                                // followed by a full re-location
+      G4double fTime;           // Wall time, in seconds
+    };
+    typedef std::map<const G4LogicalVolume*, VolumeStats> VolumeStatsMap;
+
+    // Material budget along a path
+    //
+    struct Budget
+    {
+      Budget() : fPath(0.), fX0(0.), fLambda(0.) {}
+
+      G4double fPath;    // Length
+      G4double fX0;      // Thickness in radiation lengths
+      G4double fLambda;  // Thickness in nuclear interaction lengths
+    };
+    typedef std::map<const G4Material*, Budget> MaterialBudgetMap;
+
+    // Material budget of a scan ray
+    //
+    struct RayBudget
+    {
+      G4long        fRay;        // Ray number, see G02PrimaryGeneratorAction
+      G4ThreeVector fOrigin;
+      G4ThreeVector fDirection;
+      Budget        fBudget;
+    };
+
+  public:
+
+    G02Run();
+    virtual ~G02Run();
+
+    virtual void Merge(const G4Run*);
+
+    inline void CountStep() { ++fNumberOfSteps; }
+    inline void AddEventTime(G4double time) { fEventTimes.push_back(time); }
+    inline void AddStep(const G4LogicalVolume* volume, G4bool boundary,
+                        G4double time);
+    inline void AddMaterialStep(const G4Material* material, G4double path,
+                                G4double x0, G4double lambda);
+    inline void AddRayBudget(const RayBudget& ray) { fRayBudgets.push_back(ray); }
+
+    inline G4long GetNumberOfSteps() const { return fNumberOfSteps; }
+    inline const std::vector<G4double>& GetEventTimes() const
+      { return fEventTimes; }
+    inline const VolumeStatsMap& GetVolumeStats() const { return fVolumeStats; }
+    inline const MaterialBudgetMap& GetMaterialBudgets() const
+      { return fMaterialBudgets; }
+    inline std::vector<RayBudget>& GetRayBudgets() { return fRayBudgets; }
+    inline const std::vector<RayBudget>& GetRayBudgets() const
+      { return fRayBudgets; }
+
+  private:
+
+    G4long fNumberOfSteps;
+    std::vector<G4double> fEventTimes;  // Wall time of each event, in seconds
+    VolumeStatsMap fVolumeStats;
+    MaterialBudgetMap fMaterialBudgets;
+    std::vector<RayBudget> fRayBudgets;  // In order of completion
+};
+
+// ----------------------------------------------------------------------------
+
+inline void G02Run::AddStep(const G4LogicalVolume* volume, G4bool boundary,
+                            G4double time)
+{
+  VolumeStats& stats = fVolumeStats[volume];
+  ++stats.fSteps;
+  if (boundary) { ++stats.fBoundarySteps; }
+  stats.fTime += time;
+}
+
+inline void G02Run::AddMaterialStep(const G4Material* material, G4double path,
+                                    G4double x0, G4double lambda)
+{
+  Budget& budget = fMaterialBudgets[material];
+  budget.fPath += path;
+  budget.fX0 += x0;
+  budget.fLambda += lambda;
+}
+
+// ----------------------------------------------------------------------------
+
+#endif
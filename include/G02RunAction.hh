@@ -30,7 +30,19 @@
 //
 // Class G02RunAction
 //
-// Simple run action class.
+// Simple run action class. At the end of each run a throughput report
+// (events/s, steps/s, per-event latency percentiles and peak resident
+// memory) is printed, together with the same figures as a single JSON
+// line, optionally appended to a file for monitoring. When the volume
+// profiling is enabled with
+// /myrun/profileVolumes, the per-volume statistics collected in G02Run are
+// printed at the end of the run: the top-N logical volumes by wall time
+// and the totals per solid type. When the material budget scan is enabled
+// with /myrun/materialBudget, the X0 and lambda thickness per material is
+// printed and the per-ray map is written to the file given with
+// /myrun/materialBudgetFile, as CSV (".csv" extension) or binary.
+// With /myrun/recordSteps, the steps are streamed to a binary file by
+// G02StepRecorder and G02StepWriter.
 //
 // ----------------------------------------------------------------------------
 
@@ -41,8 +53,10 @@
 
 #include "globals.hh"
 #include "G4UserRunAction.hh"
+#include "G02Run.hh"
 
 class G4Run;
+class G02RunActionMessenger;
 
 // ----------------------------------------------------------------------------
 
@@ -55,9 +69,48 @@ class G02RunAction : public G4UserRunAction
     G02RunAction();
    ~G02RunAction();
 
+    virtual G4Run* GenerateRun();
     virtual void BeginOfRunAction(const G4Run*);
     virtual void EndOfRunAction(const G4Run*);
-      
+
+    inline void SetProfileVolumes(G4bool val) { fProfileVolumes = val; }
+    inline G4bool IsProfilingVolumes() const { return fProfileVolumes; }
+    inline void SetTopN(G4int val) { fTopN = val; }
+    inline void SetReportFile(const G4String& name) { fReportFile = name; }
+    inline void SetMaterialBudget(G4bool val) { fMaterialBudget = val; }
+    inline G4bool IsScanningMaterialBudget() const { return fMaterialBudget; }
+    inline void SetMaterialBudgetFile(const G4String& name)
+      { fMaterialBudgetFile = name; }
+    inline void SetRecordFile(const G4String& name) { fRecordFile = name; }
+    inline G4bool IsRecordingSteps() const { return !fRecordFile.empty(); }
+    inline void SetRecordBlockSize(G4int val) { fRecordBlockSize = val; }
+    inline void SetRecordBlocks(G4int val) { fRecordBlocks = val; }
+
+  private:
+
+    void PrintThroughputReport(const G4Run*) const;
+    void PrintVolumeProfile(const G4Run*) const;
+    void PrintMaterialBudget(const G02Run*) const;
+    G4bool WriteMaterialBudgetCSV(const G02Run*, const G4String&) const;
+    G4bool WriteMaterialBudgetBinary(const G02Run*, const G4String&) const;
+    void PrintStatsHeader(const G4String& title) const;
+    void PrintStats(const G4String& name, const G02Run::VolumeStats& stats,
+                    G4double totalTime) const;
+
+  private:
+
+    G02RunActionMessenger* fMessenger;
+    G4bool fProfileVolumes;
+    G4int  fTopN;
+    G4String fReportFile;
+    G4bool   fMaterialBudget;
+    G4String fMaterialBudgetFile;
+    G4String fRecordFile;
+    G4int    fRecordBlockSize;
+    G4int    fRecordBlocks;
+
+    G4double fStartWallTime;
+    G4double fStartCpuTime;
 };
 
 // ----------------------------------------------------------------------------
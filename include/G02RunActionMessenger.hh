@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02RunActionMessenger.hh
+/// \brief Definition of the G02RunActionMessenger class
+//
+//
+//
+// Class G02RunActionMessenger
+//
+// Messenger defining the /myrun/ commands controlling the run profiling.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02RunActionMessenger_h
+#define G02RunActionMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G02RunAction;
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+
+// ----------------------------------------------------------------------------
+
+/// Run action messenger class used in GDML read/write example
+
+class G02RunActionMessenger: public G4UImessenger
+{
+
+  public:
+
+    G02RunActionMessenger( G02RunAction* );
+   ~G02RunActionMessenger();
+
+    virtual void SetNewValue( G4UIcommand*, G4String );
+
+  private:
+
+    G02RunAction*              fTheRunAction;
+    G4UIdirectory*             fTheRunDir;
+    G4UIcmdWithABool*          fTheProfileVolumesCommand;
+    G4UIcmdWithAnInteger*      fTheTopNCommand;
+    G4UIcmdWithAString*        fTheReportFileCommand;
+    G4UIcmdWithABool*          fTheMaterialBudgetCommand;
+    G4UIcmdWithAString*        fTheMaterialBudgetFileCommand;
+    G4UIdirectory*             fTheRecordDir;
+    G4UIcmdWithAString*        fTheRecordFileCommand;
+    G4UIcmdWithAnInteger*      fTheRecordBlockSizeCommand;
+    G4UIcmdWithAnInteger*      fTheRecordBlocksCommand;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,148 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02SolidInterner.hh
+/// \brief Definition of the G02SolidInterner class
+//
+//
+//
+// Class G02SolidInterner
+//
+// Interning of identical solids and logical volumes. A solid is identified
+// by its type and the exact values of its parameters, for the usual CSG
+// solids (box, tube, cone, trapezoids, parallelepiped, sphere, orb and
+// torus); other solids are kept as they are.
+//
+// Intern() is used by the builders when a solid is created: an identical
+// solid already met is returned instead and the new one deleted. Run()
+// is a pass over a whole geometry tree, e.g. read from GDML: the logical
+// volumes are given the interned solids (replaced by copies, see
+// SwapSolids(), except the ones known to G4ReflectionFactory), then the
+// logical volumes are themselves interned, from the leaves up. Two logical volumes are merged
+// when they have the same solid, material, visualisation attributes,
+// sensitive detector, field manager and user limits, and the same
+// daughters placed identically (same names, copy numbers and transforms).
+// Volumes with a region of their own, replicated daughters, a skin surface,
+// daughters bounding a border surface or a reflection registered in
+// G4ReflectionFactory are not merged. The volumes placed by replicas and
+// parameterisations are left alone, as well as their solids, which are
+// resized by ComputeDimensions() during the navigation.
+//
+// The logical volumes merged, with their placements, and the solids
+// replaced are deleted, unless still used out of the tree (e.g. as a
+// boolean constituent, or placed in a volume not in the tree).
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02SolidInterner_h
+#define G02SolidInterner_h 1
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "globals.hh"
+
+class G4VSolid;
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VisAttributes;
+
+// ----------------------------------------------------------------------------
+
+/// Solid and logical volume interning used in GDML read/write example
+
+class G02SolidInterner
+{
+  public:
+
+    G02SolidInterner();
+   ~G02SolidInterner();
+
+    inline void SetEnabled(G4bool val) { fEnabled = val; }
+    inline G4bool IsEnabled() const { return fEnabled; }
+
+    // Returns an identical solid already interned, deleting the given one,
+    // or the given one; returns it unchanged when disabled
+    //
+    G4VSolid* Intern(G4VSolid* solid);
+
+    // Interns the solids and logical volumes of the tree below the world
+    // volume; returns the number of duplicates removed from the tree
+    //
+    G4int Run(G4VPhysicalVolume* world);
+
+    void PrintReport() const;
+
+    // Type and exact parameters of the solid, empty if not supported
+    //
+    static std::string Fingerprint(const G4VSolid* solid);
+
+    // Adds the solids of the store used as constituents of other solids
+    // (boolean, displaced, reflected, scaled and multi-union ones)
+    //
+    static void CollectConstituents(std::set<const G4VSolid*>& constituents);
+
+    // Gives logical volumes other solids, for all the threads. SetSolid()
+    // changes the solid of the calling thread only, the worker threads
+    // (and the G4GeometryWorkspace ones) taking the solid given to the
+    // constructor: each volume is replaced by a copy with its new solid,
+    // which takes its daughters, placements and root region, and deleted.
+    // The volumes with a skin surface, which refers to them, are left as
+    // they are. Returns the copies of the volumes replaced.
+    //
+    static std::map<G4LogicalVolume*, G4LogicalVolume*>
+    SwapSolids(const std::map<G4LogicalVolume*, G4VSolid*>& solids);
+
+  private:
+
+    G4VSolid* Lookup(G4VSolid* solid);
+    const G4VisAttributes* CanonicalVis(const G4VisAttributes* vis);
+    std::string LVFingerprint(const G4LogicalVolume* lv,
+                const std::map<G4LogicalVolume*, G4LogicalVolume*>& merged);
+    void Free(const std::map<G4LogicalVolume*, G4LogicalVolume*>& merged,
+              const std::set<G4VSolid*>& replaced);
+
+  private:
+
+    G4bool fEnabled;
+    std::map<std::string, G4VSolid*> fSolids;
+    std::map<std::string, G4LogicalVolume*> fVolumes;
+    std::vector<const G4VisAttributes*> fVisAttributes;
+
+    G4int fCreatedDuplicates;   // Solids deleted at creation
+    G4int fSolidDuplicates;     // Solids replaced in the tree
+    G4int fVolumeDuplicates;    // Logical volumes replaced in the tree
+    G4int fPlacements;          // Placements given another logical volume
+    G4int fVolumesBefore;       // Logical volumes in the tree
+    G4int fVolumesAfter;
+    G4int fSolidsFreed;
+    G4int fVolumesFreed;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
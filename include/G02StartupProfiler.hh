@@ -0,0 +1,147 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02StartupProfiler.hh
+/// \brief Definition of the G02StartupProfiler class
+//
+//
+//
+// Class G02StartupProfiler
+//
+// Records the wall time, CPU time and peak resident memory growth of the
+// phases of the job start-up. Phases are opened explicitly by the example
+// code (GDML reading, material dumps, ...) and implicitly by following the
+// application state transitions of the kernel ("/run/initialize" and the
+// run set-up done at the first "/run/beamOn", i.e. physics tables building
+// and voxelisation). Results are printed as a table and can be written in
+// the Chrome trace-event JSON format (chrome://tracing, Perfetto).
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02StartupProfiler_h
+#define G02StartupProfiler_h 1
+
+#include <vector>
+
+#include "globals.hh"
+#include "G4VStateDependent.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Start-up phase profiler used in GDML read/write example
+
+class G02StartupProfiler : public G4VStateDependent
+{
+  public:
+
+    static G02StartupProfiler* Instance();
+
+   ~G02StartupProfiler();
+
+    // Open/close a phase; phases nest, the innermost one is closed first
+    //
+    void BeginPhase(const G4String& name);
+    void EndPhase();
+
+    // Output
+    //
+    void Print() const;
+    G4bool WriteChromeTrace(const G4String& fileName) const;
+
+    // Called at the end of the job: prints the table and writes the trace
+    // file, if requested
+    //
+    void Finish();
+
+    // Settings
+    //
+    inline void SetEnabled(G4bool val) { fEnabled = val; }
+    inline G4bool IsEnabled() const { return fEnabled; }
+    inline void SetTraceFile(const G4String& name) { fTraceFile = name; }
+    inline void SetTrialVoxelisation(G4bool val) { fTrialVoxelisation = val; }
+
+    // Follows the kernel state transitions
+    //
+    virtual G4bool Notify(G4ApplicationState requestedState);
+
+  private:
+
+    G02StartupProfiler();
+
+    struct Sample
+    {
+      G4double fWall;
+      G4double fCpu;
+      G4long   fPeakMemory;
+    };
+
+    struct Phase
+    {
+      G4String fName;
+      G4int    fDepth;
+      Sample   fBegin;
+      Sample   fEnd;
+      G4bool   fClosed;
+    };
+
+    Sample TakeSample() const;
+    Sample EndOf(const Phase& phase) const;
+    G4double ChildrenWall(std::size_t index) const;
+    void CloseKernelPhase();
+
+  private:
+
+    std::vector<Phase> fPhases;
+    std::vector<std::size_t> fOpenPhases;  // Stack of indices in fPhases
+
+    G4double fOrigin;
+    G4int    fKernelPhase;    // Index of the open kernel phase, -1 if none
+    G4bool   fEnabled;
+    G4bool   fTrialVoxelisation;
+    G4String fTraceFile;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Scoped phase: opened at construction and closed at destruction
+
+class G02ProfilePhase
+{
+  public:
+
+    explicit G02ProfilePhase(const G4String& name)
+      { G02StartupProfiler::Instance()->BeginPhase(name); }
+   ~G02ProfilePhase()
+      { G02StartupProfiler::Instance()->EndPhase(); }
+
+  private:
+
+    G02ProfilePhase(const G02ProfilePhase&);
+    G02ProfilePhase& operator=(const G02ProfilePhase&);
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,116 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02StepRecorder.hh
+/// \brief Definition of the G02StepRecorder class
+//
+//
+//
+// Class G02StepRecorder
+//
+// Per-thread collector of step records (event, track, volume id, post-step
+// position, energy deposit and global time). Records are appended to the
+// current block of a small ring of fixed-size blocks; full blocks are
+// handed to G02StepWriter, which writes them from a background thread.
+// Recording a step is a few stores in pre-allocated arrays: the tracking
+// thread only waits when the whole ring is pending in the writer.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02StepRecorder_h
+#define G02StepRecorder_h 1
+
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G02StepWriter.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Step recorder used in GDML read/write example
+
+class G02StepRecorder
+{
+  public:
+
+    G02StepRecorder(std::size_t blockSize, G4int nBlocks);
+   ~G02StepRecorder();
+
+    // Recorder of the calling thread: created (or re-created with new
+    // sizes) at the start of each recorded run, deleted with the thread's
+    // stepping action
+    //
+    static G02StepRecorder* GetThreadInstance();
+    static G02StepRecorder* CreateThreadInstance(std::size_t blockSize,
+                                                 G4int nBlocks);
+    static void DeleteThreadInstance();
+
+    inline void SetRun(G4int run) { fRun = run; fCurrent->fRun = run; }
+
+    inline void Record(G4int event, G4int track, G4int volume,
+                       const G4ThreeVector& position, G4double edep,
+                       G4double time);
+
+    // Hands the current, partially filled, block to the writer
+    //
+    void Flush();
+
+  private:
+
+    void NextBlock();
+
+  private:
+
+    G02StepWriter* fWriter;
+    std::vector<G02StepWriter::Block*> fBlocks;
+    std::size_t fCurrentIndex;
+    G02StepWriter::Block* fCurrent;
+    G4int fRun;
+    G4int fThread;
+};
+
+// ----------------------------------------------------------------------------
+
+inline void G02StepRecorder::Record(G4int event, G4int track, G4int volume,
+                                    const G4ThreeVector& position,
+                                    G4double edep, G4double time)
+{
+  G02StepWriter::Block* block = fCurrent;
+  std::size_t i = block->fSize;
+  block->fEvent[i] = event;
+  block->fTrack[i] = track;
+  block->fVolume[i] = volume;
+  block->fX[i] = position.x();
+  block->fY[i] = position.y();
+  block->fZ[i] = position.z();
+  block->fEdep[i] = edep;
+  block->fTime[i] = time;
+  if (++block->fSize == block->fCapacity) { NextBlock(); }
+}
+
+// ----------------------------------------------------------------------------
+
+#endif
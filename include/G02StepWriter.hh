@@ -0,0 +1,161 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02StepWriter.hh
+/// \brief Definition of the G02StepWriter class
+//
+//
+//
+// Class G02StepWriter
+//
+// Background writer of the step records collected by G02StepRecorder.
+// Tracking threads fill fixed-size blocks of records, stored by column,
+// and hand the full blocks to the writer; a single writer thread gathers
+// all the queued blocks and writes them with one vectored write (writev)
+// per batch, directly from the block columns, then gives the blocks back
+// to their recorder. Tracking threads only wait when all the blocks of
+// their ring are still queued; these stalls are counted and reported.
+//
+// File layout (native byte order):
+//
+//   char[8] "G02STEP1"                          file header
+//   chunk*                                      blocks and volume tables
+//
+//   block chunk:  char[4] "BLK0", uint32 n, int32 run, int32 thread,
+//                 int32 event[n], int32 track[n], int32 volume[n],
+//                 double x[n], y[n], z[n]   (mm, post-step point),
+//                 double edep[n]            (MeV),
+//                 double time[n]            (ns, post-step global time)
+//
+//   volume chunk: char[4] "VOL0", uint32 m,
+//                 m x { int32 id, uint32 length, char name[length] }
+//
+// Volume ids are the instance ids of the logical volumes; a volume chunk
+// is written each time the file is closed, i.e. at the end of each run.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02StepWriter_h
+#define G02StepWriter_h 1
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "globals.hh"
+
+// ----------------------------------------------------------------------------
+
+/// Step record writer used in GDML read/write example
+
+class G02StepWriter
+{
+  public:
+
+    // Block of step records, stored by column
+    //
+    struct Block
+    {
+      explicit Block(std::size_t capacity);
+
+      std::size_t fCapacity;
+      std::size_t fSize;
+      G4int       fRun;
+      G4int       fThread;
+      G4bool      fQueued;     // Owned by the writer until written
+
+      std::vector<std::int32_t> fEvent, fTrack, fVolume;
+      std::vector<G4double> fX, fY, fZ, fEdep, fTime;
+    };
+
+  public:
+
+    static G02StepWriter* Instance();
+
+   ~G02StepWriter();
+
+    // Opens the file and starts the writer thread; a file already written
+    // in this job is appended to
+    //
+    G4bool Open(const G4String& fileName);
+
+    // Writes the queued blocks and the volume table, stops the writer
+    // thread and closes the file
+    //
+    void Close();
+
+    inline G4bool IsOpen() const { return fOpen; }
+
+    // Called by the recorders: queues a full (or last) block, and waits
+    // until a block has been written
+    //
+    void Submit(Block* block);
+    void WaitUntilWritten(Block* block);
+
+  private:
+
+    G02StepWriter();
+
+    void WriterLoop();
+    G4bool WriteBlocks(const std::vector<Block*>& blocks);
+    G4bool WriteVolumeTable();
+    G4bool WriteBuffers(const std::vector<const void*>& data,
+                        const std::vector<std::size_t>& sizes);
+
+  private:
+
+    std::mutex fMutex;
+    std::condition_variable fQueuedCondition;
+    std::condition_variable fWrittenCondition;
+    std::deque<Block*> fQueue;
+    std::thread fThread;
+    G4bool fStop;
+    G4bool fOpen;
+
+    G4String fFileName;
+    G4String fLastFileName;
+#if defined(_WIN32)
+    std::FILE* fFile;
+#else
+    G4int fFile;
+#endif
+
+    // Statistics of the current file
+    //
+    G4long fRecords;
+    G4long fBytes;
+    G4long fWrites;
+    G4long fStalls;
+    G4double fStallTime;
+    G4bool fError;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02SteppingAction.hh
+/// \brief Definition of the G02SteppingAction class
+//
+//
+//
+// Class G02SteppingAction
+//
+// Stepping action counting the steps of the run and accounting, when
+// enabled with /myrun/profileVolumes, the number of steps and the wall
+// time spent in each logical volume. When the material budget scan is
+// enabled with /myrun/materialBudget, the thickness in X0 and lambda
+// crossed by the primary tracks is summed per material in the run and
+// per ray here; G02TrackingAction stores the ray sums in the run. With
+// /myrun/record/file, each step is passed to the G02StepRecorder of the
+// thread.
+// The time of a step is the time elapsed since the previous step of the
+// same track (or since the track start, see G02TrackingAction) and is
+// attributed to the volume the step was done in.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02SteppingAction_h
+#define G02SteppingAction_h 1
+
+#include "globals.hh"
+#include "G4UserSteppingAction.hh"
+#include "G02Run.hh"
+
+class G02RunAction;
+
+// ----------------------------------------------------------------------------
+
+/// Stepping action used in GDML read/write example
+
+class G02SteppingAction : public G4UserSteppingAction
+{
+  public:
+
+    G02SteppingAction(const G02RunAction* runAction);
+   ~G02SteppingAction();
+
+    virtual void UserSteppingAction(const G4Step*);
+
+    // Restart the step clock, at the beginning of a track
+    //
+    void ResetClock();
+
+    // Material budget of the current primary track
+    //
+    inline void ResetRayBudget() { fRayBudget = G02Run::Budget(); }
+    inline const G02Run::Budget& GetRayBudget() const { return fRayBudget; }
+
+  private:
+
+    const G02RunAction* fRunAction;
+    G4double fLastTime;
+    G02Run::Budget fRayBudget;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
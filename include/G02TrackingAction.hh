@@ -0,0 +1,71 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02TrackingAction.hh
+/// \brief Definition of the G02TrackingAction class
+//
+//
+//
+// Class G02TrackingAction
+//
+// Tracking action restarting the step clock of G02SteppingAction, so that
+// the track set-up is not attributed to the first step, and storing in
+// the run the material budget of each primary ray of a scan.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02TrackingAction_h
+#define G02TrackingAction_h 1
+
+#include "globals.hh"
+#include "G4UserTrackingAction.hh"
+
+class G02RunAction;
+class G02SteppingAction;
+
+// ----------------------------------------------------------------------------
+
+/// Tracking action used in GDML read/write example
+
+class G02TrackingAction : public G4UserTrackingAction
+{
+  public:
+
+    G02TrackingAction(const G02RunAction* runAction,
+                      G02SteppingAction* steppingAction);
+   ~G02TrackingAction();
+
+    virtual void PreUserTrackingAction(const G4Track*);
+    virtual void PostUserTrackingAction(const G4Track*);
+
+  private:
+
+    const G02RunAction* fRunAction;
+    G02SteppingAction* fSteppingAction;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
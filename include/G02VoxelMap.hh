@@ -0,0 +1,151 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/include/G02VoxelMap.hh
+/// \brief Definition of the G02VoxelMap class
+//
+//
+//
+// Class G02VoxelMap
+//
+// Regular grid of the materials of a geometry, for fast simulations that
+// look the materials up by voxel. The material at the centre of every
+// voxel of the bounding box of the world is found by walking rows of
+// voxels along x with a navigator: a row is located once, then crosses
+// its volumes boundary to boundary (ComputeStep and relative relocation,
+// as done by the transportation), the voxels between two boundaries
+// taking the material of the volume without being located. The rows of a
+// z slice are walked back and forth, each row being located from the end
+// of the previous one (G02CoherentNavigator). The slices are shared among
+// threads, each with its own navigator and geometry workspace, as the
+// worker threads of a run.
+//
+// File layout (native byte order, every array 8-byte aligned, all the
+// offsets from the start of the file), to be mapped read-only:
+//
+//   Header        char[8] "G02VOXL1", uint32 version, uint32 nMaterials,
+//                 uint32 bins[3], uint32 outside, double min[3],
+//                 double max[3] (mm), uint64 materialTableOffset,
+//                 uint64 gridOffset, uint64 fileSize
+//   MaterialRecord[nMaterials]
+//   per material: char name[]
+//   Grid          uint16 voxels[bins[2]][bins[1]][bins[0]] (x fastest):
+//                 index in the material table (the Geant4 material
+//                 index), or "outside" beyond the world volume
+//
+// The densities and interaction lengths of the voxels are the ones of
+// their material records.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef G02VoxelMap_h
+#define G02VoxelMap_h 1
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G02CoherentNavigator.hh"
+
+class G4VPhysicalVolume;
+
+// ----------------------------------------------------------------------------
+
+/// Material voxel map export used in GDML read/write example
+
+class G02VoxelMap
+{
+  public:
+
+    struct Header
+    {
+      char          fMagic[8];
+      std::uint32_t fVersion;
+      std::uint32_t fMaterials;
+      std::uint32_t fBins[3];
+      std::uint32_t fOutside;
+      double        fMin[3];
+      double        fMax[3];
+      std::uint64_t fMaterialTableOffset;
+      std::uint64_t fGridOffset;
+      std::uint64_t fFileSize;
+    };
+
+    struct MaterialRecord
+    {
+      std::uint64_t fNameOffset;
+      std::uint32_t fNameLength;
+      std::uint32_t fReserved;
+      double        fDensity;             // g/cm3
+      double        fRadiationLength;     // mm
+      double        fInteractionLength;   // mm
+      std::uint64_t fVoxels;
+    };
+
+  public:
+
+    G02VoxelMap();
+   ~G02VoxelMap();
+
+    // Samples the world and writes the map; returns false on failure
+    //
+    G4bool Export(const G4VPhysicalVolume* world, const G4String& fileName);
+
+    // Settings: voxels along x, y and z, and threads (0 for the number
+    // of cores)
+    //
+    inline void SetBins(G4int nx, G4int ny, G4int nz)
+      { fBins[0] = nx; fBins[1] = ny; fBins[2] = nz; }
+    inline void SetThreads(G4int n) { fThreads = n; }
+
+  private:
+
+    // Walks the slices taken in turn, with its own navigator
+    //
+    void Walk(const G4VPhysicalVolume* world, std::atomic<G4int>& nextSlice,
+              G4bool workspace);
+
+  private:
+
+    G4int fBins[3];
+    G4int fThreads;
+
+    // State of one export
+    //
+    G4ThreeVector fMin;
+    G4ThreeVector fSize;                  // Of the voxels
+    std::vector<std::uint16_t> fGrid;
+    std::atomic<G4long> fLocateCalls;
+    std::atomic<G4long> fRelocateCalls;
+    G02CoherentNavigator::Statistics fLocateStatistics;
+    std::mutex fStatisticsMutex;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif
@@ -39,9 +39,14 @@ public:
 
   void  ListMaterial();
 
+  // 0: silent, 1: one line per added material, 2: also the table sizes
+  void  SetVerbose (G4int level) {verboseLevel = level;};
+  G4int GetVerbose () {return verboseLevel;};
+
 private:
 
   MLMaterialMessenger         *materialMessenger;
+  G4int                        verboseLevel;
 
   std::vector<G4Material*>   Material;
   std::vector<G4Element*>    Element;
@@ -44,6 +44,7 @@ private:
   G4UIcommand               *AddCmd;
   G4UIcmdWithAString        *AddNISTCmd;
   G4UIcmdWithAString        *ListNISTCmd;
+  G4UIcmdWithAnInteger      *VerboseCmd;
 };
 ////////////////////////////////////////////////////////////////////////////////
 #endif
@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02ActionInitialization.cc
+/// \brief Implementation of the G02ActionInitialization class
+//
+//
+//
+// Class G02ActionInitialization implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02ActionInitialization.hh"
+#include "G02PrimaryGeneratorAction.hh"
+#include "G02RunAction.hh"
+#include "G02EventAction.hh"
+#include "G02SteppingAction.hh"
+#include "G02TrackingAction.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02ActionInitialization::G02ActionInitialization()
+  : G4VUserActionInitialization()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02ActionInitialization::~G02ActionInitialization()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02ActionInitialization::BuildForMaster() const
+{
+  SetUserAction(new G02RunAction);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02ActionInitialization::Build() const
+{
+  SetUserAction(new G02PrimaryGeneratorAction);
+
+  G02RunAction* runAction = new G02RunAction;
+  SetUserAction(runAction);
+  SetUserAction(new G02EventAction);
+
+  G02SteppingAction* steppingAction = new G02SteppingAction(runAction);
+  SetUserAction(steppingAction);
+  SetUserAction(new G02TrackingAction(runAction, steppingAction));
+}
@@ -38,6 +38,9 @@
 #include "G4Box.hh"
 #include "G4VPhysicalVolume.hh"
 
+#include <algorithm>
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G02ChamberParameterisation::
@@ -46,24 +49,48 @@ G02ChamberParameterisation( G4int    NoChambers,
                          G4double spacingZ,        //  Z spacing of centers
                          G4double widthChamber, 
                          G4double lengthInitial, 
-                         G4double lengthFinal )
+                         G4double lengthFinal,
+                         G4bool   solidPerCopy )
  : G4VPVParameterisation()
 {
   fNoChambers =  NoChambers; 
-  fStartZ     =  startZ; 
   fHalfWidth  =  widthChamber*0.5;
-  fSpacing    =  spacingZ;
-  fHalfLengthFirst = 0.5 * lengthInitial; 
 
   if( NoChambers > 0 )
   {
-    fHalfLengthIncr = 0.5 * (lengthFinal-lengthInitial)/NoChambers;
     if (spacingZ < widthChamber)
     {
       G4Exception("ExN02G02ChamberParameterisation::G02ChamberParameterisation()",
                   "InvalidSetup", FatalException,
                   "Invalid construction: Width>Spacing");
     }
+
+    // Tabulate the copies
+    //
+    G4double halfLengthFirst = 0.5 * lengthInitial;
+    G4double halfLengthIncr = 0.5 * (lengthFinal-lengthInitial)/NoChambers;
+
+    fTranslations.reserve(NoChambers);
+    fHalfLengths.reserve(NoChambers);
+    for (G4int copyNo = 0; copyNo < NoChambers; ++copyNo)
+    {
+      fTranslations.push_back(
+        G4ThreeVector(0., 0., startZ + (copyNo+1) * spacingZ));
+      fHalfLengths.push_back(halfLengthFirst + copyNo * halfLengthIncr);
+    }
+
+    if (solidPerCopy)
+    {
+      fSolids.reserve(NoChambers);
+      for (G4int copyNo = 0; copyNo < NoChambers; ++copyNo)
+      {
+        std::ostringstream name;
+        name << "chamber_" << copyNo;
+        fSolids.push_back(new G4Box(name.str(), fHalfLengths[copyNo],
+                                    fHalfLengths[copyNo], fHalfWidth));
+      }
+      fSolidSet.insert(fSolids.begin(), fSolids.end());
+    }
   }
 }
 
@@ -77,22 +104,52 @@ G02ChamberParameterisation::~G02ChamberParameterisation()
 void G02ChamberParameterisation::
 ComputeTransformation (const G4int copyNo, G4VPhysicalVolume* physVol) const
 {
-  G4double Zposition = fStartZ + (copyNo+1) * fSpacing;
-  G4ThreeVector origin(0.,0.,Zposition);
-  physVol->SetTranslation(origin);
+  physVol->SetTranslation(fTranslations[copyNo]);
   physVol->SetRotation(0);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4VSolid* G02ChamberParameterisation::
+ComputeSolid (const G4int copyNo, G4VPhysicalVolume* physVol)
+{
+  if (fSolids.empty())
+  {
+    return G4VPVParameterisation::ComputeSolid(copyNo, physVol);
+  }
+  return fSolids[copyNo];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void G02ChamberParameterisation::
 ComputeDimensions (G4Box& trackerChamber, const G4int copyNo,
                    const G4VPhysicalVolume*) const
 {
-  G4double halfLength = fHalfLengthFirst + copyNo * fHalfLengthIncr;
+  // The per-copy solids already have their dimensions and are never
+  // resized, whichever copy they are given for; only the shared solid is,
+  // e.g. by the GDML writer. Called for every candidate copy at each
+  // step: the test is kept in constant time.
+  //
+  if (!fSolids.empty())
+  {
+    if (copyNo >= 0 && copyNo < G4int(fSolids.size())
+        && fSolids[copyNo] == &trackerChamber) { return; }
+    if (fSolidSet.count(&trackerChamber) != 0) { return; }
+  }
+
+  G4double halfLength = fHalfLengths[copyNo];
   trackerChamber.SetXHalfLength(halfLength);
   trackerChamber.SetYHalfLength(halfLength);
   trackerChamber.SetZHalfLength(fHalfWidth);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02ChamberParameterisation::GetMaxHalfLength() const
+{
+  if (fHalfLengths.empty()) { return 0.; }
+  return *std::max_element(fHalfLengths.begin(), fHalfLengths.end());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
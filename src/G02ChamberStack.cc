@@ -0,0 +1,201 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02ChamberStack.cc
+/// \brief Implementation of the G02ChamberStack class
+//
+//
+//
+// Class G02ChamberStack implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02ChamberStack.hh"
+#include "G02ChamberParameterisation.hh"
+#include "G02GeometryArena.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4PVParameterised.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02ChamberStack::G02ChamberStack(G4int    nChambers,
+                                 G4double spacing,
+                                 G4double width,
+                                 G4double lengthInitial,
+                                 G4double lengthFinal)
+  : fChambers(nChambers), fSpacing(spacing), fWidth(width),
+    fLengthInitial(lengthInitial), fLengthFinal(lengthFinal),
+    fMaxCopiesPerVolume(1000), fSolidPerCopy(true)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02ChamberStack::~G02ChamberStack()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02ChamberStack::ChamberZ(G4int index) const
+{
+  // As in G02ChamberParameterisation, for a stack centred on the origin
+  //
+  return -0.5*GetLength() + 0.5*fWidth + (index+1)*fSpacing;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02ChamberStack::ChamberHalfLength(G4int index) const
+{
+  return 0.5*fLengthInitial
+       + index * 0.5*(fLengthFinal-fLengthInitial)/fChambers;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02ChamberStack::GetMaxHalfLength() const
+{
+  if (fChambers < 1) { return 0.; }
+  return std::max(ChamberHalfLength(0), ChamberHalfLength(fChambers-1));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02ChamberStack::GetChambersVolume() const
+{
+  // Square chambers of half-lengths a + i*d, i = 0..N-1, and width w:
+  // 4w * sum (a + i*d)^2
+  //
+  G4double n = fChambers;
+  G4double a = 0.5*fLengthInitial;
+  G4double d = 0.5*(fLengthFinal-fLengthInitial)/fChambers;
+  return 4.*fWidth*(n*a*a + a*d*n*(n-1.) + d*d*(n-1.)*n*(2.*n-1.)/6.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02ChamberStack::GetChambersPerBlock() const
+{
+  if (fMaxCopiesPerVolume <= 0 || fChambers <= fMaxCopiesPerVolume)
+  {
+    return fChambers;
+  }
+  return G4int(std::ceil(std::sqrt(G4double(fChambers))));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4LogicalVolume* G02ChamberStack::NewChamberLV(G4Material* material) const
+{
+  // Dummy values for G4Box -- modified by parameterised volume. Each
+  // parameterised volume gets its own logical volume: in multi-threaded
+  // mode the worker threads clone the solid of the logical volume of every
+  // parameterised volume, once per volume.
+  //
+  G4Box* solidChamber = new G4Box("chamber", 10*cm, 10*cm, 1*cm);
+  return new G4LogicalVolume(solidChamber, material, "Chamber", 0, 0, 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02ChamberStack::Place(G4LogicalVolume* motherLV,
+                            G4Material* chamberMaterial,
+                            G02GeometryArena* arena) const
+{
+  if (fChambers < 1) { return; }
+
+  G4int perBlock = GetChambersPerBlock();
+  if (perBlock == fChambers)
+  {
+    G4VPVParameterisation* chamberParam =
+      new G02ChamberParameterisation(fChambers,
+                                     ChamberZ(-1),     // Z of center of first
+                                     fSpacing,         // Z spacing of centers
+                                     fWidth,           // Width Chamber
+                                     fLengthInitial,   // lengthInitial
+                                     fLengthFinal,     // lengthFinal
+                                     fSolidPerCopy);
+    if (arena != 0) { arena->Adopt(chamberParam); }
+    new G4PVParameterised("Chamber", NewChamberLV(chamberMaterial), motherLV,
+                          kZAxis, fChambers, chamberParam);
+    return;
+  }
+
+  // Blocks of consecutive chambers, each one a box just enclosing them
+  //
+  G4double halfLengthIncr = 0.5*(fLengthFinal-fLengthInitial)/fChambers;
+  G4int nBlocks = (fChambers + perBlock - 1)/perBlock;
+  for (G4int block = 0; block < nBlocks; ++block)
+  {
+    G4int first = block*perBlock;
+    G4int nCopies = std::min(perBlock, fChambers-first);
+    G4int last = first + nCopies - 1;
+
+    G4double zLow  = ChamberZ(first) - 0.5*fWidth;
+    G4double zHigh = ChamberZ(last) + 0.5*fWidth;
+    G4double zBlock = 0.5*(zLow+zHigh);
+    G4double halfXY = std::max(ChamberHalfLength(first),
+                               ChamberHalfLength(last));
+
+    std::ostringstream name;
+    name << "ChamberBlock_" << block;
+    G4Box* blockBox = new G4Box(name.str(), halfXY, halfXY,
+                                0.5*(zHigh-zLow));
+    G4LogicalVolume* blockLV =
+      new G4LogicalVolume(blockBox, motherLV->GetMaterial(),
+                          name.str() + "LV");
+
+    // Same linear law as the whole stack, restarted at the first chamber
+    // of the block and expressed in the block frame
+    //
+    G4double lengthFirst = 2.*ChamberHalfLength(first);
+    G4VPVParameterisation* chamberParam =
+      new G02ChamberParameterisation(nCopies,
+                                     ChamberZ(first-1) - zBlock,
+                                     fSpacing,
+                                     fWidth,
+                                     lengthFirst,
+                                     lengthFirst + 2.*halfLengthIncr*nCopies,
+                                     fSolidPerCopy);
+    if (arena != 0) { arena->Adopt(chamberParam); }
+    new G4PVParameterised("Chamber", NewChamberLV(chamberMaterial), blockLV,
+                          kZAxis, nCopies, chamberParam);
+
+    new G4PVPlacement(0, G4ThreeVector(0., 0., zBlock), blockLV,
+                      name.str(), motherLV, false, block);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
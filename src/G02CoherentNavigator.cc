@@ -0,0 +1,205 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02CoherentNavigator.cc
+/// \brief Implementation of the G02CoherentNavigator class
+//
+//
+//
+// Class G02CoherentNavigator implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02CoherentNavigator.hh"
+
+#include "G4VSolid.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4AffineTransform.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02CoherentNavigator::Statistics::Statistics()
+  : fLocations(0), fSameVolume(0), fMotherChain(0), fTopDown(0),
+    fOutside(0), fLevelsUp(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02CoherentNavigator::Statistics::Add(const Statistics& other)
+{
+  fLocations += other.fLocations;
+  fSameVolume += other.fSameVolume;
+  fMotherChain += other.fMotherChain;
+  fTopDown += other.fTopDown;
+  fOutside += other.fOutside;
+  fLevelsUp += other.fLevelsUp;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02CoherentNavigator::Statistics::Print(std::ostream& out) const
+{
+  G4double scale = fLocations > 0 ? 100./fLocations : 0.;
+  G4long searches = fMotherChain + fTopDown;
+  std::streamsize precision = out.precision();
+  out << fLocations << " coherent locations: " << std::fixed
+      << std::setprecision(1)
+      << scale*fSameVolume << "% in the same volume, "
+      << scale*fMotherChain << "% from the mother chain, "
+      << scale*fTopDown << "% from the top, "
+      << scale*fOutside << "% outside";
+  if (searches > 0)
+  {
+    out << " (" << std::setprecision(2) << G4double(fLevelsUp)/searches
+        << " levels up per search)";
+  }
+  out.unsetf(std::ios::fixed);
+  out.precision(precision);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02CoherentNavigator::G02CoherentNavigator()
+  : G4Navigator(),
+    fMaxDaughterTests(8),
+    fOutsideWorld(true)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02CoherentNavigator::~G02CoherentNavigator()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VPhysicalVolume*
+G02CoherentNavigator::LocateGlobalPointAndSetup(const G4ThreeVector& point,
+                                                const G4ThreeVector* direction,
+                                                const G4bool relativeSearch,
+                                                const G4bool ignoreDirection)
+{
+  G4VPhysicalVolume* volume =
+    G4Navigator::LocateGlobalPointAndSetup(point, direction, relativeSearch,
+                                           ignoreDirection);
+  fOutsideWorld = (volume == 0);
+  return volume;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02CoherentNavigator::InCurrentVolume(const G4ThreeVector& point) const
+{
+  // Nothing to start from before the first location or out of the world
+  //
+  if (fOutsideWorld) { return false; }
+  const G4VPhysicalVolume* volume = fHistory.GetTopVolume();
+  if (volume == 0 || fHistory.GetTopVolumeType() != kNormal) { return false; }
+
+  // Points on the surface are left to the navigator, which looks at the
+  // direction
+  //
+  const G4LogicalVolume* logical = volume->GetLogicalVolume();
+  G4ThreeVector local = fHistory.GetTopTransform().TransformPoint(point);
+  if (logical->GetSolid()->Inside(local) != kInside) { return false; }
+
+  std::size_t nDaughters = logical->GetNoDaughters();
+  if (nDaughters == 0) { return true; }
+  if (G4int(nDaughters) > fMaxDaughterTests
+      || logical->CharacteriseDaughters() != kNormal) { return false; }
+
+  // Same test as G4NormalNavigation, in the frame of each daughter
+  //
+  for (std::size_t i = 0; i < nDaughters; ++i)
+  {
+    const G4VPhysicalVolume* daughter = logical->GetDaughter(i);
+    G4AffineTransform transform(daughter->GetRotation(),
+                                daughter->GetTranslation());
+    G4ThreeVector daughterPoint = transform.Inverse().TransformPoint(local);
+    if (daughter->GetLogicalVolume()->GetSolid()->Inside(daughterPoint)
+        != kOutside) { return false; }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VPhysicalVolume*
+G02CoherentNavigator::Locate(const G4ThreeVector& point,
+                             const G4ThreeVector* direction)
+{
+  ++fStatistics.fLocations;
+
+  if (InCurrentVolume(point))
+  {
+    // Updates the local point and the voxel node for the next step
+    //
+    LocateGlobalPointWithinVolume(point);
+    ++fStatistics.fSameVolume;
+    return fHistory.GetTopVolume();
+  }
+
+  // The relative search leaves the levels not containing the point, from
+  // the current one up, and goes down from the first one containing it
+  //
+  G4int depth = G4int(fHistory.GetDepth());
+  fPath.resize(depth+1);
+  for (G4int i = 0; i <= depth; ++i)
+  {
+    fPath[i].fVolume = fHistory.GetVolume(i);
+    fPath[i].fReplicaNo = fHistory.GetReplicaNo(i);
+  }
+
+  G4VPhysicalVolume* volume =
+    LocateGlobalPointAndSetup(point, direction, true, direction == 0);
+  if (volume == 0)
+  {
+    ++fStatistics.fOutside;
+    return 0;
+  }
+
+  // Deepest level common to the two paths
+  //
+  G4int common = 0;
+  G4int levels = std::min(depth, G4int(fHistory.GetDepth()));
+  while (common < levels
+         && fHistory.GetVolume(common+1) == fPath[common+1].fVolume
+         && fHistory.GetReplicaNo(common+1) == fPath[common+1].fReplicaNo)
+  {
+    ++common;
+  }
+  fStatistics.fLevelsUp += depth - common;
+  if (common > 0) { ++fStatistics.fMotherChain; }
+  else            { ++fStatistics.fTopDown; }
+
+  return volume;
+}
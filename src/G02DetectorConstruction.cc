@@ -48,7 +48,6 @@
 //
 #include "G4LogicalVolume.hh"
 #include "G4VPhysicalVolume.hh"
-#include "G4PVParameterised.hh"
 #include "G4PVPlacement.hh"
 #include "G4Box.hh"
 #include "G4Tubs.hh"
@@ -68,16 +67,42 @@
 
 // Volume parameterisations
 //
-#include "G02ChamberParameterisation.hh"
+#include "G02ChamberStack.hh"
 
 // Messenger
 //
 #include "G02DetectorMessenger.hh"
 
+// Geometry optimisation
+//
+#include "G02GeometryFlattener.hh"
+#include "G02ReflectionOptimiser.hh"
+#include "G02MaterialMatcher.hh"
+#include "G02LazySolid.hh"
+
+// Memory-mapped meshes
+//
+#include "G02MeshFile.hh"
+#include "G02MappedTessellatedSolid.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SolidStore.hh"
+
+#include <cmath>
+#include <map>
+#include <set>
+
+// Start-up profiling
+//
+#include "G02StartupProfiler.hh"
+
 // GDML parser include
 //
 #include "G4GDMLParser.hh"
 
+#include "G4RunManager.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 
@@ -88,6 +113,7 @@
 G02DetectorConstruction::G02DetectorConstruction()
   : G4VUserDetectorConstruction(), 
     fAir(0), fAluminum(0), fPb(0), fXenon(0),
+    fParser(&fReader),
     fDetectorMessenger(0)
 {
   fExpHall_x=5.*m;
@@ -96,6 +122,15 @@ G02DetectorConstruction::G02DetectorConstruction()
   fWriteFile="wtest.gdml";
   fStepFile ="mbb";
   fWritingChoice=1;
+  fVerboseLevel=2;
+
+  fChamberCount=5;
+  fChamberSpacing=8*cm;
+  fChamberWidth=2*cm;
+  fChamberMass=0.;
+  fFlatten=false;
+  fOptimiseReflections=false;
+  fSwappedWorld=0;
  
   fDetectorMessenger = new G02DetectorMessenger( this );
 }
@@ -119,6 +154,29 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
 
   G4VPhysicalVolume* fWorldPhysVol;
 
+  // A geometry swapped in the Idle state is already built
+  //
+  if (fSwappedWorld != 0)
+  {
+    fWorldPhysVol = fSwappedWorld;
+    fSwappedWorld = 0;
+    return fWorldPhysVol;
+  }
+
+  // A geometry built before, when the geometry is re-initialised, is
+  // released in one step together with the maps of the GDML parser
+  //
+  G4bool rebuilt = fArena.IsInUse();
+  if (rebuilt)
+  {
+    G02ProfilePhase phase("construct/release");
+    fArena.Release();
+    fParser.Clear();
+    fLevelOfDetail.Clear();
+  }
+  fArena.SetInUse();
+  fChamberMass = 0.;
+
   if(fWritingChoice==0)
   {
     // **** LOOK HERE*** FOR READING GDML FILES
@@ -129,7 +187,26 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
     //
     // fParser.SetOverlapCheck(true);
 
+    G02StartupProfiler::Instance()->BeginPhase("construct/GDML read");
     fParser.Read(fReadFile);
+    G02StartupProfiler::Instance()->EndPhase();
+    if (fReader.IsLazy()) { G02LazySolid::PrintStatistics(); }
+
+    // The tessellated solids found in the mesh file are replaced by
+    // solids on its shared read-only mapping
+    //
+    if (!fMeshFile.empty()) { MapMeshes(); }
+
+    // The materials identical to the ones of the previous geometries are
+    // replaced by them, so that their physics tables are kept
+    //
+    if (rebuilt)
+    {
+      G02ProfilePhase phase("construct/material matching");
+      G02MaterialMatcher matcher;
+      matcher.Match(fParser.GetWorldVolume());
+      matcher.PrintReport();
+    }
 
     // READING GDML FILES OPTION: 2nd Boolean argument "Validate".
     // Flag to "false" disables check with the Schema when reading GDML file.
@@ -139,7 +216,9 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
      
     // Prints the material information
     //
-    G4cout << *(G4Material::GetMaterialTable() ) << G4endl;
+    G02StartupProfiler::Instance()->BeginPhase("construct/material table dump");
+    PrintMaterials(fVerboseLevel);
+    G02StartupProfiler::Instance()->EndPhase();
          
     // Giving World Physical Volume from GDML Parser
     //
@@ -151,7 +230,9 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
     // Detector Construction and WRITING to GDML
     //
     ListOfMaterials();
+    G02StartupProfiler::Instance()->BeginPhase("construct/detector build");
     fWorldPhysVol = ConstructDetector();
+    G02StartupProfiler::Instance()->EndPhase();
 
     // OPTION: TO ADD MODULE AT DEPTH LEVEL ...
     //
@@ -182,9 +263,15 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
     // G4int maxlevel=3;
     // fParser.SetMaxExportLevel(maxlevel);
 
-    // Writing Geometry to GDML File
+    // Writing Geometry to GDML File; an empty file name only builds
+    // the geometry
     //
-    fParser.Write(fWriteFile, fWorldPhysVol);
+    if (!fWriteFile.empty())
+    {
+      G02StartupProfiler::Instance()->BeginPhase("construct/GDML write");
+      fParser.Write(fWriteFile, fWorldPhysVol);
+      G02StartupProfiler::Instance()->EndPhase();
+    }
      
     // OPTION: SPECIFYING THE SCHEMA LOCATION
     //
@@ -223,8 +310,10 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
 
      // G02DetectorConstruction via reading STEP File
      //
+     G02StartupProfiler::Instance()->BeginPhase("construct/STEP read");
      G4LogicalVolume* LogicalVolST
        = fParser.ParseST(fStepFile,fAir,fAluminum);
+     G02StartupProfiler::Instance()->EndPhase();
 
      // Placement inside of the hall
      //
@@ -232,9 +321,57 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
                        "StepPhys", experimentalHallLV, false, 0);
   }
 
+  // Tessellated solids imported that are primitives are replaced by them
+  //
+  if (fRecogniser.IsEnabled())
+  {
+    G02ProfilePhase phase("construct/primitive recognition");
+    std::map<G4VSolid*, G4VSolid*> primitives;
+    fRecogniser.Run(primitives);
+    G4int freed = 0;
+    ReplaceSolids(primitives, freed);
+    fRecogniser.PrintReport();
+  }
+
+  // Optional geometry optimisations, done after the GDML writing so that
+  // the file keeps the original structure: interning of the duplicate
+  // solids and volumes, reflections, then the flattening of the
+  // pass-through containers
+  //
+  if (fInterner.IsEnabled())
+  {
+    G02ProfilePhase phase("construct/interning");
+    fInterner.Run(fWorldPhysVol);
+    fInterner.PrintReport();
+  }
+  if (fOptimiseReflections)
+  {
+    G02ProfilePhase phase("construct/reflections");
+    G02ReflectionOptimiser optimiser;
+    optimiser.Optimise(fWorldPhysVol);
+    optimiser.PrintReport();
+  }
+  if (fFlatten)
+  {
+    G02ProfilePhase phase("construct/flatten");
+    G02GeometryFlattener flattener;
+    flattener.Flatten(fWorldPhysVol);
+    flattener.PrintReport();
+  }
+
+  // Simplified proxies of the tessellated solids, built once the volumes
+  // are final since they keep the volumes using each solid
+  //
+  if (fLevelOfDetail.IsEnabled())
+  {
+    G02ProfilePhase phase("construct/LOD proxies");
+    fLevelOfDetail.Build();
+    fLevelOfDetail.PrintReport();
+  }
+
   // Set Visualization attributes to world
   //
-  G4VisAttributes* BoxVisAtt= new G4VisAttributes(G4Colour(1.0,1.0,1.0));
+  G4VisAttributes* BoxVisAtt= fArena.NewVisAttributes(G4Colour(1.0,1.0,1.0));
   fWorldPhysVol->GetLogicalVolume()->SetVisAttributes(BoxVisAtt);  
 
   return fWorldPhysVol;
@@ -246,6 +383,13 @@ G4VPhysicalVolume* G02DetectorConstruction::Construct()
 //
 void G02DetectorConstruction::ListOfMaterials()
 {
+  // The materials outlive the geometry: they are built once and kept
+  // when the geometry is rebuilt
+  //
+  if (fAir != 0) { return; }
+
+  G02ProfilePhase phase("construct/materials");
+
   G4double a;  // atomic mass
   G4double z;  // atomic number
   G4double density,temperature,pressure;
@@ -266,7 +410,9 @@ void G02DetectorConstruction::ListOfMaterials()
         
   // Print the Element information
   //
-  G4cout << *(G4Element::GetElementTable()) << G4endl;
+  G02StartupProfiler::Instance()->BeginPhase("element table dump");
+  PrintElements(fVerboseLevel);
+  G02StartupProfiler::Instance()->EndPhase();
 
   // Air
   //
@@ -293,7 +439,42 @@ void G02DetectorConstruction::ListOfMaterials()
 
   // Prints the material information
   //
-  G4cout << *(G4Material::GetMaterialTable() ) << G4endl;
+  G02StartupProfiler::Instance()->BeginPhase("material table dump");
+  PrintMaterials(fVerboseLevel);
+  G02StartupProfiler::Instance()->EndPhase();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// Element and material printout. The tables are formatted only when
+// they are going to be printed.
+//
+void G02DetectorConstruction::PrintElements( G4int level ) const
+{
+  if (level >= 2)
+  {
+    G4cout << *(G4Element::GetElementTable()) << G4endl;
+  }
+  else if (level == 1)
+  {
+    G4cout << "G02DetectorConstruction: " << G4Element::GetNumberOfElements()
+           << " elements defined (/mydet/printElements for details)" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02DetectorConstruction::PrintMaterials( G4int level ) const
+{
+  if (level >= 2)
+  {
+    G4cout << *(G4Material::GetMaterialTable() ) << G4endl;
+  }
+  else if (level == 1)
+  {
+    G4cout << "G02DetectorConstruction: " << G4Material::GetNumberOfMaterials()
+           << " materials defined (/mydet/printMaterials for details)" << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -366,7 +547,7 @@ G4VPhysicalVolume* G02DetectorConstruction::ConstructDetector()
   // SubDetector2
   //     
   G4Translate3D translation(-bigL, 0., 0.);
-  G4RotationMatrix* rotD3 = new G4RotationMatrix();
+  G4RotationMatrix* rotD3 = fArena.NewRotation();
   G4Transform3D rotation = G4Rotate3D(*rotD3);
   G4ReflectX3D  reflection;
   G4Transform3D transform = translation*rotation*reflection;
@@ -431,8 +612,8 @@ G4LogicalVolume* G02DetectorConstruction::ConstructSubDetector2()
 
   // Create the hall
   //
-  G4Box * detHallBox =
-    new G4Box("detHallBox", sub_x, sub_y, sub_z);
+  G4VSolid * detHallBox =
+    fInterner.Intern(new G4Box("detHallBox", sub_x, sub_y, sub_z));
   G4LogicalVolume * detHallLV =
     new G4LogicalVolume(detHallBox, fAluminum, "detHallLV");
 
@@ -508,7 +689,7 @@ G4LogicalVolume* G02DetectorConstruction::ConstructAssembly()
   // create Assembly of Boxes and Tubs
   //
   G4AssemblyVolume* assembly = new G4AssemblyVolume();
-  G4RotationMatrix* rot = new G4RotationMatrix();
+  G4RotationMatrix* rot = fArena.NewRotation();
   G4ThreeVector posBig(-bigPlace, 0, 0);
   G4ThreeVector posBig0(bigPlace/4, 0, 0);
   G4ThreeVector posMed(-medPlace, 0, 0);
@@ -532,7 +713,7 @@ G4LogicalVolume* G02DetectorConstruction::ConstructAssembly()
   //   
 
   G4Translate3D translation1(-bigPlace, 0., 0.);
-  G4RotationMatrix* rotD3 = new G4RotationMatrix();
+  G4RotationMatrix* rotD3 = fArena.NewRotation();
   G4Transform3D rotation = G4Rotate3D(*rotD3);
   G4ReflectX3D  reflection;
   G4Transform3D transform1 = translation1*rotation*reflection;
@@ -559,40 +740,43 @@ G4LogicalVolume* G02DetectorConstruction::ConstructParametrisationChamber()
   G4LogicalVolume * paramChamberLV =
     new G4LogicalVolume(paramChamberBox, fAir, "ChamberLV");
 
-  // Parametrisation Chamber (taken from N02 novice example)
+  // Parametrisation Chamber (taken from N02 novice example); the number,
+  // spacing and width of the chambers are set by "/mydet/chambers/"
   //
-  G4int NbOfChambers = 5;
-  G4double ChamberWidth = 2*cm;
-  G4double ChamberSpacing = 8*cm;
-  G4double fTrackerLength = (NbOfChambers+1)*ChamberSpacing; // Full length
-  G4double trackerSize = 0.5*fTrackerLength;
+  G4double fTrackerLength = (fChamberCount+1)*fChamberSpacing; // Full length
+  G4double ChamberSpacing = fChamberSpacing;
+  G4double ChamberWidth = fChamberWidth;
 
-  // An example of parameterised volume
-  // dummy values for G4Box -- modified by parameterised volume
+  // The largest chamber is as long as the tracker: keep both in the box
   //
-  G4Box *solidChamber =
-    new G4Box("chamber", 10*cm, 10*cm, 1*cm); 
-  G4LogicalVolume* logicChamber =
-    new G4LogicalVolume(solidChamber, fAluminum, "Chamber", 0, 0, 0);
-    
-  G4double firstPosition = -trackerSize + 0.5*ChamberWidth;
-  G4double firstLength = fTrackerLength/10;
-  G4double lastLength  = fTrackerLength;
-
-  G4VPVParameterisation* chamberParam =
-    new G02ChamberParameterisation( NbOfChambers,          // NoChambers 
-                                 firstPosition,         // Z of center of first 
-                                 ChamberSpacing,        // Z spacing of centers
-                                 ChamberWidth,          // Width Chamber 
-                                 firstLength,           // lengthInitial 
-                                 lastLength);           // lengthFinal
-  // G4VPhysicalVolume* physiChamber = 
-    new G4PVParameterised( "Chamber",          // their name
-                           logicChamber,       // their logical volume
-                           paramChamberLV,     // mother logical volume      
-                           kZAxis,             // Are placed along this axis 
-                           NbOfChambers,       // Number of chambers
-                           chamberParam);      // The parametrisation
+  if (fTrackerLength > 2.*chamber_z)
+  {
+    G4double scale = 2.*chamber_z/fTrackerLength;
+    ChamberSpacing *= scale;
+    ChamberWidth *= scale;
+    fTrackerLength = 2.*chamber_z;
+
+    G4ExceptionDescription msg;
+    msg << "Stack of " << fChamberCount << " chambers longer than its mother"
+        << " volume; spacing and width scaled by " << scale << " to "
+        << ChamberSpacing/mm << " mm and " << ChamberWidth/mm << " mm.";
+    G4Exception("G02DetectorConstruction::ConstructParametrisationChamber()",
+                "ChamberStackTooLong", JustWarning, msg);
+  }
+
+  G02ChamberStack chamberStack(fChamberCount,        // NoChambers
+                               ChamberSpacing,       // Z spacing of centers
+                               ChamberWidth,         // Width Chamber
+                               fTrackerLength/10,    // lengthInitial
+                               fTrackerLength);      // lengthFinal
+  chamberStack.Place(paramChamberLV, fAluminum, &fArena);
+
+  // Mass of the stack with its mother box, checked by the mass report
+  //
+  fChamberMass = paramChamberBox->GetCubicVolume()*fAir->GetDensity()
+               + chamberStack.GetChambersVolume()
+                 *(fAluminum->GetDensity() - fAir->GetDensity());
+
   return paramChamberLV;
 } 
 
@@ -606,6 +790,230 @@ void G02DetectorConstruction::SetReadFile( const G4String& File )
   fWritingChoice=0;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// SwapGeometry
+//
+void G02DetectorConstruction::SwapGeometry( const G4String& File )
+{
+  // The new geometry is read at once, in place of the current one, and
+  // given to the kernel; the re-initialisation makes the kernel (and the
+  // worker threads) pick it up at the next run, where it is voxelised.
+  // The physics list is not re-initialised.
+  //
+  SetReadFile(File);
+  fSwappedWorld = 0;
+  {
+    G02ProfilePhase phase("geometry swap");
+    fSwappedWorld = Construct();
+  }
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  runManager->DefineWorldVolume(fSwappedWorld);
+  runManager->ReinitializeGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// SelectProxies
+//
+void G02DetectorConstruction::SelectProxies( G4bool val )
+{
+  // Only the master has the messenger: it voxelises the solids selected
+  // at the next run, at the start of which the worker threads give their
+  // own logical volumes the same solids (G02RunAction)
+  //
+  fLevelOfDetail.Select(val);
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  if (runManager != 0) { runManager->GeometryHasBeenModified(); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// MassReport
+//
+G4bool G02DetectorConstruction::MassReport( const G4String& File )
+{
+  // The geometry navigated by the next runs
+  //
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()->GetWorldVolume();
+  if (!fMassReport.Run(world, File)) { return false; }
+
+  // The masses of the built-in chamber stack, parameterised, are known
+  // (unless it was flattened)
+  //
+  G4double mass = fMassReport.GetMass("ChamberLV");
+  if (fChamberMass > 0. && !fFlatten && mass >= 0.)
+  {
+    if (std::fabs(mass - fChamberMass) > 1.e-9*fChamberMass)
+    {
+      G4ExceptionDescription msg;
+      msg << "Mass of the chamber stack " << mass/kg << " kg, expected "
+          << fChamberMass/kg << " kg.";
+      G4Exception("G02DetectorConstruction::MassReport()",
+                  "ChamberMassMismatch", JustWarning, msg);
+    }
+    else
+    {
+      G4cout << "Mass of the chamber stack checked: " << mass/kg << " kg"
+             << G4endl;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// ExportVoxelMap
+//
+G4bool G02DetectorConstruction::ExportVoxelMap( const G4String& File )
+{
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()->GetWorldVolume();
+  return fVoxelMap.Export(world, File);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// ExportMeshes
+//
+G4bool G02DetectorConstruction::ExportMeshes( const G4String& File ) const
+{
+  // The tessellated solids of the logical volumes, stand-ins included
+  //
+  std::vector<const G4TessellatedSolid*> solids;
+  std::set<const G4VSolid*> done;
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < lvStore->size(); ++i)
+  {
+    const G4VSolid* solid = (*lvStore)[i]->GetSolid();
+    if (!done.insert(solid).second) { continue; }
+
+    const G02LazySolid* lazy = dynamic_cast<const G02LazySolid*>(solid);
+    if (lazy != 0) { solid = lazy->GetSolid(); }
+    const G4TessellatedSolid* tessellated
+      = dynamic_cast<const G4TessellatedSolid*>(solid);
+    if (tessellated != 0) { solids.push_back(tessellated); }
+  }
+
+  if (!G02MeshFile::Write(File, solids)) { return false; }
+  G4cout << "G02MeshFile: " << solids.size()
+         << " tessellated solids written to " << File << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// ReplaceSolids
+//
+G4int G02DetectorConstruction::ReplaceSolids(
+  const std::map<G4VSolid*, G4VSolid*>& replacements, G4int& freed )
+{
+  // Replacement in the logical volumes, by copies of them so that the
+  // worker threads see it too
+  //
+  std::map<G4LogicalVolume*, G4VSolid*> swaps;
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < lvStore->size(); ++i)
+  {
+    G4LogicalVolume* lv = (*lvStore)[i];
+    std::map<G4VSolid*, G4VSolid*>::const_iterator it
+      = replacements.find(lv->GetSolid());
+    if (it == replacements.end()) { continue; }
+    swaps[lv] = it->second;
+  }
+  G4int volumes = G4int(G02SolidInterner::SwapSolids(swaps).size());
+
+  // The replaced solids are freed, unless other solids or volumes (with
+  // a skin surface) refer to them
+  //
+  std::set<const G4VSolid*> referenced;
+  G02SolidInterner::CollectConstituents(referenced);
+  for (std::size_t i = 0; i < lvStore->size(); ++i)
+  {
+    referenced.insert((*lvStore)[i]->GetSolid());
+  }
+
+  freed = 0;
+  for (std::map<G4VSolid*, G4VSolid*>::const_iterator it
+         = replacements.begin(); it != replacements.end(); ++it)
+  {
+    if (referenced.count(it->first) == 0)
+    {
+      G4SolidStore::DeRegister(it->first);
+      delete it->first;
+      ++freed;
+    }
+  }
+  return volumes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// MapMeshes
+//
+G4int G02DetectorConstruction::MapMeshes()
+{
+  G02ProfilePhase phase("construct/mesh mapping");
+
+  const G02MeshFile* file = G02MeshFile::Map(fMeshFile);
+  if (file == 0)
+  {
+    G4ExceptionDescription msg;
+    msg << "Mesh file " << fMeshFile << " cannot be mapped;"
+        << " the tessellated solids read are used.";
+    G4Exception("G02DetectorConstruction::MapMeshes()",
+                "MeshFileNotMapped", JustWarning, msg);
+    return 0;
+  }
+
+  // One mapped solid per tessellated solid found in the file
+  //
+  std::map<G4VSolid*, G4VSolid*> mapped;
+  G4int examined = 0, mismatched = 0;
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < lvStore->size(); ++i)
+  {
+    G4VSolid* solid = (*lvStore)[i]->GetSolid();
+    if (dynamic_cast<G4TessellatedSolid*>(solid) == 0
+     && dynamic_cast<G02LazySolid*>(solid) == 0) { continue; }
+    if (mapped.count(solid) != 0) { continue; }
+
+    ++examined;
+    const G02MeshFile::Mesh* mesh = file->Find(solid->GetName());
+    if (mesh == 0) { continue; }
+
+    // A name match alone may be a mesh of another version of the geometry
+    //
+    if (!G02MeshFile::Matches(*mesh, solid))
+    {
+      G4ExceptionDescription msg;
+      msg << "Mesh " << solid->GetName() << " of " << fMeshFile
+          << " differs from the solid read (triangles or bounding box);"
+          << " the solid read is kept.";
+      G4Exception("G02DetectorConstruction::MapMeshes()",
+                  "MeshFileMismatch", JustWarning, msg);
+      ++mismatched;
+      continue;
+    }
+    mapped[solid] = new G02MappedTessellatedSolid(solid->GetName(), mesh);
+  }
+
+  G4int nMapped = G4int(mapped.size()), nFreed = 0;
+  G4int volumes = ReplaceSolids(mapped, nFreed);
+
+  G4cout << "G02MeshFile: " << nMapped << " of " << examined
+         << " tessellated solids mapped from " << fMeshFile << " ("
+         << file->GetSize()/1048576. << " MB shared), " << volumes
+         << " logical volumes updated, " << nFreed << " solids freed";
+  if (mismatched > 0)
+  {
+    G4cout << ", " << mismatched << " meshes not matching the solids";
+  }
+  G4cout << G4endl;
+  return nMapped;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 //
 // SetWriteFile
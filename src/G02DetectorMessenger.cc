@@ -36,9 +36,17 @@
 
 #include "G02DetectorMessenger.hh"
 #include "G02DetectorConstruction.hh"
+#include "G02StartupProfiler.hh"
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWith3Vector.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -47,8 +55,42 @@ G02DetectorMessenger::G02DetectorMessenger( G02DetectorConstruction* myDet )
     fTheDetector( myDet ),
     fTheDetectorDir(0),
     fTheReadCommand(0),
+    fTheSwapCommand(0),
+    fTheLazyCommand(0),
+    fTheExportMeshesCommand(0),
+    fTheMeshFileCommand(0),
     fTheWriteCommand(0),
-    fTheStepCommand(0)
+    fTheStepCommand(0),
+    fTheVerboseCommand(0),
+    fThePrintElementsCommand(0),
+    fThePrintMaterialsCommand(0),
+    fTheFlattenCommand(0),
+    fTheReflectionsCommand(0),
+    fTheInternCommand(0),
+    fTheMassReportCommand(0),
+    fTheMassPointsCommand(0),
+    fTheMassThreadsCommand(0),
+    fTheVoxelMapCommand(0),
+    fTheVoxelBinsCommand(0),
+    fTheVoxelThreadsCommand(0),
+    fTheProfileDir(0),
+    fTheProfileCommand(0),
+    fTheTraceFileCommand(0),
+    fTheTrialVoxelCommand(0),
+    fThePrintProfileCommand(0),
+    fThePrimitivesDir(0),
+    fTheRecogniseCommand(0),
+    fThePrimitiveToleranceCommand(0),
+    fTheLODDir(0),
+    fTheLODBuildCommand(0),
+    fTheLODTargetCommand(0),
+    fTheLODToleranceCommand(0),
+    fTheLODVolumeErrorCommand(0),
+    fTheLODSelectCommand(0),
+    fTheChambersDir(0),
+    fTheChamberNumberCommand(0),
+    fTheChamberSpacingCommand(0),
+    fTheChamberWidthCommand(0)
 { 
   fTheDetectorDir = new G4UIdirectory( "/mydet/" );
   fTheDetectorDir->SetGuidance("Detector control.");
@@ -56,9 +98,38 @@ G02DetectorMessenger::G02DetectorMessenger( G02DetectorConstruction* myDet )
   fTheReadCommand = new G4UIcmdWithAString("/mydet/readFile", this);
   fTheReadCommand ->SetGuidance("READ GDML file with given name");
   fTheReadCommand ->SetParameterName("FileRead", false);
+  fTheReadCommand ->SetGuidance("In the Idle state the current geometry is released and");
+  fTheReadCommand ->SetGuidance("the new one built at the next run or /run/initialize");
   fTheReadCommand ->SetDefaultValue("test.gdml");
-  fTheReadCommand ->AvailableForStates(G4State_PreInit);
+  fTheReadCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
   
+  fTheSwapCommand = new G4UIcmdWithAString("/mydet/swapFile", this);
+  fTheSwapCommand ->SetGuidance("Replace at once the current geometry by the one of a GDML file");
+  fTheSwapCommand ->SetGuidance("The physics tables of the materials unchanged are kept; the");
+  fTheSwapCommand ->SetGuidance("new geometry is voxelised at the next run");
+  fTheSwapCommand ->SetParameterName("FileSwap", false);
+  fTheSwapCommand ->AvailableForStates(G4State_Idle);
+
+  fTheLazyCommand = new G4UIcmdWithABool("/mydet/lazy", this);
+  fTheLazyCommand ->SetGuidance("Read the tessellated solids of the next GDML files as stand-ins,");
+  fTheLazyCommand ->SetGuidance("built when first needed by the navigation");
+  fTheLazyCommand ->SetParameterName("Lazy", true);
+  fTheLazyCommand ->SetDefaultValue(true);
+  fTheLazyCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheExportMeshesCommand = new G4UIcmdWithAString("/mydet/exportMeshes", this);
+  fTheExportMeshesCommand ->SetGuidance("Write the tessellated solids of the geometry to a mesh file,");
+  fTheExportMeshesCommand ->SetGuidance("to be mapped in memory by the jobs using the geometry");
+  fTheExportMeshesCommand ->SetParameterName("MeshFile", false);
+  fTheExportMeshesCommand ->AvailableForStates(G4State_Idle);
+
+  fTheMeshFileCommand = new G4UIcmdWithAString("/mydet/meshFile", this);
+  fTheMeshFileCommand ->SetGuidance("Replace the tessellated solids of the GDML files read next by");
+  fTheMeshFileCommand ->SetGuidance("the meshes of the same name of a mesh file, mapped read-only");
+  fTheMeshFileCommand ->SetGuidance("and shared by the processes (\"none\" to stop)");
+  fTheMeshFileCommand ->SetParameterName("MeshFile", false);
+  fTheMeshFileCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
   fTheWriteCommand = new G4UIcmdWithAString("/mydet/writeFile", this);
   fTheWriteCommand ->SetGuidance("WRITE geometry to GDML file with given name");
   fTheWriteCommand ->SetParameterName("FileWrite", false);
@@ -70,6 +141,195 @@ G02DetectorMessenger::G02DetectorMessenger( G02DetectorConstruction* myDet )
   fTheStepCommand ->SetParameterName("STEPFile", false);
   fTheStepCommand ->SetDefaultValue("mbb");
   fTheStepCommand ->AvailableForStates(G4State_PreInit);
+
+  fTheVerboseCommand = new G4UIcmdWithAnInteger("/mydet/verbose", this);
+  fTheVerboseCommand ->SetGuidance("Printout of element and material tables at construction");
+  fTheVerboseCommand ->SetGuidance("  0 : none");
+  fTheVerboseCommand ->SetGuidance("  1 : one-line summaries");
+  fTheVerboseCommand ->SetGuidance("  2 : full tables (default)");
+  fTheVerboseCommand ->SetParameterName("Level", false);
+  fTheVerboseCommand ->SetRange("Level>=0 && Level<=2");
+
+  fThePrintElementsCommand = new G4UIcmdWithAnInteger("/mydet/printElements", this);
+  fThePrintElementsCommand ->SetGuidance("Print the element table (2) or its summary (1)");
+  fThePrintElementsCommand ->SetParameterName("Level", true);
+  fThePrintElementsCommand ->SetDefaultValue(2);
+  fThePrintElementsCommand ->SetRange("Level>=1 && Level<=2");
+
+  fThePrintMaterialsCommand = new G4UIcmdWithAnInteger("/mydet/printMaterials", this);
+  fThePrintMaterialsCommand ->SetGuidance("Print the material table (2) or its summary (1)");
+  fThePrintMaterialsCommand ->SetParameterName("Level", true);
+  fThePrintMaterialsCommand ->SetDefaultValue(2);
+  fThePrintMaterialsCommand ->SetRange("Level>=1 && Level<=2");
+
+  fTheFlattenCommand = new G4UIcmdWithABool("/mydet/flatten", this);
+  fTheFlattenCommand ->SetGuidance("Collapse the containers made of the material of their mother");
+  fTheFlattenCommand ->SetGuidance("after construction or GDML reading, to reduce the depth");
+  fTheFlattenCommand ->SetParameterName("Flatten", true);
+  fTheFlattenCommand ->SetDefaultValue(true);
+  fTheFlattenCommand ->AvailableForStates(G4State_PreInit);
+
+  fTheReflectionsCommand = new G4UIcmdWithABool("/mydet/optimiseReflections", this);
+  fTheReflectionsCommand ->SetGuidance("Replace the reflections of symmetric solids by rotated");
+  fTheReflectionsCommand ->SetGuidance("placements, and share the other reflected solids");
+  fTheReflectionsCommand ->SetParameterName("Optimise", true);
+  fTheReflectionsCommand ->SetDefaultValue(true);
+  fTheReflectionsCommand ->AvailableForStates(G4State_PreInit);
+
+  fTheInternCommand = new G4UIcmdWithABool("/mydet/intern", this);
+  fTheInternCommand ->SetGuidance("Share identical solids and logical volumes, at creation");
+  fTheInternCommand ->SetGuidance("and after construction or GDML reading");
+  fTheInternCommand ->SetParameterName("Intern", true);
+  fTheInternCommand ->SetDefaultValue(true);
+  fTheInternCommand ->AvailableForStates(G4State_PreInit);
+
+  fTheMassReportCommand = new G4UIcmdWithAString("/mydet/massReport", this);
+  fTheMassReportCommand ->SetGuidance("Print the cubic volume and mass of every logical volume of the");
+  fTheMassReportCommand ->SetGuidance("geometry, and write them to a CSV file if a name is given");
+  fTheMassReportCommand ->SetParameterName("ReportFile", true);
+  fTheMassReportCommand ->SetDefaultValue("");
+  fTheMassReportCommand ->SetToBeBroadcasted(false);
+  fTheMassReportCommand ->AvailableForStates(G4State_Idle);
+
+  fTheMassPointsCommand = new G4UIcmdWithAnInteger("/mydet/massPoints", this);
+  fTheMassPointsCommand ->SetGuidance("Points of the Monte Carlo estimates of the volumes of the");
+  fTheMassPointsCommand ->SetGuidance("solids without exact method (Boolean solids, ...)");
+  fTheMassPointsCommand ->SetParameterName("N", false);
+  fTheMassPointsCommand ->SetRange("N>0");
+  fTheMassPointsCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheMassThreadsCommand = new G4UIcmdWithAnInteger("/mydet/massThreads", this);
+  fTheMassThreadsCommand ->SetGuidance("Threads computing the volumes of the mass report");
+  fTheMassThreadsCommand ->SetGuidance("(0 for the number of cores)");
+  fTheMassThreadsCommand ->SetParameterName("N", false);
+  fTheMassThreadsCommand ->SetRange("N>=0");
+  fTheMassThreadsCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheVoxelMapCommand = new G4UIcmdWithAString("/mydet/exportVoxelMap", this);
+  fTheVoxelMapCommand ->SetGuidance("Write the materials of the geometry on a regular grid of");
+  fTheVoxelMapCommand ->SetGuidance("its bounding box to a binary file, to be mapped in memory");
+  fTheVoxelMapCommand ->SetParameterName("VoxelFile", false);
+  fTheVoxelMapCommand ->SetToBeBroadcasted(false);
+  fTheVoxelMapCommand ->AvailableForStates(G4State_Idle);
+
+  fTheVoxelBinsCommand = new G4UIcmdWith3Vector("/mydet/voxelBins", this);
+  fTheVoxelBinsCommand ->SetGuidance("Voxels of the map along x, y and z");
+  fTheVoxelBinsCommand ->SetParameterName("Nx", "Ny", "Nz", false);
+  fTheVoxelBinsCommand ->SetRange("Nx>=1 && Ny>=1 && Nz>=1");
+  fTheVoxelBinsCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheVoxelThreadsCommand = new G4UIcmdWithAnInteger("/mydet/voxelThreads", this);
+  fTheVoxelThreadsCommand ->SetGuidance("Threads walking the voxels of the map (0 for the number");
+  fTheVoxelThreadsCommand ->SetGuidance("of cores)");
+  fTheVoxelThreadsCommand ->SetParameterName("N", false);
+  fTheVoxelThreadsCommand ->SetRange("N>=0");
+  fTheVoxelThreadsCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheProfileDir = new G4UIdirectory( "/mydet/profile/" );
+  fTheProfileDir->SetGuidance("Start-up profiling.");
+
+  fTheProfileCommand = new G4UIcmdWithABool("/mydet/profile/enable", this);
+  fTheProfileCommand ->SetGuidance("Print the start-up profile at the end of the job");
+  fTheProfileCommand ->SetParameterName("Enable", true);
+  fTheProfileCommand ->SetDefaultValue(true);
+
+  fTheTraceFileCommand = new G4UIcmdWithAString("/mydet/profile/traceFile", this);
+  fTheTraceFileCommand ->SetGuidance("Write the start-up profile in Chrome trace");
+  fTheTraceFileCommand ->SetGuidance("JSON format to the given file at the end of the job");
+  fTheTraceFileCommand ->SetParameterName("TraceFile", false);
+
+  fTheTrialVoxelCommand = new G4UIcmdWithABool("/mydet/profile/trialVoxelisation", this);
+  fTheTrialVoxelCommand ->SetGuidance("Voxelise the geometry once more at the end of");
+  fTheTrialVoxelCommand ->SetGuidance("/run/initialize, to time it apart from the");
+  fTheTrialVoxelCommand ->SetGuidance("physics tables building done at the first run");
+  fTheTrialVoxelCommand ->SetParameterName("Trial", true);
+  fTheTrialVoxelCommand ->SetDefaultValue(true);
+  fTheTrialVoxelCommand ->AvailableForStates(G4State_PreInit);
+
+  fThePrintProfileCommand = new G4UIcmdWithoutParameter("/mydet/profile/print", this);
+  fThePrintProfileCommand ->SetGuidance("Print the start-up profile collected so far");
+
+  fThePrimitivesDir = new G4UIdirectory( "/mydet/primitives/" );
+  fThePrimitivesDir->SetGuidance("Recognition of the tessellated primitives.");
+
+  fTheRecogniseCommand = new G4UIcmdWithABool("/mydet/primitives/recognise", this);
+  fTheRecogniseCommand ->SetGuidance("Replace the tessellated solids of the GDML and STEP files read");
+  fTheRecogniseCommand ->SetGuidance("next that tessellate a box, sphere, tube or cone by the primitive");
+  fTheRecogniseCommand ->SetParameterName("Recognise", true);
+  fTheRecogniseCommand ->SetDefaultValue(true);
+  fTheRecogniseCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fThePrimitiveToleranceCommand = new G4UIcmdWithADoubleAndUnit("/mydet/primitives/tolerance", this);
+  fThePrimitiveToleranceCommand ->SetGuidance("Largest distance of the vertices and facet centres to the");
+  fThePrimitiveToleranceCommand ->SetGuidance("primitive surface (default 0.2 mm)");
+  fThePrimitiveToleranceCommand ->SetParameterName("Tolerance", false);
+  fThePrimitiveToleranceCommand ->SetRange("Tolerance>0.");
+  fThePrimitiveToleranceCommand ->SetDefaultUnit("mm");
+  fThePrimitiveToleranceCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheLODDir = new G4UIdirectory( "/mydet/lod/" );
+  fTheLODDir->SetGuidance("Simplified proxies of the tessellated solids.");
+
+  fTheLODBuildCommand = new G4UIcmdWithABool("/mydet/lod/build", this);
+  fTheLODBuildCommand ->SetGuidance("Build simplified proxies of the tessellated solids of the");
+  fTheLODBuildCommand ->SetGuidance("GDML and STEP files read next");
+  fTheLODBuildCommand ->SetParameterName("Build", true);
+  fTheLODBuildCommand ->SetDefaultValue(true);
+  fTheLODBuildCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheLODTargetCommand = new G4UIcmdWithAnInteger("/mydet/lod/targetFacets", this);
+  fTheLODTargetCommand ->SetGuidance("Number of facets of the proxies (0: no target, default)");
+  fTheLODTargetCommand ->SetParameterName("N", false);
+  fTheLODTargetCommand ->SetRange("N>=0");
+  fTheLODTargetCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheLODToleranceCommand = new G4UIcmdWithADoubleAndUnit("/mydet/lod/tolerance", this);
+  fTheLODToleranceCommand ->SetGuidance("Bound of the distance of the proxy vertices to the planes");
+  fTheLODToleranceCommand ->SetGuidance("of the original facets (0: no bound; default 0.1 mm)");
+  fTheLODToleranceCommand ->SetParameterName("Tolerance", false);
+  fTheLODToleranceCommand ->SetRange("Tolerance>=0.");
+  fTheLODToleranceCommand ->SetDefaultUnit("mm");
+  fTheLODToleranceCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheLODVolumeErrorCommand = new G4UIcmdWithADouble("/mydet/lod/maxVolumeError", this);
+  fTheLODVolumeErrorCommand ->SetGuidance("Relative volume change above which a proxy is rejected");
+  fTheLODVolumeErrorCommand ->SetGuidance("(default 0.01)");
+  fTheLODVolumeErrorCommand ->SetParameterName("Error", false);
+  fTheLODVolumeErrorCommand ->SetRange("Error>=0.");
+  fTheLODVolumeErrorCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheLODSelectCommand = new G4UIcmdWithAString("/mydet/lod/select", this);
+  fTheLODSelectCommand ->SetGuidance("Navigate the full tessellated solids or their proxies");
+  fTheLODSelectCommand ->SetGuidance("from the next run on");
+  fTheLODSelectCommand ->SetParameterName("Level", false);
+  fTheLODSelectCommand ->SetCandidates("full proxy");
+  fTheLODSelectCommand ->SetToBeBroadcasted(false);
+  fTheLODSelectCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheChambersDir = new G4UIdirectory( "/mydet/chambers/" );
+  fTheChambersDir->SetGuidance("Parameterised chamber stack of the built-in geometry.");
+
+  fTheChamberNumberCommand = new G4UIcmdWithAnInteger("/mydet/chambers/number", this);
+  fTheChamberNumberCommand ->SetGuidance("Number of chambers in the stack (default 5)");
+  fTheChamberNumberCommand ->SetGuidance("Above 1000 they are grouped in blocks of sqrt(N)");
+  fTheChamberNumberCommand ->SetParameterName("N", false);
+  fTheChamberNumberCommand ->SetRange("N>0");
+  fTheChamberNumberCommand ->AvailableForStates(G4State_PreInit);
+
+  fTheChamberSpacingCommand = new G4UIcmdWithADoubleAndUnit("/mydet/chambers/spacing", this);
+  fTheChamberSpacingCommand ->SetGuidance("Distance between the chamber centres (default 8 cm)");
+  fTheChamberSpacingCommand ->SetParameterName("Spacing", false);
+  fTheChamberSpacingCommand ->SetRange("Spacing>0.");
+  fTheChamberSpacingCommand ->SetDefaultUnit("cm");
+  fTheChamberSpacingCommand ->AvailableForStates(G4State_PreInit);
+
+  fTheChamberWidthCommand = new G4UIcmdWithADoubleAndUnit("/mydet/chambers/width", this);
+  fTheChamberWidthCommand ->SetGuidance("Width of the chambers along Z (default 2 cm)");
+  fTheChamberWidthCommand ->SetGuidance("It must not exceed the spacing");
+  fTheChamberWidthCommand ->SetParameterName("Width", false);
+  fTheChamberWidthCommand ->SetRange("Width>0.");
+  fTheChamberWidthCommand ->SetDefaultUnit("cm");
+  fTheChamberWidthCommand ->AvailableForStates(G4State_PreInit);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -77,8 +337,42 @@ G02DetectorMessenger::G02DetectorMessenger( G02DetectorConstruction* myDet )
 G02DetectorMessenger::~G02DetectorMessenger()
 {
   delete fTheReadCommand;
+  delete fTheSwapCommand;
+  delete fTheLazyCommand;
+  delete fTheExportMeshesCommand;
+  delete fTheMeshFileCommand;
   delete fTheWriteCommand;
   delete fTheStepCommand;
+  delete fTheVerboseCommand;
+  delete fThePrintElementsCommand;
+  delete fThePrintMaterialsCommand;
+  delete fTheFlattenCommand;
+  delete fTheReflectionsCommand;
+  delete fTheInternCommand;
+  delete fTheMassReportCommand;
+  delete fTheMassPointsCommand;
+  delete fTheMassThreadsCommand;
+  delete fTheVoxelMapCommand;
+  delete fTheVoxelBinsCommand;
+  delete fTheVoxelThreadsCommand;
+  delete fTheProfileCommand;
+  delete fTheTraceFileCommand;
+  delete fTheTrialVoxelCommand;
+  delete fThePrintProfileCommand;
+  delete fTheProfileDir;
+  delete fTheRecogniseCommand;
+  delete fThePrimitiveToleranceCommand;
+  delete fThePrimitivesDir;
+  delete fTheLODBuildCommand;
+  delete fTheLODTargetCommand;
+  delete fTheLODToleranceCommand;
+  delete fTheLODVolumeErrorCommand;
+  delete fTheLODSelectCommand;
+  delete fTheLODDir;
+  delete fTheChamberNumberCommand;
+  delete fTheChamberSpacingCommand;
+  delete fTheChamberWidthCommand;
+  delete fTheChambersDir;
   delete fTheDetectorDir;
 }
 
@@ -89,6 +383,28 @@ void G02DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
   if ( command == fTheReadCommand )
   { 
     fTheDetector->SetReadFile(newValue );
+    if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_Idle)
+    {
+      // The detector construction releases the previous geometry itself
+      //
+      G4RunManager::GetRunManager()->ReinitializeGeometry();
+    }
+  }
+  if ( command == fTheSwapCommand )
+  { 
+    fTheDetector->SwapGeometry(newValue);
+  }
+  if ( command == fTheLazyCommand )
+  { 
+    fTheDetector->SetLazy(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fTheExportMeshesCommand )
+  { 
+    fTheDetector->ExportMeshes(newValue);
+  }
+  if ( command == fTheMeshFileCommand )
+  { 
+    fTheDetector->SetMeshFile(newValue == "none" ? G4String() : newValue);
   }
   if ( command == fTheWriteCommand )
   { 
@@ -98,4 +414,123 @@ void G02DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
   { 
     fTheDetector->SetStepFile(newValue );
   }
+  if ( command == fTheVerboseCommand )
+  { 
+    fTheDetector->SetVerboseLevel(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  if ( command == fThePrintElementsCommand )
+  { 
+    fTheDetector->PrintElements(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  if ( command == fThePrintMaterialsCommand )
+  { 
+    fTheDetector->PrintMaterials(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  if ( command == fTheFlattenCommand )
+  { 
+    fTheDetector->SetFlatten(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fTheReflectionsCommand )
+  { 
+    fTheDetector->SetOptimiseReflections(
+      G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fTheInternCommand )
+  { 
+    fTheDetector->SetIntern(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fTheMassReportCommand )
+  { 
+    fTheDetector->MassReport(newValue);
+  }
+  if ( command == fTheMassPointsCommand )
+  { 
+    fTheDetector->SetMassPoints(
+      fTheMassPointsCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fTheMassThreadsCommand )
+  { 
+    fTheDetector->SetMassThreads(
+      fTheMassThreadsCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fTheVoxelMapCommand )
+  { 
+    fTheDetector->ExportVoxelMap(newValue);
+  }
+  if ( command == fTheVoxelBinsCommand )
+  { 
+    G4ThreeVector bins = fTheVoxelBinsCommand->GetNew3VectorValue(newValue);
+    fTheDetector->SetVoxelBins(G4int(bins.x()), G4int(bins.y()),
+                               G4int(bins.z()));
+  }
+  if ( command == fTheVoxelThreadsCommand )
+  { 
+    fTheDetector->SetVoxelThreads(
+      fTheVoxelThreadsCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fTheProfileCommand )
+  { 
+    G02StartupProfiler::Instance()
+      ->SetEnabled(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fTheTraceFileCommand )
+  { 
+    G02StartupProfiler::Instance()->SetTraceFile(newValue);
+  }
+  if ( command == fTheTrialVoxelCommand )
+  { 
+    G02StartupProfiler::Instance()
+      ->SetTrialVoxelisation(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fThePrintProfileCommand )
+  { 
+    G02StartupProfiler::Instance()->Print();
+  }
+  if ( command == fTheRecogniseCommand )
+  { 
+    fTheDetector->SetRecognisePrimitives(
+      G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fThePrimitiveToleranceCommand )
+  { 
+    fTheDetector->SetPrimitiveTolerance(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  if ( command == fTheLODBuildCommand )
+  { 
+    fTheDetector->SetLevelOfDetail(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  if ( command == fTheLODTargetCommand )
+  { 
+    fTheDetector->SetLODTargetFacets(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  if ( command == fTheLODToleranceCommand )
+  { 
+    fTheDetector->SetLODTolerance(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  if ( command == fTheLODVolumeErrorCommand )
+  { 
+    fTheDetector->SetLODMaxVolumeError(
+      G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+  }
+  if ( command == fTheLODSelectCommand )
+  { 
+    fTheDetector->SelectProxies(newValue == "proxy");
+  }
+  if ( command == fTheChamberNumberCommand )
+  { 
+    fTheDetector->SetChamberCount(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  if ( command == fTheChamberSpacingCommand )
+  { 
+    fTheDetector->SetChamberSpacing(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  if ( command == fTheChamberWidthCommand )
+  { 
+    fTheDetector->SetChamberWidth(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
 }
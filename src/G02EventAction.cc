@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02EventAction.cc
+/// \brief Implementation of the G02EventAction class
+//
+//
+//
+// Class G02EventAction implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02EventAction.hh"
+#include "G02Run.hh"
+#include "G02ResourceUsage.hh"
+
+#include "G4RunManager.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02EventAction::G02EventAction()
+  : G4UserEventAction(),
+    fStartTime(0.)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02EventAction::~G02EventAction()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02EventAction::BeginOfEventAction(const G4Event*)
+{
+  fStartTime = G02ResourceUsage::WallTime();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02EventAction::EndOfEventAction(const G4Event*)
+{
+  G02Run* run = static_cast<G02Run*>(
+    G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->AddEventTime(G02ResourceUsage::WallTime() - fStartTime);
+}
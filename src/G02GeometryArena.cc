@@ -0,0 +1,146 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02GeometryArena.cc
+/// \brief Implementation of the G02GeometryArena class
+//
+//
+//
+// Class G02GeometryArena implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02GeometryArena.hh"
+
+#include "G4Colour.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4GeometryManager.hh"
+#include "G4AssemblyStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SolidStore.hh"
+#include "G4ReflectionFactory.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4LogicalBorderSurface.hh"
+#include "G4SurfaceProperty.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02GeometryArena::G02GeometryArena()
+  : fInUse(false)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02GeometryArena::~G02GeometryArena()
+{
+  // The stores are cleaned by the kernel at the end of the job; only the
+  // objects of the arena itself are freed here
+  //
+  for (std::size_t i = 0; i < fParameterisations.size(); ++i)
+  {
+    delete fParameterisations[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RotationMatrix* G02GeometryArena::NewRotation()
+{
+  fInUse = true;
+  fRotations.push_back(G4RotationMatrix());
+  return &fRotations.back();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RotationMatrix*
+G02GeometryArena::NewRotation(const G4RotationMatrix& rotation)
+{
+  fInUse = true;
+  fRotations.push_back(rotation);
+  return &fRotations.back();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VisAttributes* G02GeometryArena::NewVisAttributes(const G4Colour& colour)
+{
+  fInUse = true;
+  fVisAttributes.push_back(G4VisAttributes(colour));
+  return &fVisAttributes.back();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VPVParameterisation*
+G02GeometryArena::Adopt(G4VPVParameterisation* parameterisation)
+{
+  fInUse = true;
+  fParameterisations.push_back(parameterisation);
+  return parameterisation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometryArena::Release()
+{
+  // The voxel headers are deleted by opening the geometry
+  //
+  G4GeometryManager* geomManager = G4GeometryManager::GetInstance();
+  if (geomManager->IsGeometryClosed()) { geomManager->OpenGeometry(); }
+
+  // The assemblies delete their imprinted placements, which then leave the
+  // physical volume store: clean them before the volumes
+  //
+  G4AssemblyStore::GetInstance()->Clean();
+  G4PhysicalVolumeStore::GetInstance()->Clean();
+  G4LogicalVolumeStore::GetInstance()->Clean();
+  G4SolidStore::GetInstance()->Clean();
+  G4ReflectionFactory::Instance()->Clean();
+
+  // The optical surfaces refer to the volumes deleted above, and are read
+  // again with them, as in G4RunManager::ReinitializeGeometry()
+  //
+  G4LogicalSkinSurface::CleanSurfaceTable();
+  G4LogicalBorderSurface::CleanSurfaceTable();
+  G4SurfaceProperty::CleanSurfacePropertyTable();
+
+  for (std::size_t i = 0; i < fParameterisations.size(); ++i)
+  {
+    delete fParameterisations[i];
+  }
+  fParameterisations.clear();
+
+  // Swapping with empty containers gives the blocks back
+  //
+  std::deque<G4RotationMatrix>().swap(fRotations);
+  std::deque<G4VisAttributes>().swap(fVisAttributes);
+
+  fInUse = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,285 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02GeometryFlattener.cc
+/// \brief Implementation of the G02GeometryFlattener class
+//
+//
+//
+// Class G02GeometryFlattener implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02GeometryFlattener.hh"
+#include "G02ResourceUsage.hh"
+
+#include "G4ios.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4VSolid.hh"
+#include "G4Transform3D.hh"
+#include "G4Point3D.hh"
+#include "G4GeometryTolerance.hh"
+
+#include <iomanip>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // Levels and expanded volumes below (and including) a logical volume
+  //
+  typedef std::map<const G4LogicalVolume*, std::pair<G4int,G4double> > TreeMap;
+
+  const std::pair<G4int,G4double>& Expand(const G4LogicalVolume* lv,
+                                          TreeMap& cache)
+  {
+    TreeMap::iterator it = cache.find(lv);
+    if (it != cache.end()) { return it->second; }
+
+    G4int depth = 0;
+    G4double expanded = 0.;
+    for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+    {
+      const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+      const std::pair<G4int,G4double>& sub =
+        Expand(daughter->GetLogicalVolume(), cache);
+      depth = std::max(depth, sub.first);
+      expanded += daughter->GetMultiplicity() * sub.second;
+    }
+    return cache[lv] = std::make_pair(depth+1, expanded+1.);
+  }
+
+  // Solids whose convexity makes the containment of the corners of a
+  // bounding box sufficient for the containment of the box
+  //
+  G4bool IsConvex(const G4VSolid* solid)
+  {
+    G4String type = solid->GetEntityType();
+    return type == "G4Box" || type == "G4Trd" || type == "G4Trap"
+        || type == "G4Para" || type == "G4Orb";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02GeometryFlattener::G02GeometryFlattener()
+  : fCollapsed(0), fLifted(0), fRejected(0), fTime(0.)
+{
+  fBefore.fMaxDepth = fAfter.fMaxDepth = 0;
+  fBefore.fLogicalVolumes = fAfter.fLogicalVolumes = 0;
+  fBefore.fPlacements = fAfter.fPlacements = 0;
+  fBefore.fExpanded = fAfter.fExpanded = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02GeometryFlattener::~G02GeometryFlattener()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02GeometryFlattener::Summary
+G02GeometryFlattener::Summarise(const G4VPhysicalVolume* world)
+{
+  TreeMap cache;
+  const std::pair<G4int,G4double>& top =
+    Expand(world->GetLogicalVolume(), cache);
+
+  Summary summary;
+  summary.fMaxDepth = top.first;
+  summary.fExpanded = top.second;
+  summary.fLogicalVolumes = G4int(cache.size());
+  summary.fPlacements = 1;
+  for (TreeMap::const_iterator it = cache.begin(); it != cache.end(); ++it)
+  {
+    summary.fPlacements += G4int(it->first->GetNoDaughters());
+  }
+  return summary;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02GeometryFlattener::
+IsPassThrough(const G4VPhysicalVolume* container,
+              const G4LogicalVolume* mother) const
+{
+  if (container->IsReplicated()) { return false; }
+
+  const G4LogicalVolume* lv = container->GetLogicalVolume();
+  return lv->GetMaterial() == mother->GetMaterial()
+      && lv->GetFieldManager() == mother->GetFieldManager()
+      && lv->GetSensitiveDetector() == 0
+      && lv->GetUserLimits() == 0
+      && !lv->IsRootRegion();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02GeometryFlattener::
+HasDaughtersInside(const G4VPhysicalVolume* container) const
+{
+  const G4LogicalVolume* lv = container->GetLogicalVolume();
+  const G4VSolid* solid = lv->GetSolid();
+  if (!IsConvex(solid)) { return false; }
+
+  const G4double tolerance =
+    G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+  {
+    const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+    if (daughter->IsReplicated()) { return false; }
+
+    G4ThreeVector pMin, pMax;
+    daughter->GetLogicalVolume()->GetSolid()->BoundingLimits(pMin, pMax);
+    pMin -= G4ThreeVector(tolerance, tolerance, tolerance);
+    pMax += G4ThreeVector(tolerance, tolerance, tolerance);
+
+    G4Transform3D toContainer(daughter->GetObjectRotationValue(),
+                              daughter->GetObjectTranslation());
+    for (G4int corner = 0; corner < 8; ++corner)
+    {
+      G4Point3D local((corner & 1) ? pMax.x() : pMin.x(),
+                      (corner & 2) ? pMax.y() : pMin.y(),
+                      (corner & 4) ? pMax.z() : pMin.z());
+      G4Point3D point = toContainer * local;
+      if (solid->Inside(G4ThreeVector(point.x(), point.y(), point.z()))
+          == kOutside)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometryFlattener::Collapse(G4VPhysicalVolume* container,
+                                    G4LogicalVolume* mother)
+{
+  G4Transform3D toMother(container->GetObjectRotationValue(),
+                         container->GetObjectTranslation());
+
+  const G4LogicalVolume* lv = container->GetLogicalVolume();
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+  {
+    const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+    G4Transform3D toContainer(daughter->GetObjectRotationValue(),
+                              daughter->GetObjectTranslation());
+    new G4PVPlacement(toMother*toContainer, daughter->GetLogicalVolume(),
+                      daughter->GetName(), mother, daughter->IsMany(),
+                      daughter->GetCopyNo(), false);
+    ++fLifted;
+  }
+
+  mother->RemoveDaughter(container);
+  container->SetMotherLogical(0);
+  ++fCollapsed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02GeometryFlattener::Flatten(G4VPhysicalVolume* world)
+{
+  G4double startTime = G02ResourceUsage::WallTime();
+
+  fBefore = Summarise(world);
+  fCollapsed = fLifted = fRejected = 0;
+
+  // Each logical volume is processed once, whatever its number of
+  // placements: its daughters are the same in all of them
+  //
+  std::set<const G4LogicalVolume*> visited;
+  std::vector<G4LogicalVolume*> pending(1, world->GetLogicalVolume());
+  visited.insert(pending.back());
+  while (!pending.empty())
+  {
+    G4LogicalVolume* mother = pending.back();
+    pending.pop_back();
+
+    // Lifted daughters are appended to the mother and examined in turn,
+    // so that nested containers are collapsed level after level
+    //
+    for (std::size_t i = 0; i < mother->GetNoDaughters(); )
+    {
+      G4VPhysicalVolume* daughter = mother->GetDaughter(i);
+      if (IsPassThrough(daughter, mother))
+      {
+        if (HasDaughtersInside(daughter))
+        {
+          Collapse(daughter, mother);
+          continue;
+        }
+        ++fRejected;
+      }
+      ++i;
+    }
+
+    for (std::size_t i = 0; i < mother->GetNoDaughters(); ++i)
+    {
+      G4LogicalVolume* lv = mother->GetDaughter(i)->GetLogicalVolume();
+      if (visited.insert(lv).second) { pending.push_back(lv); }
+    }
+  }
+
+  fAfter = Summarise(world);
+  fTime = G02ResourceUsage::WallTime() - startTime;
+
+  return fCollapsed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometryFlattener::PrintReport() const
+{
+  G4cout << G4endl
+         << "Geometry flattening: " << fCollapsed << " containers collapsed, "
+         << fLifted << " placements lifted, " << fRejected
+         << " kept for their shape, in " << fTime << " s" << G4endl
+         << std::setw(24) << std::left << " " << std::right
+         << std::setw(12) << "before" << std::setw(12) << "after" << G4endl
+         << std::setw(24) << std::left << "   maximum depth" << std::right
+         << std::setw(12) << fBefore.fMaxDepth
+         << std::setw(12) << fAfter.fMaxDepth << G4endl
+         << std::setw(24) << std::left << "   logical volumes" << std::right
+         << std::setw(12) << fBefore.fLogicalVolumes
+         << std::setw(12) << fAfter.fLogicalVolumes << G4endl
+         << std::setw(24) << std::left << "   physical volumes" << std::right
+         << std::setw(12) << fBefore.fPlacements
+         << std::setw(12) << fAfter.fPlacements << G4endl
+         << std::setw(24) << std::left << "   expanded volumes" << std::right
+         << std::setw(12) << fBefore.fExpanded
+         << std::setw(12) << fAfter.fExpanded << G4endl << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,636 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02GeometrySummary.cc
+/// \brief Implementation of the G02GeometrySummary class
+//
+//
+//
+// Class G02GeometrySummary implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02GeometrySummary.hh"
+#include "G02MassReport.hh"
+#include "G02SolidInterner.hh"
+#include "G02LazySolid.hh"
+
+#include "G4VSolid.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4Material.hh"
+#include "G4RotationMatrix.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  const char* const kHeader = "G02GeometrySummary 1";
+
+  G4bool Differs(G4double a, G4double b, G4double absolute, G4double relative)
+  {
+    return std::fabs(a-b)
+         > absolute + relative*std::max(std::fabs(a), std::fabs(b));
+  }
+
+  std::vector<std::string> Split(const std::string& line)
+  {
+    std::vector<std::string> fields;
+    std::size_t begin = 0;
+    for (;;)
+    {
+      std::size_t end = line.find('\t', begin);
+      fields.push_back(line.substr(begin, end-begin));
+      if (end == std::string::npos) { break; }
+      begin = end+1;
+    }
+    return fields;
+  }
+
+  G4bool ToDouble(const std::string& field, G4double& value)
+  {
+    std::istringstream in(field);
+    in >> value;
+    return !in.fail();
+  }
+
+  std::string Numbers(const G4double* values, std::size_t n)
+  {
+    std::ostringstream out;
+    out << '(';
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      out << (i ? ", " : "") << values[i];
+    }
+    out << ')';
+    return out.str();
+  }
+
+  std::string Change(G4double before, G4double after, G4double unit,
+                     const char* unitName)
+  {
+    std::ostringstream out;
+    out << before/unit << ' ' << unitName << " -> "
+        << after/unit << ' ' << unitName;
+    if (before != 0.)
+    {
+      out.setf(std::ios::showpos);
+      out << " (" << 100.*(after-before)/std::fabs(before) << "%)";
+    }
+    return out.str();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02GeometrySummary::G02GeometrySummary()
+  : fComputeMasses(true), fHasMasses(false)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02GeometrySummary::~G02GeometrySummary()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string G02GeometrySummary::StripPointer(const std::string& name)
+{
+  std::size_t pos = name.find("0x");
+  if (pos == std::string::npos || pos+2 == name.size()) { return name; }
+  for (std::size_t i = pos+2; i < name.size(); ++i)
+  {
+    if (!std::isxdigit((unsigned char)name[i])) { return name; }
+  }
+  return name.substr(0, pos);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometrySummary::Clear()
+{
+  fVolumes.clear();
+  fPlacements.clear();
+  fKeys.clear();
+  fMasses.clear();
+  fHasMasses = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometrySummary::Build(const G4VPhysicalVolume* world,
+                               G4bool computeMasses)
+{
+  Clear();
+  fComputeMasses = computeMasses;
+  fHasMasses = computeMasses;
+  if (world == 0) { return; }
+
+  // The world is keyed "/", whatever its name
+  //
+  Visit(world->GetLogicalVolume(), "/");
+
+  // The store pointers are not needed any more
+  //
+  fKeys.clear();
+  fMasses.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometrySummary::Visit(const G4LogicalVolume* lv,
+                               const std::string& key)
+{
+  fKeys[lv] = key;
+
+  Volume volume;
+  volume.fKey = key;
+  volume.fName = StripPointer(lv->GetName());
+  Describe(lv->GetSolid(), volume);
+  const G4Material* material = lv->GetMaterial();
+  volume.fMaterial = material ? StripPointer(material->GetName()) : "";
+  volume.fDensity = material ? material->GetDensity() : 0.;
+  volume.fSelfMass = 0.;
+  volume.fMass = 0.;
+  if (fComputeMasses)
+  {
+    const Mass& mass = ComputeMass(lv);
+    volume.fSelfMass = mass.fSelf;
+    volume.fMass = mass.fTotal;
+  }
+  fVolumes.push_back(volume);
+
+  // Daughters with the same name and copy number are told apart by their
+  // rank among them
+  //
+  std::map<std::string, G4int> seen;
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+  {
+    const G4VPhysicalVolume* pv = lv->GetDaughter(i);
+    std::ostringstream name;
+    name << (key == "/" ? "" : key) << '/' << StripPointer(pv->GetName()) << '#' << pv->GetCopyNo();
+    G4int rank = seen[name.str()]++;
+    if (rank > 0) { name << ':' << rank; }
+
+    Placement placement;
+    placement.fKey = name.str();
+    placement.fMotherKey = key;
+    placement.fMultiplicity = pv->GetMultiplicity();
+    for (G4int k = 0; k < 12; ++k) { placement.fTransform[k] = 0.; }
+
+    if (pv->IsParameterised())
+    {
+      // The transforms are computed by the parameterisation
+      //
+      placement.fKind = "parameterised";
+    }
+    else if (pv->IsReplicated())
+    {
+      // Axis, width and offset of the replication
+      //
+      EAxis axis;
+      G4int nReplicas;
+      G4double width, offset;
+      G4bool consuming;
+      pv->GetReplicationData(axis, nReplicas, width, offset, consuming);
+      placement.fKind = "replica";
+      placement.fTransform[0] = G4double(axis);
+      placement.fTransform[1] = width;
+      placement.fTransform[2] = offset;
+    }
+    else
+    {
+      placement.fKind = "placement";
+      G4ThreeVector translation = pv->GetObjectTranslation();
+      G4RotationMatrix rotation = pv->GetObjectRotationValue();
+      placement.fTransform[0] = translation.x();
+      placement.fTransform[1] = translation.y();
+      placement.fTransform[2] = translation.z();
+      placement.fTransform[3] = rotation.xx();
+      placement.fTransform[4] = rotation.xy();
+      placement.fTransform[5] = rotation.xz();
+      placement.fTransform[6] = rotation.yx();
+      placement.fTransform[7] = rotation.yy();
+      placement.fTransform[8] = rotation.yz();
+      placement.fTransform[9] = rotation.zx();
+      placement.fTransform[10] = rotation.zy();
+      placement.fTransform[11] = rotation.zz();
+    }
+
+    const G4LogicalVolume* daughter = pv->GetLogicalVolume();
+    std::map<const G4LogicalVolume*, std::string>::const_iterator found =
+      fKeys.find(daughter);
+    placement.fVolumeKey =
+      (found != fKeys.end()) ? found->second : placement.fKey;
+    fPlacements.push_back(placement);
+
+    if (found == fKeys.end()) { Visit(daughter, placement.fKey); }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G02GeometrySummary::Mass&
+G02GeometrySummary::ComputeMass(const G4LogicalVolume* lv)
+{
+  // Same sums as G4LogicalVolume::GetMass(), the masses of the logical
+  // volumes placed several times being computed once
+  //
+  std::map<const G4LogicalVolume*, Mass>::const_iterator done =
+    fMasses.find(lv);
+  if (done != fMasses.end()) { return done->second; }
+
+  const G4Material* material = lv->GetMaterial();
+  G4double density = material ? material->GetDensity() : 0.;
+  Mass result;
+  result.fDaughters = 0.;
+  result.fDisplaced = 0.;
+
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+  {
+    G4VPhysicalVolume* pv = lv->GetDaughter(i);
+    G4LogicalVolume* daughter = pv->GetLogicalVolume();
+    G4int copies = pv->GetMultiplicity();
+    const Mass& content = ComputeMass(daughter);
+    G4VPVParameterisation* param = pv->GetParameterisation();
+    if (param != 0)
+    {
+      // Solid and material of each copy, with the content of the
+      // placed logical volume
+      //
+      for (G4int copy = 0; copy < copies; ++copy)
+      {
+        G4VSolid* solid = param->ComputeSolid(copy, pv);
+        solid->ComputeDimensions(param, copy, pv);
+        G4double volume = G02MassReport::CubicVolume(solid);
+        const G4Material* copyMaterial = param->ComputeMaterial(copy, pv);
+        if (copyMaterial == 0) { copyMaterial = daughter->GetMaterial(); }
+        G4double copyDensity = copyMaterial ? copyMaterial->GetDensity() : 0.;
+        result.fDisplaced += volume;
+        result.fDaughters += (volume - content.fDisplaced)*copyDensity
+                           + content.fDaughters;
+      }
+    }
+    else
+    {
+      result.fDisplaced +=
+        copies*G02MassReport::CubicVolume(daughter->GetSolid());
+      result.fDaughters += copies*content.fTotal;
+    }
+  }
+
+  result.fSelf = (G02MassReport::CubicVolume(lv->GetSolid())
+                  - result.fDisplaced)*density;
+  result.fTotal = result.fSelf + result.fDaughters;
+  return fMasses[lv] = result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometrySummary::Describe(const G4VSolid* solid, Volume& volume) const
+{
+  const G02LazySolid* lazy = dynamic_cast<const G02LazySolid*>(solid);
+  if (lazy != 0) { solid = lazy->GetSolid(); }
+
+  volume.fSolidType = solid->GetEntityType();
+  volume.fParameters.clear();
+
+  // Exact parameters of the CSG solids; the bounding box of the others,
+  // with the number of facets of the tessellated ones
+  //
+  std::string fingerprint = G02SolidInterner::Fingerprint(solid);
+  if (!fingerprint.empty())
+  {
+    std::istringstream in(fingerprint);
+    std::string type;
+    in >> type;
+    G4double value;
+    while (in >> value) { volume.fParameters.push_back(value); }
+    return;
+  }
+
+  G4ThreeVector pMin, pMax;
+  solid->BoundingLimits(pMin, pMax);
+  volume.fParameters.push_back(pMin.x());
+  volume.fParameters.push_back(pMin.y());
+  volume.fParameters.push_back(pMin.z());
+  volume.fParameters.push_back(pMax.x());
+  volume.fParameters.push_back(pMax.y());
+  volume.fParameters.push_back(pMax.z());
+
+  const G4TessellatedSolid* tess =
+    dynamic_cast<const G4TessellatedSolid*>(solid);
+  if (tess != 0)
+  {
+    volume.fParameters.push_back(G4double(tess->GetNumberOfFacets()));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02GeometrySummary::Write(std::ostream& out) const
+{
+  std::streamsize precision = out.precision(17);
+  out << kHeader << '\t' << (fHasMasses ? 1 : 0) << '\n';
+
+  for (std::size_t i = 0; i < fVolumes.size(); ++i)
+  {
+    const Volume& v = fVolumes[i];
+    out << "V\t" << v.fKey << '\t' << v.fName << '\t' << v.fSolidType
+        << '\t' << v.fMaterial << '\t' << v.fDensity
+        << '\t' << v.fSelfMass << '\t' << v.fMass;
+    for (std::size_t k = 0; k < v.fParameters.size(); ++k)
+    {
+      out << '\t' << v.fParameters[k];
+    }
+    out << '\n';
+  }
+
+  for (std::size_t i = 0; i < fPlacements.size(); ++i)
+  {
+    const Placement& p = fPlacements[i];
+    out << "P\t" << p.fKey << '\t' << p.fMotherKey << '\t' << p.fVolumeKey
+        << '\t' << p.fKind << '\t' << p.fMultiplicity;
+    for (G4int k = 0; k < 12; ++k) { out << '\t' << p.fTransform[k]; }
+    out << '\n';
+  }
+  out.precision(precision);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02GeometrySummary::Read(std::istream& in)
+{
+  Clear();
+
+  std::string line;
+  if (!std::getline(in, line)) { return false; }
+  std::vector<std::string> header = Split(line);
+  if (header.size() != 2 || header[0] != kHeader) { return false; }
+  fHasMasses = (header[1] == "1");
+
+  while (std::getline(in, line))
+  {
+    if (line.empty()) { continue; }
+    std::vector<std::string> f = Split(line);
+    if (f[0] == "V" && f.size() >= 8)
+    {
+      Volume v;
+      v.fKey = f[1];
+      v.fName = f[2];
+      v.fSolidType = f[3];
+      v.fMaterial = f[4];
+      if (!ToDouble(f[5], v.fDensity) || !ToDouble(f[6], v.fSelfMass)
+          || !ToDouble(f[7], v.fMass)) { return false; }
+      for (std::size_t k = 8; k < f.size(); ++k)
+      {
+        G4double value;
+        if (!ToDouble(f[k], value)) { return false; }
+        v.fParameters.push_back(value);
+      }
+      fVolumes.push_back(v);
+    }
+    else if (f[0] == "P" && f.size() == 18)
+    {
+      Placement p;
+      p.fKey = f[1];
+      p.fMotherKey = f[2];
+      p.fVolumeKey = f[3];
+      p.fKind = f[4];
+      p.fMultiplicity = std::atoi(f[5].c_str());
+      for (G4int k = 0; k < 12; ++k)
+      {
+        if (!ToDouble(f[6+k], p.fTransform[k])) { return false; }
+      }
+      fPlacements.push_back(p);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02GeometrySummary::Compare(const G02GeometrySummary& other,
+                                  std::ostream& out,
+                                  const Tolerances& tolerances) const
+{
+  std::map<std::string, std::size_t> volumesA, volumesB;
+  std::map<std::string, std::size_t> placementsA, placementsB;
+  for (std::size_t i = 0; i < fVolumes.size(); ++i)
+  {
+    volumesA[fVolumes[i].fKey] = i;
+  }
+  for (std::size_t i = 0; i < other.fVolumes.size(); ++i)
+  {
+    volumesB[other.fVolumes[i].fKey] = i;
+  }
+  for (std::size_t i = 0; i < fPlacements.size(); ++i)
+  {
+    placementsA[fPlacements[i].fKey] = i;
+  }
+  for (std::size_t i = 0; i < other.fPlacements.size(); ++i)
+  {
+    placementsB[other.fPlacements[i].fKey] = i;
+  }
+
+  G4bool masses = fHasMasses && other.fHasMasses;
+  G4int added = 0, removed = 0, changed = 0;
+
+  // Differences of the volumes and placements present in both, by key
+  //
+  std::map<std::string, std::vector<std::string> > changes;
+  for (std::size_t i = 0; i < fVolumes.size(); ++i)
+  {
+    const Volume& a = fVolumes[i];
+    std::map<std::string, std::size_t>::const_iterator it =
+      volumesB.find(a.fKey);
+    if (it == volumesB.end()) { continue; }
+    const Volume& b = other.fVolumes[it->second];
+    std::vector<std::string>& lines = changes[a.fKey];
+
+    if (a.fName != b.fName)
+    {
+      lines.push_back("logical volume: " + a.fName + " -> " + b.fName);
+    }
+    G4bool solid = (a.fSolidType != b.fSolidType)
+                || (a.fParameters.size() != b.fParameters.size());
+    for (std::size_t k = 0; !solid && k < a.fParameters.size(); ++k)
+    {
+      solid = Differs(a.fParameters[k], b.fParameters[k],
+                      tolerances.fLength, tolerances.fRelative);
+    }
+    if (solid)
+    {
+      lines.push_back("solid: " + a.fSolidType + " "
+        + Numbers(a.fParameters.data(), a.fParameters.size()) + " -> "
+        + b.fSolidType + " "
+        + Numbers(b.fParameters.data(), b.fParameters.size()));
+    }
+    if (a.fMaterial != b.fMaterial)
+    {
+      lines.push_back("material: " + a.fMaterial + " -> " + b.fMaterial);
+    }
+    else if (Differs(a.fDensity, b.fDensity, 0., tolerances.fRelative))
+    {
+      lines.push_back("density of " + a.fMaterial + ": "
+        + Change(a.fDensity, b.fDensity, g/cm3, "g/cm3"));
+    }
+    if (masses && Differs(a.fSelfMass, b.fSelfMass, 0., tolerances.fMass))
+    {
+      lines.push_back("mass without daughters: "
+        + Change(a.fSelfMass, b.fSelfMass, kg, "kg"));
+    }
+  }
+
+  for (std::size_t i = 0; i < fPlacements.size(); ++i)
+  {
+    const Placement& a = fPlacements[i];
+    std::map<std::string, std::size_t>::const_iterator it =
+      placementsB.find(a.fKey);
+    if (it == placementsB.end()) { continue; }
+    const Placement& b = other.fPlacements[it->second];
+    std::vector<std::string>& lines = changes[a.fKey];
+
+    if (a.fVolumeKey != b.fVolumeKey)
+    {
+      lines.push_back("places the volume of " + a.fVolumeKey + " -> "
+                      + b.fVolumeKey);
+    }
+    if (a.fKind != b.fKind || a.fMultiplicity != b.fMultiplicity)
+    {
+      std::ostringstream line;
+      line << "kind: " << a.fKind << " x" << a.fMultiplicity << " -> "
+           << b.fKind << " x" << b.fMultiplicity;
+      lines.push_back(line.str());
+      continue;
+    }
+    G4bool translation = false, rotation = false;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      translation |= Differs(a.fTransform[k], b.fTransform[k],
+                             tolerances.fLength, tolerances.fRelative);
+    }
+    for (G4int k = 3; k < 12; ++k)
+    {
+      rotation |= Differs(a.fTransform[k], b.fTransform[k],
+                          tolerances.fRelative, 0.);
+    }
+    if (translation)
+    {
+      lines.push_back((a.fKind == "replica" ? "axis, width, offset: "
+                                            : "translation [mm]: ")
+        + Numbers(a.fTransform, 3) + " -> " + Numbers(b.fTransform, 3));
+    }
+    if (rotation)
+    {
+      lines.push_back("rotation: " + Numbers(a.fTransform+3, 9) + " -> "
+                      + Numbers(b.fTransform+3, 9));
+    }
+  }
+
+  // Report in the depth-first order of the first geometry, then of the
+  // second one for the added placements; the content of an added or
+  // removed volume is not listed
+  //
+  for (std::size_t i = 0; i < fVolumes.size() || i < fPlacements.size(); ++i)
+  {
+    if (i == 0 && !fVolumes.empty())
+    {
+      const std::vector<std::string>& lines = changes[fVolumes[0].fKey];
+      if (!lines.empty())
+      {
+        ++changed;
+        out << "changed " << fVolumes[0].fKey << '\n';
+        for (std::size_t k = 0; k < lines.size(); ++k)
+        {
+          out << "    " << lines[k] << '\n';
+        }
+      }
+    }
+    if (i >= fPlacements.size()) { continue; }
+
+    const Placement& a = fPlacements[i];
+    if (placementsB.find(a.fKey) == placementsB.end())
+    {
+      if (volumesA.count(a.fMotherKey) && !volumesB.count(a.fMotherKey))
+      {
+        continue;
+      }
+      ++removed;
+      out << "removed " << a.fKey << '\n';
+      continue;
+    }
+    const std::vector<std::string>& lines = changes[a.fKey];
+    if (lines.empty()) { continue; }
+    ++changed;
+    out << "changed " << a.fKey << '\n';
+    for (std::size_t k = 0; k < lines.size(); ++k)
+    {
+      out << "    " << lines[k] << '\n';
+    }
+  }
+
+  for (std::size_t i = 0; i < other.fPlacements.size(); ++i)
+  {
+    const Placement& b = other.fPlacements[i];
+    if (placementsA.count(b.fKey)) { continue; }
+    if (volumesB.count(b.fMotherKey) && !volumesA.count(b.fMotherKey))
+    {
+      continue;
+    }
+    ++added;
+    out << "added   " << b.fKey << '\n';
+  }
+
+  out << "summary: " << fVolumes.size() << " volumes, "
+      << fPlacements.size() << " placements -> "
+      << other.fVolumes.size() << " volumes, "
+      << other.fPlacements.size() << " placements; "
+      << added << " added, " << removed << " removed, "
+      << changed << " changed" << '\n';
+  if (masses && !fVolumes.empty() && !other.fVolumes.empty())
+  {
+    out << "total mass: "
+        << Change(fVolumes[0].fMass, other.fVolumes[0].fMass, kg, "kg")
+        << '\n';
+  }
+  return added + removed + changed;
+}
@@ -0,0 +1,208 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02LazyGDMLReader.cc
+/// \brief Implementation of the G02LazyGDMLReader class
+//
+//
+//
+// Class G02LazyGDMLReader implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02LazyGDMLReader.hh"
+#include "G02LazySolid.hh"
+
+#include "G4UnitsTable.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02LazyGDMLReader::G02LazyGDMLReader()
+  : G4GDMLReadStructure(), fLazy(false)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02LazyGDMLReader::~G02LazyGDMLReader()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazyGDMLReader::SolidsRead(
+  const xercesc::DOMElement* const solidsElement)
+{
+  if (!fLazy)
+  {
+    G4GDMLReadStructure::SolidsRead(solidsElement);
+    return;
+  }
+
+  // The tessellated solids only refer to positions of the <define>
+  // section, while other solids may refer to them: they are read first,
+  // then removed from the section given to the standard reader
+  //
+  std::vector<xercesc::DOMNode*> deferred;
+  for (xercesc::DOMNode* iter = solidsElement->getFirstChild();
+       iter != 0; iter = iter->getNextSibling())
+  {
+    if (iter->getNodeType() != xercesc::DOMNode::ELEMENT_NODE) { continue; }
+
+    const xercesc::DOMElement* const child
+      = dynamic_cast<xercesc::DOMElement*>(iter);
+    if (child == 0) { continue; }
+
+    if (Transcode(child->getTagName()) == "tessellated")
+    {
+      LazyTessellatedRead(child);
+      deferred.push_back(iter);
+    }
+  }
+
+  xercesc::DOMElement* const element
+    = const_cast<xercesc::DOMElement*>(solidsElement);
+  for (std::size_t i = 0; i < deferred.size(); ++i)
+  {
+    element->removeChild(deferred[i])->release();
+  }
+
+  G4GDMLReadStructure::SolidsRead(solidsElement);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02LazyGDMLReader::LengthUnit(const G4String& unit) const
+{
+  if (G4UnitDefinition::GetCategory(unit) != "Length")
+  {
+    G4Exception("G02LazyGDMLReader::LengthUnit()", "G02Lazy001",
+                FatalException, "Invalid unit for length!");
+  }
+  return G4UnitDefinition::GetValueOf(unit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazyGDMLReader::LazyTessellatedRead(
+  const xercesc::DOMElement* const element)
+{
+  G4String name;
+  G4double lunit = 1.0;
+
+  const xercesc::DOMNamedNodeMap* const attributes = element->getAttributes();
+  XMLSize_t attributeCount = attributes->getLength();
+  for (XMLSize_t i = 0; i < attributeCount; ++i)
+  {
+    xercesc::DOMNode* attributeNode = attributes->item(i);
+    if (attributeNode->getNodeType() != xercesc::DOMNode::ATTRIBUTE_NODE)
+    {
+      continue;
+    }
+    const xercesc::DOMAttr* const attribute
+      = dynamic_cast<xercesc::DOMAttr*>(attributeNode);
+    if (attribute == 0) { continue; }
+
+    const G4String attName = Transcode(attribute->getName());
+    const G4String attValue = Transcode(attribute->getValue());
+    if (attName == "name")       { name = GenerateName(attValue); }
+    else if (attName == "lunit") { lunit = LengthUnit(attValue); }
+  }
+
+  G02LazySolid* solid = new G02LazySolid(name);
+
+  for (xercesc::DOMNode* iter = element->getFirstChild();
+       iter != 0; iter = iter->getNextSibling())
+  {
+    if (iter->getNodeType() != xercesc::DOMNode::ELEMENT_NODE) { continue; }
+
+    const xercesc::DOMElement* const child
+      = dynamic_cast<xercesc::DOMElement*>(iter);
+    if (child == 0) { continue; }
+
+    const G4String tag = Transcode(child->getTagName());
+    if (tag == "triangular" || tag == "quadrangular")
+    {
+      FacetRead(child, lunit, solid);
+    }
+    else
+    {
+      G4String error_msg = "Unknown tag in tessellated: " + tag;
+      G4Exception("G02LazyGDMLReader::LazyTessellatedRead()", "G02Lazy002",
+                  FatalException, error_msg);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazyGDMLReader::FacetRead(const xercesc::DOMElement* const element,
+                                  G4double lunit, G02LazySolid* solid)
+{
+  G4ThreeVector vertex[4];
+  G4bool relative = false;
+
+  const xercesc::DOMNamedNodeMap* const attributes = element->getAttributes();
+  XMLSize_t attributeCount = attributes->getLength();
+  for (XMLSize_t i = 0; i < attributeCount; ++i)
+  {
+    xercesc::DOMNode* attributeNode = attributes->item(i);
+    if (attributeNode->getNodeType() != xercesc::DOMNode::ATTRIBUTE_NODE)
+    {
+      continue;
+    }
+    const xercesc::DOMAttr* const attribute
+      = dynamic_cast<xercesc::DOMAttr*>(attributeNode);
+    if (attribute == 0) { continue; }
+
+    const G4String attName = Transcode(attribute->getName());
+    const G4String attValue = Transcode(attribute->getValue());
+    if (attName.size() == 7 && attName.compare(0, 6, "vertex") == 0
+        && attName[6] >= '1' && attName[6] <= '4')
+    {
+      vertex[attName[6]-'1'] = GetPosition(GenerateName(attValue));
+    }
+    else if (attName == "type")  { relative = (attValue == "RELATIVE"); }
+    else if (attName == "lunit") { lunit = LengthUnit(attValue); }
+  }
+
+  // Relative facets give the vertices after the first one as offsets
+  //
+  G4bool quadrangle = Transcode(element->getTagName()) == "quadrangular";
+  G4int nVertices = quadrangle ? 4 : 3;
+  for (G4int i = 1; relative && i < nVertices; ++i) { vertex[i] += vertex[0]; }
+  for (G4int i = 0; i < nVertices; ++i) { vertex[i] *= lunit; }
+
+  if (quadrangle)
+  {
+    solid->AddQuadrangle(vertex[0], vertex[1], vertex[2], vertex[3]);
+  }
+  else
+  {
+    solid->AddTriangle(vertex[0], vertex[1], vertex[2]);
+  }
+}
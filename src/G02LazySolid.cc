@@ -0,0 +1,304 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02LazySolid.cc
+/// \brief Implementation of the G02LazySolid class
+//
+//
+//
+// Class G02LazySolid implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02LazySolid.hh"
+
+#include "G4ios.hh"
+#include "G4AutoLock.hh"
+#include "G4BoundingEnvelope.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4QuadrangularFacet.hh"
+#include "G4SolidStore.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  G4Mutex buildMutex = G4MUTEX_INITIALIZER;
+  std::atomic<G4int> nDeferred(0);
+  std::atomic<G4int> nBuilt(0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02LazySolid::G02LazySolid(const G4String& name)
+  : G4VSolid(name),
+    fMin(kInfinity, kInfinity, kInfinity),
+    fMax(-kInfinity, -kInfinity, -kInfinity),
+    fFacets(0),
+    fTriangles(0),
+    fSolid(0)
+{
+  ++nDeferred;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02LazySolid::~G02LazySolid()
+{
+  delete fSolid.load();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazySolid::AddTriangle(const G4ThreeVector& v1,
+                               const G4ThreeVector& v2,
+                               const G4ThreeVector& v3)
+{
+  AddQuadrangle(v1, v2, v3, v3);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazySolid::AddQuadrangle(const G4ThreeVector& v1,
+                                 const G4ThreeVector& v2,
+                                 const G4ThreeVector& v3,
+                                 const G4ThreeVector& v4)
+{
+  const G4ThreeVector* vertices[4] = { &v1, &v2, &v3, &v4 };
+  for (G4int i = 0; i < 4; ++i)
+  {
+    const G4ThreeVector& v = *vertices[i];
+    fVertices.push_back(v);
+    fMin.set(std::min(fMin.x(), v.x()), std::min(fMin.y(), v.y()),
+             std::min(fMin.z(), v.z()));
+    fMax.set(std::max(fMax.x(), v.x()), std::max(fMax.y(), v.y()),
+             std::max(fMax.z(), v.z()));
+  }
+  ++fFacets;
+  fTriangles += (v4 == v3) ? 1 : 2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02LazySolid::GetSolid() const
+{
+  G4VSolid* solid = fSolid.load(std::memory_order_acquire);
+  return solid != 0 ? solid : Build();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02LazySolid::Build() const
+{
+  G4AutoLock lock(&buildMutex);
+
+  // Another thread may have built it while this one was waiting
+  //
+  G4VSolid* solid = fSolid.load(std::memory_order_acquire);
+  if (solid != 0) { return solid; }
+
+  G4TessellatedSolid* tessellated = new G4TessellatedSolid(GetName());
+  G4SolidStore::DeRegister(tessellated);
+
+  for (std::size_t i = 0; i+3 < fVertices.size(); i += 4)
+  {
+    const G4ThreeVector* v = &fVertices[i];
+    if (v[3] == v[2])
+    {
+      tessellated->AddFacet(new G4TriangularFacet(v[0], v[1], v[2], ABSOLUTE));
+    }
+    else
+    {
+      tessellated->AddFacet(new G4QuadrangularFacet(v[0], v[1], v[2], v[3],
+                                                    ABSOLUTE));
+    }
+  }
+  tessellated->SetSolidClosed(true);
+
+  std::vector<G4ThreeVector>().swap(fVertices);
+  ++nBuilt;
+
+  fSolid.store(tessellated, std::memory_order_release);
+  return tessellated;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02LazySolid::GetNumberOfDeferred()
+{
+  return nDeferred.load();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02LazySolid::GetNumberOfBuilt()
+{
+  return nBuilt.load();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazySolid::PrintStatistics()
+{
+  if (nDeferred.load() == 0) { return; }
+  G4cout << "G02LazySolid: " << nBuilt.load() << " of " << nDeferred.load()
+         << " deferred tessellated solids built" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazySolid::BoundingLimits(G4ThreeVector& pMin,
+                                  G4ThreeVector& pMax) const
+{
+  pMin = fMin;
+  pMax = fMax;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02LazySolid::CalculateExtent(const EAxis pAxis,
+                                     const G4VoxelLimits& pVoxelLimit,
+                                     const G4AffineTransform& pTransform,
+                                     G4double& pMin, G4double& pMax) const
+{
+  G4BoundingEnvelope bbox(fMin, fMax);
+  return bbox.CalculateExtent(pAxis, pVoxelLimit, pTransform, pMin, pMax);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EInside G02LazySolid::Inside(const G4ThreeVector& p) const
+{
+  return GetSolid()->Inside(p);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector G02LazySolid::SurfaceNormal(const G4ThreeVector& p) const
+{
+  return GetSolid()->SurfaceNormal(p);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02LazySolid::DistanceToIn(const G4ThreeVector& p,
+                                    const G4ThreeVector& v) const
+{
+  return GetSolid()->DistanceToIn(p, v);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02LazySolid::DistanceToIn(const G4ThreeVector& p) const
+{
+  return GetSolid()->DistanceToIn(p);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02LazySolid::DistanceToOut(const G4ThreeVector& p,
+                                     const G4ThreeVector& v,
+                                     const G4bool calcNorm,
+                                     G4bool* validNorm,
+                                     G4ThreeVector* n) const
+{
+  return GetSolid()->DistanceToOut(p, v, calcNorm, validNorm, n);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02LazySolid::DistanceToOut(const G4ThreeVector& p) const
+{
+  return GetSolid()->DistanceToOut(p);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02LazySolid::GetCubicVolume()
+{
+  return GetSolid()->GetCubicVolume();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02LazySolid::GetSurfaceArea()
+{
+  return GetSolid()->GetSurfaceArea();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector G02LazySolid::GetPointOnSurface() const
+{
+  return GetSolid()->GetPointOnSurface();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String G02LazySolid::GetEntityType() const
+{
+  return "G02LazySolid";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02LazySolid::Clone() const
+{
+  return GetSolid()->Clone();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::ostream& G02LazySolid::StreamInfo(std::ostream& os) const
+{
+  G4VSolid* solid = fSolid.load(std::memory_order_acquire);
+  if (solid != 0) { return solid->StreamInfo(os); }
+
+  os << "-----------------------------------------------------------\n"
+     << "    *** Dump for solid - " << GetName() << " ***\n"
+     << "    ===================================================\n"
+     << " Solid type: G02LazySolid (tessellated solid not built yet)\n"
+     << " Number of facets: " << fFacets << "\n"
+     << " Bounding box: " << fMin << " - " << fMax << "\n"
+     << "-----------------------------------------------------------\n";
+  return os;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LazySolid::DescribeYourselfTo(G4VGraphicsScene& scene) const
+{
+  GetSolid()->DescribeYourselfTo(scene);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Polyhedron* G02LazySolid::CreatePolyhedron() const
+{
+  return GetSolid()->CreatePolyhedron();
+}
@@ -0,0 +1,258 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02LevelOfDetail.cc
+/// \brief Implementation of the G02LevelOfDetail class
+//
+//
+//
+// Class G02LevelOfDetail implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02LevelOfDetail.hh"
+#include "G02MeshSimplifier.hh"
+#include "G02LazySolid.hh"
+
+#include "G4ios.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <iomanip>
+#include <map>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02LevelOfDetail::G02LevelOfDetail()
+  : fEnabled(false), fProxySelected(false),
+    fTargetFacets(0), fTolerance(0.1*mm), fMaxVolumeError(0.01)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02LevelOfDetail::~G02LevelOfDetail()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02LevelOfDetail::Build()
+{
+  Clear();
+
+  // The tessellated solids of the logical volumes, stand-ins included,
+  // each with the volumes using it
+  //
+  std::map<G4VSolid*, std::size_t> index;
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < lvStore->size(); ++i)
+  {
+    G4LogicalVolume* lv = (*lvStore)[i];
+    G4VSolid* solid = lv->GetSolid();
+    if (dynamic_cast<G4TessellatedSolid*>(solid) == 0
+     && dynamic_cast<G02LazySolid*>(solid) == 0) { continue; }
+
+    std::map<G4VSolid*, std::size_t>::iterator it = index.find(solid);
+    if (it == index.end())
+    {
+      Entry entry;
+      entry.fFull = solid;
+      entry.fProxy = 0;
+      entry.fFacetsFull = entry.fFacetsProxy = 0;
+      entry.fVolumeError = entry.fMaxError = 0.;
+      entry.fDone = false;
+      it = index.insert(std::make_pair(solid, fEntries.size())).first;
+      fEntries.push_back(entry);
+    }
+    fEntries[it->second].fVolumes.push_back(lv);
+  }
+
+  // The lazy stand-ins not built yet are simplified when the proxies are
+  // first selected, so that reading them stays deferred until then
+  //
+  G4int built = 0;
+  for (std::size_t i = 0; i < fEntries.size(); ++i)
+  {
+    const G02LazySolid* lazy = dynamic_cast<const G02LazySolid*>(
+      fEntries[i].fFull);
+    if (lazy != 0 && !lazy->IsBuilt()) { continue; }
+    if (Simplify(fEntries[i])) { ++built; }
+  }
+
+  Select(fProxySelected);
+  return built;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02LevelOfDetail::Simplify(Entry& entry) const
+{
+  entry.fDone = true;
+
+  const G4TessellatedSolid* full
+    = dynamic_cast<const G4TessellatedSolid*>(entry.fFull);
+  if (full == 0)
+  {
+    full = dynamic_cast<const G4TessellatedSolid*>(
+             static_cast<const G02LazySolid*>(entry.fFull)->GetSolid());
+    if (full == 0) { return false; }
+  }
+
+  G02MeshSimplifier simplifier;
+  simplifier.SetTargetFacets(fTargetFacets);
+  simplifier.SetTolerance(fTolerance);
+
+  G4TessellatedSolid* proxy
+    = simplifier.Simplify(full, entry.fFull->GetName() + "_lod");
+  entry.fFacetsFull = full->GetNumberOfFacets();
+  if (proxy == 0) { return false; }
+
+  // Compared in triangles, as the facets of the proxy
+  //
+  entry.fFacetsFull = simplifier.GetFacetsBefore();
+  entry.fFacetsProxy = simplifier.GetFacetsAfter();
+  entry.fMaxError = simplifier.GetMaxError();
+  G4double volume = simplifier.GetVolumeBefore();
+  if (volume != 0.)
+  {
+    entry.fVolumeError = (simplifier.GetVolumeAfter() - volume)/volume;
+  }
+
+  // Proxies changing the volume too much are dropped
+  //
+  if (std::fabs(entry.fVolumeError) > fMaxVolumeError)
+  {
+    delete proxy;
+    return false;
+  }
+  entry.fProxy = proxy;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LevelOfDetail::Select(G4bool proxies)
+{
+  fProxySelected = proxies;
+
+  // Between runs: the worker threads do not read the entries meanwhile
+  //
+  if (proxies)
+  {
+    G4int deferred = 0;
+    for (std::size_t i = 0; i < fEntries.size(); ++i)
+    {
+      if (fEntries[i].fDone) { continue; }
+      Simplify(fEntries[i]);
+      ++deferred;
+    }
+    if (deferred > 0)
+    {
+      G4cout << "G02LevelOfDetail: " << deferred
+             << " deferred tessellated solids simplified" << G4endl;
+    }
+  }
+
+  Apply();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LevelOfDetail::Apply() const
+{
+  for (std::size_t i = 0; i < fEntries.size(); ++i)
+  {
+    const Entry& entry = fEntries[i];
+    if (entry.fProxy == 0) { continue; }
+    G4VSolid* solid = fProxySelected ? entry.fProxy : entry.fFull;
+    for (std::size_t j = 0; j < entry.fVolumes.size(); ++j)
+    {
+      entry.fVolumes[j]->SetSolid(solid);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LevelOfDetail::Clear()
+{
+  fEntries.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02LevelOfDetail::PrintReport() const
+{
+  G4int facetsFull = 0, facetsProxy = 0, rejected = 0, deferred = 0;
+  G4cout << "G02LevelOfDetail: proxies of " << fEntries.size()
+         << " tessellated solids (target " << fTargetFacets
+         << " facets, tolerance " << fTolerance/mm << " mm, max volume error "
+         << 100.*fMaxVolumeError << "%)" << G4endl;
+  for (std::size_t i = 0; i < fEntries.size(); ++i)
+  {
+    const Entry& entry = fEntries[i];
+    G4cout << "  " << std::setw(40) << std::left << entry.fFull->GetName()
+           << std::right;
+    if (!entry.fDone)
+    {
+      G4cout << "  deferred until the proxies are selected" << G4endl;
+      ++deferred;
+      continue;
+    }
+    G4cout << std::setw(8) << entry.fFacetsFull << " ->";
+    if (entry.fFacetsProxy == 0)
+    {
+      G4cout << "  not simplified" << G4endl;
+      facetsFull += entry.fFacetsFull;
+      facetsProxy += entry.fFacetsFull;
+      continue;
+    }
+    G4cout << std::setw(8) << entry.fFacetsProxy << " facets, volume "
+           << std::showpos << std::setprecision(3)
+           << 100.*entry.fVolumeError << std::noshowpos << "%, error < "
+           << entry.fMaxError/mm << " mm" << std::setprecision(6);
+    facetsFull += entry.fFacetsFull;
+    if (entry.fProxy == 0)
+    {
+      G4cout << " (rejected)";
+      facetsProxy += entry.fFacetsFull;
+      ++rejected;
+    }
+    else
+    {
+      facetsProxy += entry.fFacetsProxy;
+    }
+    G4cout << G4endl;
+  }
+  G4cout << "  " << facetsFull << " facets in full, " << facetsProxy
+         << " with the proxies, " << rejected << " proxies rejected, "
+         << deferred << " deferred; "
+         << (fProxySelected ? "proxies" : "full solids") << " selected"
+         << G4endl;
+}
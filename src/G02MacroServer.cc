@@ -0,0 +1,352 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02MacroServer.cc
+/// \brief Implementation of the G02MacroServer class
+//
+//
+//
+// Class G02MacroServer implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02MacroServer.hh"
+#include "G02ResourceUsage.hh"
+
+#include "G4ios.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#if !defined(_WIN32)
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MacroServer::G02MacroServer(const G4String& socketPath)
+  : G4UIsession(),
+    fSocketPath(socketPath),
+    fListener(-1),
+    fClient(-1),
+    fJobs(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MacroServer::~G02MacroServer()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MacroServer::Listen()
+{
+#if defined(_WIN32)
+  G4Exception("G02MacroServer::Listen()", "G02Server001", JustWarning,
+              "Unix domain sockets are not supported on this platform.");
+  return false;
+#else
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (fSocketPath.empty() || fSocketPath.size() >= sizeof(address.sun_path))
+  {
+    G4ExceptionDescription msg;
+    msg << "Invalid socket path \"" << fSocketPath << "\".";
+    G4Exception("G02MacroServer::Listen()", "G02Server002",
+                JustWarning, msg);
+    return false;
+  }
+  std::strncpy(address.sun_path, fSocketPath.c_str(),
+               sizeof(address.sun_path)-1);
+
+  // A socket left by a previous server is replaced; any other file is not
+  //
+  struct stat info;
+  if (lstat(fSocketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+  {
+    unlink(fSocketPath.c_str());
+  }
+
+  // The socket is created owner-only: no other user may connect between
+  // the bind() and a later chmod()
+  //
+  fListener = socket(AF_UNIX, SOCK_STREAM, 0);
+  G4bool bound = false;
+  if (fListener >= 0)
+  {
+    mode_t previousMask = umask(S_IRWXG | S_IRWXO);
+    bound = (bind(fListener, (sockaddr*)&address, sizeof(address)) == 0);
+    G4int bindError = errno;
+    umask(previousMask);
+    errno = bindError;
+  }
+  if (!bound
+   || chmod(fSocketPath.c_str(), S_IRUSR | S_IWUSR) != 0
+   || listen(fListener, 8) != 0)
+  {
+    G4ExceptionDescription msg;
+    msg << "Cannot listen on \"" << fSocketPath << "\": "
+        << std::strerror(errno);
+    G4Exception("G02MacroServer::Listen()", "G02Server003",
+                JustWarning, msg);
+    Close();
+    return false;
+  }
+
+  // A client leaving before the end of its job must not stop the server
+  //
+  std::signal(SIGPIPE, SIG_IGN);
+  return true;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MacroServer::Close()
+{
+#if !defined(_WIN32)
+  if (fClient >= 0) { close(fClient); fClient = -1; }
+  if (fListener >= 0)
+  {
+    close(fListener);
+    fListener = -1;
+    unlink(fSocketPath.c_str());
+  }
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4UIsession* G02MacroServer::SessionStart()
+{
+  if (!Listen()) { return 0; }
+
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  UImanager->SetSession(this);
+  UImanager->SetCoutDestination(this);
+
+  std::cout << "G02MacroServer: listening on " << fSocketPath << std::endl;
+
+#if !defined(_WIN32)
+  G4bool stop = false;
+  while (!stop)
+  {
+    fClient = accept(fListener, 0, 0);
+    if (fClient < 0)
+    {
+      if (errno == EINTR) { continue; }
+      std::cerr << "G02MacroServer: accept failed: "
+                << std::strerror(errno) << std::endl;
+      break;
+    }
+
+    std::vector<G4String> commands;
+    if (ReadBatch(commands, stop))
+    {
+      ++fJobs;
+      RunBatch(commands);
+    }
+    if (fClient >= 0) { close(fClient); fClient = -1; }
+  }
+#endif
+
+  UImanager->SetCoutDestination(0);
+  UImanager->SetSession(0);
+  Close();
+
+  std::cout << "G02MacroServer: stopped after " << fJobs << " jobs"
+            << std::endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MacroServer::PauseSessionStart(const G4String& msg)
+{
+  // There is nobody to resume an interactive pause
+  //
+  Send('s', "pause ignored: " + msg);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MacroServer::ReadBatch(std::vector<G4String>& commands,
+                                 G4bool& stop)
+{
+#if defined(_WIN32)
+  return false;
+#else
+  std::string pending;
+  char buffer[4096];
+  G4bool ended = false;
+  while (!ended)
+  {
+    ssize_t n = recv(fClient, buffer, sizeof(buffer), 0);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0)
+    {
+      ended = true;    // The client closed its side: the last line counts
+      if (pending.empty()) { break; }
+      pending += '\n';
+    }
+    else
+    {
+      pending.append(buffer, std::size_t(n));
+    }
+
+    std::size_t newline;
+    while ((newline = pending.find('\n')) != std::string::npos)
+    {
+      G4String line = pending.substr(0, newline);
+      pending.erase(0, newline+1);
+
+      std::size_t first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos) { continue; }
+      std::size_t last = line.find_last_not_of(" \t\r");
+      line = line.substr(first, last-first+1);
+
+      if (line[0] == '#') { continue; }
+      if (line == ".") { ended = true; break; }
+      if (line == "exit") { stop = true; ended = true; break; }
+      commands.push_back(line);
+    }
+  }
+  return !commands.empty();
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MacroServer::RunBatch(const std::vector<G4String>& commands)
+{
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  G4double start = G02ResourceUsage::WallTime();
+
+  std::size_t executed = 0;
+  G4int status = fCommandSucceeded;
+  for (; executed < commands.size() && fClient >= 0; ++executed)
+  {
+    const G4String& command = commands[executed];
+    status = UImanager->ApplyCommand(command);
+    if (status != fCommandSucceeded)
+    {
+      std::ostringstream msg;
+      msg << "error " << status << " " << command;
+      Send('s', msg.str());
+      ++executed;
+      break;
+    }
+  }
+
+  std::ostringstream msg;
+  msg << "done " << executed << " " << status;
+  Send('s', msg.str());
+
+  std::cout << "G02MacroServer: job " << fJobs << ", " << executed << " of "
+            << commands.size() << " commands, status " << status << ", "
+            << std::fixed << std::setprecision(3)
+            << G02ResourceUsage::WallTime() - start << " s" << std::endl;
+  std::cout.unsetf(std::ios::fixed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MacroServer::Send(char channel, const G4String& text)
+{
+#if !defined(_WIN32)
+  if (fClient < 0) { return; }
+
+  // One prefixed line per line of text
+  //
+  std::string framed;
+  std::size_t begin = 0;
+  while (begin < text.size())
+  {
+    std::size_t end = text.find('\n', begin);
+    if (end == std::string::npos) { end = text.size(); }
+    framed += channel;
+    framed += ' ';
+    framed.append(text, begin, end-begin);
+    framed += '\n';
+    begin = end+1;
+  }
+
+  std::size_t sent = 0;
+  while (sent < framed.size())
+  {
+    ssize_t n = send(fClient, framed.data()+sent, framed.size()-sent, 0);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0)
+    {
+      // The client is gone: the job stops after the current command
+      //
+      close(fClient);
+      fClient = -1;
+      return;
+    }
+    sent += std::size_t(n);
+  }
+#else
+  (void)channel; (void)text;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02MacroServer::ReceiveG4cout(const G4String& coutString)
+{
+  if (fClient < 0)
+  {
+    std::cout << coutString << std::flush;
+    return 0;
+  }
+  Send('o', coutString);
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02MacroServer::ReceiveG4cerr(const G4String& cerrString)
+{
+  if (fClient < 0)
+  {
+    std::cerr << cerrString << std::flush;
+    return 0;
+  }
+  Send('e', cerrString);
+  return 0;
+}
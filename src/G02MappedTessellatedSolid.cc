@@ -0,0 +1,560 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02MappedTessellatedSolid.cc
+/// \brief Implementation of the G02MappedTessellatedSolid class
+//
+//
+//
+// Class G02MappedTessellatedSolid implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02MappedTessellatedSolid.hh"
+
+#include "G4BoundingEnvelope.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4PolyhedronArbitrary.hh"
+#include "G4VGraphicsScene.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // A node at depth d is popped with at most one pending sibling per
+  // ancestor on the stack; G02MeshFile rejects the deeper trees
+  //
+  const G4int maxStack = G02MeshFile::kMaxDepth + 1;
+
+  // Tolerance on the barycentric coordinates, so that rays through the
+  // common edge of two triangles do not leak between them
+  //
+  const G4double edgeTolerance = 1.e-9;
+
+  // Directions of the parity rays of Inside(): unit vectors without
+  // rational ratios of their components, so that rays from points on a
+  // regular lattice do not run through the edges of a mesh on it
+  //
+  const G4ThreeVector parityRays[3] =
+  {
+    G4ThreeVector(0.3128919692507969, 0.5456834174049765, 0.7773855051051468),
+    G4ThreeVector(-0.8620683605690644, 0.2718628617630919, 0.4277016788600993),
+    G4ThreeVector(0.4164532260707619, -0.8187285649955308, 0.3952850204037762)
+  };
+
+  // Entry and exit distances of the ray in the box of a node, widened by
+  // the tolerance; false if the ray misses the box within [tmin, tmax]
+  //
+  inline G4bool RayBox(const G02MeshFile::Node& node, const G4ThreeVector& p,
+                       const G4ThreeVector& v, G4double tolerance,
+                       G4double tmin, G4double tmax)
+  {
+    for (G4int k = 0; k < 3; ++k)
+    {
+      G4double lo = node.fMin[k] - tolerance;
+      G4double hi = node.fMax[k] + tolerance;
+      if (v[k] == 0.)
+      {
+        if (p[k] < lo || p[k] > hi) { return false; }
+        continue;
+      }
+      G4double inv = 1./v[k];
+      G4double t0 = (lo - p[k])*inv;
+      G4double t1 = (hi - p[k])*inv;
+      if (t0 > t1) { std::swap(t0, t1); }
+      tmin = std::max(tmin, t0);
+      tmax = std::min(tmax, t1);
+      if (tmin > tmax) { return false; }
+    }
+    return true;
+  }
+
+  // Squared distance from a point to the box of a node
+  //
+  inline G4double BoxDistance2(const G02MeshFile::Node& node,
+                               const G4ThreeVector& p)
+  {
+    G4double d2 = 0.;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      G4double d = std::max(node.fMin[k] - p[k], p[k] - node.fMax[k]);
+      if (d > 0.) { d2 += d*d; }
+    }
+    return d2;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MappedTessellatedSolid::G02MappedTessellatedSolid(
+  const G4String& name, const G02MeshFile::Mesh* mesh)
+  : G4VSolid(name), fMesh(mesh)
+{
+  fHalfTolerance = 0.5*G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MappedTessellatedSolid::~G02MappedTessellatedSolid()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4ThreeVector
+G02MappedTessellatedSolid::Vertex(std::uint32_t index) const
+{
+  const double* v = fMesh->fVertices + 3*index;
+  return G4ThreeVector(v[0], v[1], v[2]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4ThreeVector
+G02MappedTessellatedSolid::Normal(std::uint32_t triangle) const
+{
+  const double* n = fMesh->fNormals + 3*triangle;
+  return G4ThreeVector(n[0], n[1], n[2]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MappedTessellatedSolid::RayTriangle(const G4ThreeVector& p,
+                                              const G4ThreeVector& v,
+                                              std::uint32_t triangle,
+                                              G4double& t) const
+{
+  // Moller-Trumbore
+  //
+  const std::uint32_t* index = fMesh->fTriangles + 3*triangle;
+  G4ThreeVector a = Vertex(index[0]);
+  G4ThreeVector e1 = Vertex(index[1]) - a;
+  G4ThreeVector e2 = Vertex(index[2]) - a;
+
+  G4ThreeVector pvec = v.cross(e2);
+  G4double det = e1.dot(pvec);
+  if (det == 0.) { return false; }
+  G4double inv = 1./det;
+
+  G4ThreeVector tvec = p - a;
+  G4double u = tvec.dot(pvec)*inv;
+  if (u < -edgeTolerance || u > 1. + edgeTolerance) { return false; }
+
+  G4ThreeVector qvec = tvec.cross(e1);
+  G4double w = v.dot(qvec)*inv;
+  if (w < -edgeTolerance || u + w > 1. + edgeTolerance) { return false; }
+
+  t = e2.dot(qvec)*inv;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::PointTriangle(const G4ThreeVector& p,
+                                                  std::uint32_t triangle) const
+{
+  // Closest point of the triangle, by Voronoi regions (C. Ericson,
+  // Real-Time Collision Detection, 5.1.5)
+  //
+  const std::uint32_t* index = fMesh->fTriangles + 3*triangle;
+  G4ThreeVector a = Vertex(index[0]);
+  G4ThreeVector b = Vertex(index[1]);
+  G4ThreeVector c = Vertex(index[2]);
+
+  G4ThreeVector ab = b - a, ac = c - a, ap = p - a;
+  G4double d1 = ab.dot(ap), d2 = ac.dot(ap);
+  if (d1 <= 0. && d2 <= 0.) { return ap.mag(); }
+
+  G4ThreeVector bp = p - b;
+  G4double d3 = ab.dot(bp), d4 = ac.dot(bp);
+  if (d3 >= 0. && d4 <= d3) { return bp.mag(); }
+
+  G4double vc = d1*d4 - d3*d2;
+  if (vc <= 0. && d1 >= 0. && d3 <= 0.)
+  {
+    return (p - (a + ab*(d1/(d1 - d3)))).mag();
+  }
+
+  G4ThreeVector cp = p - c;
+  G4double d5 = ab.dot(cp), d6 = ac.dot(cp);
+  if (d6 >= 0. && d5 <= d6) { return cp.mag(); }
+
+  G4double vb = d5*d2 - d1*d6;
+  if (vb <= 0. && d2 >= 0. && d6 <= 0.)
+  {
+    return (p - (a + ac*(d2/(d2 - d6)))).mag();
+  }
+
+  G4double va = d3*d6 - d5*d4;
+  if (va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+  {
+    G4double w = (d4 - d3)/((d4 - d3) + (d5 - d6));
+    return (p - (b + (c - b)*w)).mag();
+  }
+
+  // Inside the face: distance to the plane
+  //
+  return std::fabs(ap.dot(Normal(triangle)));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MappedTessellatedSolid::Intersect(const G4ThreeVector& p,
+                                            const G4ThreeVector& v,
+                                            G4int sense, G4double& distance,
+                                            std::uint32_t& triangle) const
+{
+  if (fMesh->fRecord->fNodes == 0) { return false; }
+
+  G4double best = kInfinity;
+  G4bool found = false;
+
+  std::uint32_t stack[maxStack];
+  G4int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    std::uint32_t n = stack[--top];
+    const G02MeshFile::Node& node = fMesh->fNodes[n];
+    if (!RayBox(node, p, v, fHalfTolerance, -fHalfTolerance, best))
+    {
+      continue;
+    }
+
+    if (node.fCount > 0)
+    {
+      for (std::uint32_t i = node.fFirst; i < node.fFirst + node.fCount; ++i)
+      {
+        if (sense*Normal(i).dot(v) <= 0.) { continue; }
+        G4double t;
+        if (RayTriangle(p, v, i, t) && t >= -fHalfTolerance && t < best)
+        {
+          best = t;
+          triangle = i;
+          found = true;
+        }
+      }
+    }
+    else
+    {
+      stack[top++] = node.fFirst;
+      stack[top++] = n + 1;
+    }
+  }
+
+  distance = std::max(best, 0.);
+  return found;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02MappedTessellatedSolid::CountCrossings(const G4ThreeVector& p,
+                                                const G4ThreeVector& v) const
+{
+  if (fMesh->fRecord->fNodes == 0) { return 0; }
+
+  G4int crossings = 0;
+  std::uint32_t stack[maxStack];
+  G4int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    std::uint32_t n = stack[--top];
+    const G02MeshFile::Node& node = fMesh->fNodes[n];
+    if (!RayBox(node, p, v, fHalfTolerance, 0., kInfinity)) { continue; }
+
+    if (node.fCount > 0)
+    {
+      for (std::uint32_t i = node.fFirst; i < node.fFirst + node.fCount; ++i)
+      {
+        G4double t;
+        if (RayTriangle(p, v, i, t) && t > 0.) { ++crossings; }
+      }
+    }
+    else
+    {
+      stack[top++] = node.fFirst;
+      stack[top++] = n + 1;
+    }
+  }
+  return crossings;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::Nearest(const G4ThreeVector& p,
+                                            std::uint32_t& triangle) const
+{
+  if (fMesh->fRecord->fNodes == 0) { return kInfinity; }
+
+  G4double best = kInfinity;
+  G4double best2 = kInfinity;
+  triangle = 0;
+
+  std::uint32_t stack[maxStack];
+  G4int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    std::uint32_t n = stack[--top];
+    const G02MeshFile::Node& node = fMesh->fNodes[n];
+    if (BoxDistance2(node, p) >= best2) { continue; }
+
+    if (node.fCount > 0)
+    {
+      for (std::uint32_t i = node.fFirst; i < node.fFirst + node.fCount; ++i)
+      {
+        G4double d = PointTriangle(p, i);
+        if (d < best)
+        {
+          best = d;
+          best2 = d*d;
+          triangle = i;
+        }
+      }
+    }
+    else
+    {
+      // The nearer child is visited first
+      //
+      std::uint32_t first = n + 1, second = node.fFirst;
+      if (BoxDistance2(fMesh->fNodes[first], p)
+        > BoxDistance2(fMesh->fNodes[second], p)) { std::swap(first, second); }
+      stack[top++] = second;
+      stack[top++] = first;
+    }
+  }
+  return best;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MappedTessellatedSolid::BoundingLimits(G4ThreeVector& pMin,
+                                               G4ThreeVector& pMax) const
+{
+  const G02MeshFile::MeshRecord* record = fMesh->fRecord;
+  pMin.set(record->fMin[0], record->fMin[1], record->fMin[2]);
+  pMax.set(record->fMax[0], record->fMax[1], record->fMax[2]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MappedTessellatedSolid::CalculateExtent(
+  const EAxis pAxis, const G4VoxelLimits& pVoxelLimit,
+  const G4AffineTransform& pTransform, G4double& pMin, G4double& pMax) const
+{
+  G4ThreeVector bmin, bmax;
+  BoundingLimits(bmin, bmax);
+  G4BoundingEnvelope bbox(bmin, bmax);
+  return bbox.CalculateExtent(pAxis, pVoxelLimit, pTransform, pMin, pMax);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EInside G02MappedTessellatedSolid::Inside(const G4ThreeVector& p) const
+{
+  const G02MeshFile::MeshRecord* record = fMesh->fRecord;
+  for (G4int k = 0; k < 3; ++k)
+  {
+    if (p[k] < record->fMin[k] - fHalfTolerance
+     || p[k] > record->fMax[k] + fHalfTolerance) { return kOutside; }
+  }
+
+  std::uint32_t triangle;
+  if (Nearest(p, triangle) <= fHalfTolerance) { return kSurface; }
+
+  // Majority of the parities of three rays, against rays through edges
+  //
+  G4int odd = CountCrossings(p, parityRays[0]) % 2;
+  odd += CountCrossings(p, parityRays[1]) % 2;
+  if (odd == 1) { odd += CountCrossings(p, parityRays[2]) % 2; }
+  return odd >= 2 ? kInside : kOutside;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector
+G02MappedTessellatedSolid::SurfaceNormal(const G4ThreeVector& p) const
+{
+  std::uint32_t triangle;
+  if (Nearest(p, triangle) == kInfinity) { return G4ThreeVector(0., 0., 1.); }
+  return Normal(triangle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::DistanceToIn(const G4ThreeVector& p,
+                                                 const G4ThreeVector& v) const
+{
+  G4double distance;
+  std::uint32_t triangle;
+  return Intersect(p, v, -1, distance, triangle) ? distance : kInfinity;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::DistanceToIn(const G4ThreeVector& p) const
+{
+  std::uint32_t triangle;
+  G4double safety = Nearest(p, triangle);
+  return safety > fHalfTolerance ? safety : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::DistanceToOut(const G4ThreeVector& p,
+                                                  const G4ThreeVector& v,
+                                                  const G4bool calcNorm,
+                                                  G4bool* validNorm,
+                                                  G4ThreeVector* n) const
+{
+  G4double distance;
+  std::uint32_t triangle;
+  G4bool found = Intersect(p, v, +1, distance, triangle);
+
+  // The mesh is not assumed convex: the exit normal does not guarantee
+  // that the solid is not re-entered
+  //
+  if (calcNorm)
+  {
+    if (validNorm != 0) { *validNorm = false; }
+    if (n != 0) { *n = found ? Normal(triangle) : v; }
+  }
+  return found ? distance : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::DistanceToOut(const G4ThreeVector& p) const
+{
+  std::uint32_t triangle;
+  G4double safety = Nearest(p, triangle);
+  return safety > fHalfTolerance ? safety : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::GetCubicVolume()
+{
+  return fMesh->fRecord->fCubicVolume;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MappedTessellatedSolid::GetSurfaceArea()
+{
+  return fMesh->fRecord->fSurfaceArea;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector G02MappedTessellatedSolid::GetPointOnSurface() const
+{
+  // Triangle chosen with a probability proportional to its area
+  //
+  std::uint32_t nTriangles = fMesh->fRecord->fTriangles;
+  if (nTriangles == 0) { return G4ThreeVector(); }
+
+  G4double target = G4UniformRand()*fMesh->fRecord->fSurfaceArea;
+  std::uint32_t triangle = nTriangles - 1;
+  G4double area = 0.;
+  for (std::uint32_t i = 0; i < nTriangles; ++i)
+  {
+    const std::uint32_t* index = fMesh->fTriangles + 3*i;
+    area += 0.5*(Vertex(index[1]) - Vertex(index[0]))
+                .cross(Vertex(index[2]) - Vertex(index[0])).mag();
+    if (area >= target) { triangle = i; break; }
+  }
+
+  const std::uint32_t* index = fMesh->fTriangles + 3*triangle;
+  G4double u = G4UniformRand(), w = G4UniformRand();
+  if (u + w > 1.) { u = 1. - u; w = 1. - w; }
+  G4ThreeVector a = Vertex(index[0]);
+  return a + (Vertex(index[1]) - a)*u + (Vertex(index[2]) - a)*w;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String G02MappedTessellatedSolid::GetEntityType() const
+{
+  return "G02MappedTessellatedSolid";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02MappedTessellatedSolid::Clone() const
+{
+  return new G02MappedTessellatedSolid(GetName(), fMesh);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::ostream& G02MappedTessellatedSolid::StreamInfo(std::ostream& os) const
+{
+  const G02MeshFile::MeshRecord* record = fMesh->fRecord;
+  os << "-----------------------------------------------------------\n"
+     << "    *** Dump for solid - " << GetName() << " ***\n"
+     << "    ===================================================\n"
+     << " Solid type: G02MappedTessellatedSolid\n"
+     << " Vertices: " << record->fVertices
+     << ", triangles: " << record->fTriangles
+     << ", BVH nodes: " << record->fNodes << "\n"
+     << "-----------------------------------------------------------\n";
+  return os;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MappedTessellatedSolid::DescribeYourselfTo(
+  G4VGraphicsScene& scene) const
+{
+  scene.AddSolid(*this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Polyhedron* G02MappedTessellatedSolid::CreatePolyhedron() const
+{
+  const G02MeshFile::MeshRecord* record = fMesh->fRecord;
+  G4PolyhedronArbitrary* polyhedron =
+    new G4PolyhedronArbitrary(G4int(record->fVertices),
+                              G4int(record->fTriangles));
+  for (std::uint32_t i = 0; i < record->fVertices; ++i)
+  {
+    polyhedron->AddVertex(Vertex(i));
+  }
+  for (std::uint32_t i = 0; i < record->fTriangles; ++i)
+  {
+    const std::uint32_t* index = fMesh->fTriangles + 3*i;
+    polyhedron->AddFacet(G4int(index[0])+1, G4int(index[1])+1,
+                         G4int(index[2])+1);
+  }
+  polyhedron->SetReferences();
+  return polyhedron;
+}
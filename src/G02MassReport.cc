@@ -0,0 +1,686 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02MassReport.cc
+/// \brief Implementation of the G02MassReport class
+//
+//
+//
+// Class G02MassReport implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02MassReport.hh"
+#include "G02SolidInterner.hh"
+#include "G02LazySolid.hh"
+#include "G02MappedTessellatedSolid.hh"
+#include "G02ResourceUsage.hh"
+
+#include "G4ios.hh"
+#include "G4VSolid.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4VFacet.hh"
+#include "G4BooleanSolid.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4ReflectedSolid.hh"
+#include "G4ScaledSolid.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4Material.hh"
+#include "G4RotationMatrix.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // Points of the Monte Carlo sampling done by one task
+  //
+  const G4long kChunk = 65536;
+
+  const char* const kMethodNames[] = { "exact", "mesh", "MC" };
+
+  // FNV-1a hash of the vertex coordinates
+  //
+  class Hash
+  {
+    public:
+
+      Hash() : fValue(14695981039346656037ULL) {}
+
+      void Add(G4double value)
+      {
+        unsigned char bytes[sizeof(G4double)];
+        std::memcpy(bytes, &value, sizeof(G4double));
+        for (std::size_t i = 0; i < sizeof(G4double); ++i)
+        {
+          fValue = (fValue ^ bytes[i]) * 1099511628211ULL;
+        }
+      }
+
+      std::uint64_t Value() const { return fValue; }
+
+    private:
+
+      std::uint64_t fValue;
+  };
+
+  std::string Numbers(const G4ThreeVector& translation,
+                      const G4RotationMatrix& rotation)
+  {
+    std::ostringstream out;
+    out.precision(17);
+    out << ' ' << translation.x() << ' ' << translation.y()
+        << ' ' << translation.z()
+        << ' ' << rotation.xx() << ' ' << rotation.xy() << ' ' << rotation.xz()
+        << ' ' << rotation.yx() << ' ' << rotation.yy() << ' ' << rotation.yz()
+        << ' ' << rotation.zx() << ' ' << rotation.zy() << ' ' << rotation.zz();
+    return out.str();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MassReport::G02MassReport()
+  : fPoints(1000000), fThreads(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MassReport::~G02MassReport()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4VSolid* G02MassReport::Unwrap(const G4VSolid* solid, G4double& scale)
+{
+  // Solids with the volume of their constituent, up to a scale factor
+  //
+  for (;;)
+  {
+    if (const G02LazySolid* lazy = dynamic_cast<const G02LazySolid*>(solid))
+    {
+      solid = lazy->GetSolid();
+    }
+    else if (const G4DisplacedSolid* displaced =
+               dynamic_cast<const G4DisplacedSolid*>(solid))
+    {
+      solid = displaced->GetConstituentMovedSolid();
+    }
+    else if (const G4ReflectedSolid* reflected =
+               dynamic_cast<const G4ReflectedSolid*>(solid))
+    {
+      solid = reflected->GetConstituentMovedSolid();
+    }
+    else if (const G4ScaledSolid* scaled =
+               dynamic_cast<const G4ScaledSolid*>(solid))
+    {
+      G4Scale3D transform = scaled->GetScaleTransform();
+      scale *= std::fabs(transform.xx()*transform.yy()*transform.zz());
+      solid = scaled->GetUnscaledSolid();
+    }
+    else
+    {
+      return solid;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MassReport::IsAnalytic(const G4VSolid* solid)
+{
+  // Solids whose GetCubicVolume() is a closed formula
+  //
+  static const std::set<G4String> types = {
+    "G4Box", "G4Tubs", "G4CutTubs", "G4Cons", "G4Trd", "G4Trap", "G4Para",
+    "G4Sphere", "G4Orb", "G4Torus", "G4Polycone", "G4Polyhedra", "G4Tet",
+    "G4Ellipsoid", "G4EllipticalTube", "G4EllipticalCone", "G4Hype",
+    "G4Paraboloid" };
+  return types.count(solid->GetEntityType()) != 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MassReport::TessellatedVolume(const G4VSolid* solid)
+{
+  const G02MappedTessellatedSolid* mapped =
+    dynamic_cast<const G02MappedTessellatedSolid*>(solid);
+  if (mapped != 0)
+  {
+    // Computed when the mesh file was written
+    //
+    return const_cast<G02MappedTessellatedSolid*>(mapped)->GetCubicVolume();
+  }
+
+  // Divergence theorem: sum of the signed volumes of the tetrahedra made
+  // by the origin and the triangles of the facets
+  //
+  const G4TessellatedSolid* tess =
+    static_cast<const G4TessellatedSolid*>(solid);
+  G4double volume = 0.;
+  for (G4int i = 0; i < tess->GetNumberOfFacets(); ++i)
+  {
+    const G4VFacet* facet = tess->GetFacet(i);
+    G4ThreeVector v0 = facet->GetVertex(0);
+    for (G4int k = 2; k < facet->GetNumberOfVertices(); ++k)
+    {
+      volume += v0.dot(facet->GetVertex(k-1).cross(facet->GetVertex(k)));
+    }
+  }
+  return volume/6.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string G02MassReport::Fingerprint(const G4VSolid* solid)
+{
+  if (const G02LazySolid* lazy = dynamic_cast<const G02LazySolid*>(solid))
+  {
+    return Fingerprint(lazy->GetSolid());
+  }
+
+  std::string key = G02SolidInterner::Fingerprint(solid);
+  if (!key.empty()) { return key; }
+
+  std::ostringstream out;
+  out << solid->GetEntityType();
+  if (const G4TessellatedSolid* tess =
+        dynamic_cast<const G4TessellatedSolid*>(solid))
+  {
+    Hash hash;
+    for (G4int i = 0; i < tess->GetNumberOfFacets(); ++i)
+    {
+      const G4VFacet* facet = tess->GetFacet(i);
+      for (G4int k = 0; k < facet->GetNumberOfVertices(); ++k)
+      {
+        G4ThreeVector v = facet->GetVertex(k);
+        hash.Add(v.x());
+        hash.Add(v.y());
+        hash.Add(v.z());
+      }
+    }
+    out << ' ' << tess->GetNumberOfFacets() << ' '
+        << std::hex << hash.Value();
+  }
+  else if (const G4DisplacedSolid* displaced =
+             dynamic_cast<const G4DisplacedSolid*>(solid))
+  {
+    std::string moved = Fingerprint(displaced->GetConstituentMovedSolid());
+    if (moved.empty()) { return moved; }
+    out << '(' << moved
+        << Numbers(displaced->GetObjectTranslation(),
+                   displaced->GetObjectRotation()) << ')';
+  }
+  else if (const G4BooleanSolid* boolean =
+             dynamic_cast<const G4BooleanSolid*>(solid))
+  {
+    std::string first = Fingerprint(boolean->GetConstituentSolid(0));
+    std::string second = Fingerprint(boolean->GetConstituentSolid(1));
+    if (first.empty() || second.empty()) { return std::string(); }
+    out << '(' << first << ", " << second << ')';
+  }
+  else if (const G4ScaledSolid* scaled =
+             dynamic_cast<const G4ScaledSolid*>(solid))
+  {
+    std::string unscaled = Fingerprint(scaled->GetUnscaledSolid());
+    if (unscaled.empty()) { return unscaled; }
+    G4Scale3D transform = scaled->GetScaleTransform();
+    out.precision(17);
+    out << '(' << unscaled << ' ' << transform.xx() << ' '
+        << transform.yy() << ' ' << transform.zz() << ')';
+  }
+  else
+  {
+    return std::string();
+  }
+  return out.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MassReport::Collect(const G4LogicalVolume* lv)
+{
+  if (fRows.count(lv)) { return; }
+  fRows[lv] = fRowList.size();
+
+  Row row;
+  row.fVolume = lv;
+  row.fCubicVolume = row.fError = row.fSelfMass = row.fMass = 0.;
+  row.fDaughters = row.fDisplaced = 0.;
+  row.fMethod = kAnalytic;
+  row.fMassDone = false;
+  fRowList.push_back(row);
+
+  const G4VSolid* solid = lv->GetSolid();
+  if (!fSolids.count(solid))
+  {
+    G4double scale = 1.;
+    const G4VSolid* base = Unwrap(solid, scale);
+    std::map<const G4VSolid*, std::size_t>::const_iterator known =
+      fBases.find(base);
+    std::size_t index = (known != fBases.end()) ? known->second : fItems.size();
+    if (index == fItems.size())
+    {
+      Item item;
+      item.fSolid = base;
+      item.fDone = false;
+      fItems.push_back(item);
+      fBases[base] = index;
+    }
+    fSolids[solid] = std::make_pair(index, scale);
+  }
+
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+  {
+    Collect(lv->GetDaughter(i)->GetLogicalVolume());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MassReport::Execute(Task task)
+{
+  Item& item = fItems[task.fItem];
+  if (task.fChunk < 0)
+  {
+    item.fResult.fVolume = (item.fResult.fMethod == kTessellated)
+      ? TessellatedVolume(item.fSolid)
+      : const_cast<G4VSolid*>(item.fSolid)->GetCubicVolume();
+    return;
+  }
+
+  // Reproducible sampling: the seed depends on the solid and the chunk
+  //
+  std::uint64_t seed = item.fKey.empty()
+    ? std::uint64_t(task.fItem) : std::hash<std::string>()(item.fKey);
+  G4long points = std::min(kChunk, fPoints - task.fChunk*kChunk);
+  item.fHits[task.fChunk] =
+    Sample(item.fSolid, seed, item.fMin, item.fMax, task.fChunk, points);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MassReport::Sample(const G4VSolid* solid, std::uint64_t seed,
+                               const G4ThreeVector& min,
+                               const G4ThreeVector& max,
+                               G4int chunk, G4long points)
+{
+  std::mt19937_64 engine(seed
+                         ^ (std::uint64_t(chunk+1)*0x9E3779B97F4A7C15ULL));
+  std::uniform_real_distribution<G4double> x(min.x(), max.x());
+  std::uniform_real_distribution<G4double> y(min.y(), max.y());
+  std::uniform_real_distribution<G4double> z(min.z(), max.z());
+
+  G4double hits = 0.;
+  for (G4long i = 0; i < points; ++i)
+  {
+    G4ThreeVector p(x(engine), y(engine), z(engine));
+    EInside inside = solid->Inside(p);
+    if (inside == kInside) { hits += 1.; }
+    else if (inside == kSurface) { hits += 0.5; }
+  }
+  return hits;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MassReport::CubicVolume(const G4VSolid* solid, G4long points)
+{
+  G4double scale = 1.;
+  const G4VSolid* base = Unwrap(solid, scale);
+  if (dynamic_cast<const G4TessellatedSolid*>(base) != 0
+      || dynamic_cast<const G02MappedTessellatedSolid*>(base) != 0)
+  {
+    return scale*TessellatedVolume(base);
+  }
+  if (IsAnalytic(base))
+  {
+    return scale*const_cast<G4VSolid*>(base)->GetCubicVolume();
+  }
+
+  // Same chunks and seeds as the report, which thus gives the same
+  // estimates for the solids with a fingerprint
+  //
+  std::string key = Fingerprint(base);
+  std::uint64_t seed = key.empty() ? 0 : std::hash<std::string>()(key);
+  G4ThreeVector min, max;
+  base->BoundingLimits(min, max);
+  G4double hits = 0.;
+  for (G4int c = 0; G4long(c)*kChunk < points; ++c)
+  {
+    hits += Sample(base, seed, min, max, c,
+                   std::min(kChunk, points - c*kChunk));
+  }
+  G4ThreeVector size = max - min;
+  return scale*size.x()*size.y()*size.z()*hits/points;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MassReport::ComputeMass(const G4LogicalVolume* lv,
+                                    G4double& selfMass)
+{
+  // Same sums as G4LogicalVolume::GetMass(), the masses of the logical
+  // volumes placed several times being computed once
+  //
+  Row& row = fRowList[fRows[lv]];
+  if (row.fMassDone)
+  {
+    selfMass = row.fSelfMass;
+    return row.fMass;
+  }
+
+  const G4Material* material = lv->GetMaterial();
+  G4double density = material ? material->GetDensity() : 0.;
+  G4double displaced = 0.;
+  G4double daughters = 0.;
+
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+  {
+    G4VPhysicalVolume* pv = lv->GetDaughter(i);
+    G4LogicalVolume* daughter = pv->GetLogicalVolume();
+    G4int copies = pv->GetMultiplicity();
+    G4double daughterSelf;
+    G4double daughterMass = ComputeMass(daughter, daughterSelf);
+    const Row& content = fRowList[fRows[daughter]];
+    G4VPVParameterisation* param = pv->GetParameterisation();
+    if (param != 0)
+    {
+      // Solid and material of each copy, computed by Geant4, filled with
+      // the daughters of the logical volume placed
+      //
+      for (G4int copy = 0; copy < copies; ++copy)
+      {
+        G4VSolid* solid = param->ComputeSolid(copy, pv);
+        solid->ComputeDimensions(param, copy, pv);
+        G4double volume = CubicVolume(solid, fPoints);
+        const G4Material* copyMaterial = param->ComputeMaterial(copy, pv);
+        if (copyMaterial == 0) { copyMaterial = daughter->GetMaterial(); }
+        G4double copyDensity = copyMaterial ? copyMaterial->GetDensity() : 0.;
+        displaced += volume;
+        daughters += (volume - content.fDisplaced)*copyDensity
+                   + content.fDaughters;
+      }
+    }
+    else
+    {
+      displaced += copies*content.fCubicVolume;
+      daughters += copies*daughterMass;
+    }
+  }
+
+  row.fDisplaced = displaced;
+  row.fDaughters = daughters;
+  row.fSelfMass = (row.fCubicVolume - displaced)*density;
+  row.fMass = row.fSelfMass + daughters;
+  row.fMassDone = true;
+  selfMass = row.fSelfMass;
+  return row.fMass;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MassReport::GetMass(const G4String& name) const
+{
+  for (std::size_t r = 0; r < fRowList.size(); ++r)
+  {
+    if (fRowList[r].fVolume->GetName() == name) { return fRowList[r].fMass; }
+  }
+  return -1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MassReport::Run(const G4VPhysicalVolume* world,
+                          const G4String& fileName)
+{
+  if (world == 0)
+  {
+    G4cerr << "G02MassReport: no geometry" << G4endl;
+    return false;
+  }
+  G4double startTime = G02ResourceUsage::WallTime();
+
+  fItems.clear();
+  fBases.clear();
+  fSolids.clear();
+  fRows.clear();
+  fRowList.clear();
+  Collect(world->GetLogicalVolume());
+
+  // Results of the cache, or of an identical solid of this geometry
+  //
+  G4int cached = 0;
+  std::vector<std::size_t> sameAs(fItems.size(), fItems.size());
+  std::map<std::string, std::size_t> firstOfKey;
+  std::vector<Task> tasks;
+  for (std::size_t i = 0; i < fItems.size(); ++i)
+  {
+    Item& item = fItems[i];
+    item.fKey = Fingerprint(item.fSolid);
+    if (!item.fKey.empty())
+    {
+      std::map<std::string, Result>::const_iterator hit = fCache.find(item.fKey);
+      if (hit != fCache.end()
+          && (hit->second.fMethod != kMonteCarlo
+              || hit->second.fPoints >= fPoints))
+      {
+        item.fResult = hit->second;
+        item.fDone = true;
+        ++cached;
+        continue;
+      }
+      std::map<std::string, std::size_t>::const_iterator first =
+        firstOfKey.find(item.fKey);
+      if (first != firstOfKey.end())
+      {
+        sameAs[i] = first->second;
+        continue;
+      }
+      firstOfKey[item.fKey] = i;
+    }
+
+    item.fResult.fVolume = 0.;
+    item.fResult.fError = 0.;
+    item.fResult.fPoints = 0;
+    if (dynamic_cast<const G4TessellatedSolid*>(item.fSolid) != 0
+        || dynamic_cast<const G02MappedTessellatedSolid*>(item.fSolid) != 0)
+    {
+      item.fResult.fMethod = kTessellated;
+      Task task = { i, -1 };
+      tasks.push_back(task);
+    }
+    else if (IsAnalytic(item.fSolid))
+    {
+      item.fResult.fMethod = kAnalytic;
+      Task task = { i, -1 };
+      tasks.push_back(task);
+    }
+    else
+    {
+      item.fResult.fMethod = kMonteCarlo;
+      item.fResult.fPoints = fPoints;
+      item.fSolid->BoundingLimits(item.fMin, item.fMax);
+      G4int chunks = G4int((fPoints + kChunk - 1)/kChunk);
+      item.fHits.assign(chunks, 0.);
+      for (G4int c = 0; c < chunks; ++c)
+      {
+        Task task = { i, c };
+        tasks.push_back(task);
+      }
+    }
+  }
+
+  // The tasks are taken in turn by the threads of the pool; each one
+  // writes the result of its own solid or chunk only. The solids are
+  // only read (Inside(), facets), as by the worker threads of a run,
+  // except for the caching of GetCubicVolume(), done by one task.
+  //
+  G4int nThreads = fThreads > 0 ? fThreads : G4Threading::G4GetNumberOfCores();
+  nThreads = std::max(1, std::min(nThreads, G4int(tasks.size())));
+  std::atomic<std::size_t> next(0);
+  auto work = [this, &tasks, &next]()
+  {
+    for (std::size_t t = next++; t < tasks.size(); t = next++)
+    {
+      Execute(tasks[t]);
+    }
+  };
+  if (nThreads == 1)
+  {
+    work();
+  }
+  else
+  {
+    std::vector<std::thread> pool;
+    for (G4int t = 0; t < nThreads; ++t) { pool.push_back(std::thread(work)); }
+    for (std::size_t t = 0; t < pool.size(); ++t) { pool[t].join(); }
+  }
+
+  G4int counts[3] = { 0, 0, 0 };
+  for (std::size_t i = 0; i < fItems.size(); ++i)
+  {
+    Item& item = fItems[i];
+    if (item.fDone || sameAs[i] != fItems.size()) { continue; }
+    if (item.fResult.fMethod == kMonteCarlo)
+    {
+      G4double hits = 0.;
+      for (std::size_t c = 0; c < item.fHits.size(); ++c)
+      {
+        hits += item.fHits[c];
+      }
+      G4ThreeVector size = item.fMax - item.fMin;
+      G4double box = size.x()*size.y()*size.z();
+      G4double fraction = hits/fPoints;
+      item.fResult.fVolume = box*fraction;
+      item.fResult.fError =
+        box*std::sqrt(fraction*(1.-fraction)/fPoints);
+    }
+    ++counts[item.fResult.fMethod];
+    item.fDone = true;
+    if (!item.fKey.empty()) { fCache[item.fKey] = item.fResult; }
+  }
+  for (std::size_t i = 0; i < fItems.size(); ++i)
+  {
+    if (sameAs[i] != fItems.size())
+    {
+      fItems[i].fResult = fItems[sameAs[i]].fResult;
+      ++cached;
+    }
+  }
+
+  for (std::size_t r = 0; r < fRowList.size(); ++r)
+  {
+    Row& row = fRowList[r];
+    const std::pair<std::size_t, G4double>& solid =
+      fSolids[row.fVolume->GetSolid()];
+    const Result& result = fItems[solid.first].fResult;
+    row.fCubicVolume = result.fVolume*solid.second;
+    row.fError = result.fError*solid.second;
+    row.fMethod = result.fMethod;
+  }
+  G4double selfMass;
+  G4double totalMass = ComputeMass(world->GetLogicalVolume(), selfMass);
+  G4double wallTime = G02ResourceUsage::WallTime() - startTime;
+
+  // Output
+  //
+  G4cout << G4endl
+         << "=================== Volume and mass report ==================="
+         << G4endl
+         << std::setw(24) << std::left << " Logical volume"
+         << std::setw(20) << "Solid" << std::setw(16) << "Material"
+         << std::right << std::setw(7) << "Method"
+         << std::setw(14) << "Volume [cm3]" << std::setw(12) << "+- [cm3]"
+         << std::setw(12) << "Mass [kg]" << std::setw(16) << "+daughters [kg]"
+         << G4endl;
+  for (std::size_t r = 0; r < fRowList.size(); ++r)
+  {
+    const Row& row = fRowList[r];
+    const G4Material* material = row.fVolume->GetMaterial();
+    G4cout << std::setw(24) << std::left << " " + row.fVolume->GetName()
+           << std::setw(20) << row.fVolume->GetSolid()->GetEntityType()
+           << std::setw(16) << (material ? material->GetName() : G4String("-"))
+           << std::right << std::setw(7) << kMethodNames[row.fMethod]
+           << std::setprecision(6)
+           << std::setw(14) << row.fCubicVolume/cm3
+           << std::setw(12) << row.fError/cm3
+           << std::setw(12) << row.fSelfMass/kg
+           << std::setw(16) << row.fMass/kg << G4endl;
+  }
+  G4cout << " " << fRowList.size() << " logical volumes, " << fItems.size()
+         << " solids: " << counts[kAnalytic] << " exact, "
+         << counts[kTessellated] << " tessellated, "
+         << counts[kMonteCarlo] << " Monte Carlo (" << fPoints
+         << " points), " << cached << " from the cache" << G4endl
+         << " Total mass " << totalMass/kg << " kg, computed in "
+         << std::setprecision(3) << wallTime << " s with " << nThreads
+         << " threads" << std::setprecision(6) << G4endl
+         << "=============================================================="
+         << G4endl << G4endl;
+
+  if (fileName.empty()) { return true; }
+
+  std::ofstream out(fileName);
+  if (!out)
+  {
+    G4cerr << "G02MassReport: cannot open report file " << fileName << G4endl;
+    return false;
+  }
+  out.precision(10);
+  out << "volume,solid,material,method,cubic_volume_cm3,error_cm3,"
+      << "density_g_cm3,mass_kg,mass_with_daughters_kg\n";
+  for (std::size_t r = 0; r < fRowList.size(); ++r)
+  {
+    const Row& row = fRowList[r];
+    const G4Material* material = row.fVolume->GetMaterial();
+    out << '"' << row.fVolume->GetName() << "\",\""
+        << row.fVolume->GetSolid()->GetEntityType() << "\",\""
+        << (material ? material->GetName() : G4String()) << "\","
+        << kMethodNames[row.fMethod] << ','
+        << row.fCubicVolume/cm3 << ',' << row.fError/cm3 << ','
+        << (material ? material->GetDensity()/(g/cm3) : 0.) << ','
+        << row.fSelfMass/kg << ',' << row.fMass/kg << '\n';
+  }
+  G4cout << "Volume and mass report written to " << fileName << G4endl;
+  return bool(out);
+}
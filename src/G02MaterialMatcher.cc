@@ -0,0 +1,186 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02MaterialMatcher.cc
+/// \brief Implementation of the G02MaterialMatcher class
+//
+//
+//
+// Class G02MaterialMatcher implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02MaterialMatcher.hh"
+
+#include "G4ios.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4IonisParamMat.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MaterialMatcher::G02MaterialMatcher()
+  : fMaterials(0), fReused(0), fVolumes(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MaterialMatcher::~G02MaterialMatcher()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MaterialMatcher::Close(G4double a, G4double b)
+{
+  // Values written to and read from GDML differ in the last digits
+  //
+  return std::fabs(a-b) <= 1.e-9*std::max(std::fabs(a), std::fabs(b));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MaterialMatcher::Identical(const G4Element* a, const G4Element* b)
+{
+  if (a == b) { return true; }
+  return a->GetName() == b->GetName()
+      && Close(a->GetZ(), b->GetZ())
+      && Close(a->GetN(), b->GetN())
+      && Close(a->GetA(), b->GetA());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MaterialMatcher::Identical(const G4Material* a, const G4Material* b)
+{
+  if (a == b) { return true; }
+
+  // Materials carrying more than their composition are kept apart
+  //
+  if (a->GetMaterialPropertiesTable() != 0
+   || b->GetMaterialPropertiesTable() != 0) { return false; }
+  if (a->GetBaseMaterial() != 0 || b->GetBaseMaterial() != 0) { return false; }
+  if (a->GetChemicalFormula() != b->GetChemicalFormula()) { return false; }
+
+  if (a->GetName() != b->GetName()
+   || a->GetState() != b->GetState()
+   || !Close(a->GetDensity(), b->GetDensity())
+   || !Close(a->GetTemperature(), b->GetTemperature())
+   || !Close(a->GetPressure(), b->GetPressure())
+   || !Close(a->GetIonisation()->GetMeanExcitationEnergy(),
+             b->GetIonisation()->GetMeanExcitationEnergy())) { return false; }
+
+  std::size_t nElements = a->GetNumberOfElements();
+  if (nElements != b->GetNumberOfElements()) { return false; }
+
+  const G4double* fractionsA = a->GetFractionVector();
+  const G4double* fractionsB = b->GetFractionVector();
+  for (std::size_t i = 0; i < nElements; ++i)
+  {
+    if (!Identical(a->GetElement(G4int(i)), b->GetElement(G4int(i)))
+     || !Close(fractionsA[i], fractionsB[i])) { return false; }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4Material* G02MaterialMatcher::Earliest(const G4Material* material)
+{
+  std::map<const G4Material*, const G4Material*>::const_iterator it
+    = fMatches.find(material);
+  if (it != fMatches.end()) { return it->second; }
+
+  // The table is in order of creation; the material itself ends the search
+  //
+  const G4Material* earliest = material;
+  const G4MaterialTable* table = G4Material::GetMaterialTable();
+  for (std::size_t i = 0; i < table->size(); ++i)
+  {
+    const G4Material* candidate = (*table)[i];
+    if (candidate == material) { break; }
+    if (Identical(candidate, material))
+    {
+      earliest = candidate;
+      break;
+    }
+  }
+
+  ++fMaterials;
+  if (earliest != material) { ++fReused; }
+  return fMatches[material] = earliest;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02MaterialMatcher::Match(G4VPhysicalVolume* world)
+{
+  fMatches.clear();
+  fMaterials = 0;
+  fReused = 0;
+  fVolumes = 0;
+  if (world == 0) { return 0; }
+
+  std::set<G4LogicalVolume*> visited;
+  std::vector<G4LogicalVolume*> pending(1, world->GetLogicalVolume());
+  while (!pending.empty())
+  {
+    G4LogicalVolume* lv = pending.back();
+    pending.pop_back();
+    if (!visited.insert(lv).second) { continue; }
+
+    G4Material* material = lv->GetMaterial();
+    if (material != 0)
+    {
+      const G4Material* earliest = Earliest(material);
+      if (earliest != material)
+      {
+        lv->SetMaterial(const_cast<G4Material*>(earliest));
+        ++fVolumes;
+      }
+    }
+    for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+    {
+      pending.push_back(lv->GetDaughter(i)->GetLogicalVolume());
+    }
+  }
+  return fVolumes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MaterialMatcher::PrintReport() const
+{
+  G4cout << "G02MaterialMatcher: " << fReused << " of " << fMaterials
+         << " materials reused from the previous geometries ("
+         << fVolumes << " logical volumes updated)" << G4endl;
+}
@@ -0,0 +1,533 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02MeshFile.cc
+/// \brief Implementation of the G02MeshFile class
+//
+//
+//
+// Class G02MeshFile implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02MeshFile.hh"
+#include "G02LazySolid.hh"
+
+#include "G4ios.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4VFacet.hh"
+#include "G4GeometryTolerance.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+
+#if !defined(_WIN32)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  const char magic[8] = { 'G','0','2','M','E','S','H','1' };
+  const std::uint32_t version = 1;
+  const std::uint32_t leafSize = 4;
+
+  inline std::uint64_t Align(std::uint64_t offset)
+  {
+    return (offset + 7) & ~std::uint64_t(7);
+  }
+
+  // Mesh of one solid, as written
+  //
+  struct MeshData
+  {
+    G4String name;
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> triangles;
+    std::vector<double> normals;
+    std::vector<G02MeshFile::Node> nodes;
+    G02MeshFile::MeshRecord record;
+  };
+
+  G4ThreeVector Vertex(const MeshData& mesh, std::uint32_t index)
+  {
+    return G4ThreeVector(mesh.vertices[3*index], mesh.vertices[3*index+1],
+                         mesh.vertices[3*index+2]);
+  }
+
+  // Builds the BVH of triangles [begin, end) of "order", sorting them so
+  // that the leaves hold contiguous ranges; returns the node index
+  //
+  std::uint32_t BuildNode(MeshData& mesh,
+                          std::vector<std::uint32_t>& order,
+                          const std::vector<G4ThreeVector>& centroids,
+                          std::uint32_t begin, std::uint32_t end)
+  {
+    G02MeshFile::Node node;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      node.fMin[k] = kInfinity;
+      node.fMax[k] = -kInfinity;
+    }
+    G4ThreeVector cmin(kInfinity, kInfinity, kInfinity);
+    G4ThreeVector cmax(-kInfinity, -kInfinity, -kInfinity);
+    for (std::uint32_t i = begin; i < end; ++i)
+    {
+      for (G4int j = 0; j < 3; ++j)
+      {
+        G4ThreeVector v = Vertex(mesh, mesh.triangles[3*order[i]+j]);
+        for (G4int k = 0; k < 3; ++k)
+        {
+          node.fMin[k] = std::min(node.fMin[k], v[k]);
+          node.fMax[k] = std::max(node.fMax[k], v[k]);
+        }
+      }
+      const G4ThreeVector& c = centroids[order[i]];
+      for (G4int k = 0; k < 3; ++k)
+      {
+        cmin[k] = std::min(cmin[k], c[k]);
+        cmax[k] = std::max(cmax[k], c[k]);
+      }
+    }
+
+    std::uint32_t index = std::uint32_t(mesh.nodes.size());
+    mesh.nodes.push_back(node);
+
+    G4ThreeVector extent = cmax - cmin;
+    G4int axis = (extent.x() > extent.y())
+               ? (extent.x() > extent.z() ? 0 : 2)
+               : (extent.y() > extent.z() ? 1 : 2);
+    if (end - begin <= leafSize || extent[axis] <= 0.)
+    {
+      mesh.nodes[index].fFirst = begin;
+      mesh.nodes[index].fCount = end - begin;
+      return index;
+    }
+
+    // Median split along the longest extent of the centroids
+    //
+    std::uint32_t middle = begin + (end - begin)/2;
+    std::nth_element(order.begin()+begin, order.begin()+middle,
+                     order.begin()+end,
+                     [&](std::uint32_t a, std::uint32_t b)
+                     { return centroids[a][axis] < centroids[b][axis]; });
+
+    BuildNode(mesh, order, centroids, begin, middle);
+    std::uint32_t second = BuildNode(mesh, order, centroids, middle, end);
+    mesh.nodes[index].fFirst = second;
+    mesh.nodes[index].fCount = 0;
+    return index;
+  }
+
+  void BuildMesh(const G4TessellatedSolid* solid, MeshData& mesh)
+  {
+    mesh.name = solid->GetName();
+
+    // Vertex pool, without duplicates; quadrangles are split
+    //
+    std::map<std::tuple<double,double,double>, std::uint32_t> pool;
+    std::vector<std::uint32_t> triangles;
+    for (G4int i = 0; i < solid->GetNumberOfFacets(); ++i)
+    {
+      const G4VFacet* facet = solid->GetFacet(i);
+      G4int n = facet->GetNumberOfVertices();
+      std::uint32_t indices[4];
+      for (G4int j = 0; j < n && j < 4; ++j)
+      {
+        G4ThreeVector v = facet->GetVertex(j);
+        std::tuple<double,double,double> key(v.x(), v.y(), v.z());
+        auto it = pool.find(key);
+        if (it == pool.end())
+        {
+          it = pool.insert(std::make_pair(key,
+                 std::uint32_t(mesh.vertices.size()/3))).first;
+          mesh.vertices.push_back(v.x());
+          mesh.vertices.push_back(v.y());
+          mesh.vertices.push_back(v.z());
+        }
+        indices[j] = it->second;
+      }
+      for (G4int j = 2; j < n && j < 4; ++j)
+      {
+        triangles.push_back(indices[0]);
+        triangles.push_back(indices[j-1]);
+        triangles.push_back(indices[j]);
+      }
+    }
+    mesh.triangles = triangles;
+
+    std::uint32_t nTriangles = std::uint32_t(triangles.size()/3);
+    std::vector<G4ThreeVector> centroids(nTriangles);
+    std::vector<std::uint32_t> order(nTriangles);
+    for (std::uint32_t t = 0; t < nTriangles; ++t)
+    {
+      centroids[t] = (Vertex(mesh, triangles[3*t]) + Vertex(mesh, triangles[3*t+1])
+                    + Vertex(mesh, triangles[3*t+2]))/3.;
+      order[t] = t;
+    }
+    if (nTriangles > 0)
+    {
+      BuildNode(mesh, order, centroids, 0, nTriangles);
+    }
+
+    // Triangles in the order of the leaves, with their outward normals
+    //
+    G02MeshFile::MeshRecord& record = mesh.record;
+    std::memset(&record, 0, sizeof(record));
+    for (G4int k = 0; k < 3; ++k)
+    {
+      record.fMin[k] = kInfinity;
+      record.fMax[k] = -kInfinity;
+    }
+    for (std::uint32_t i = 0; i < nTriangles; ++i)
+    {
+      std::uint32_t t = order[i];
+      G4ThreeVector v[3];
+      for (G4int j = 0; j < 3; ++j)
+      {
+        mesh.triangles[3*i+j] = triangles[3*t+j];
+        v[j] = Vertex(mesh, triangles[3*t+j]);
+        for (G4int k = 0; k < 3; ++k)
+        {
+          record.fMin[k] = std::min(record.fMin[k], v[j][k]);
+          record.fMax[k] = std::max(record.fMax[k], v[j][k]);
+        }
+      }
+      G4ThreeVector cross = (v[1]-v[0]).cross(v[2]-v[0]);
+      G4ThreeVector normal = cross.unit();
+      mesh.normals.push_back(normal.x());
+      mesh.normals.push_back(normal.y());
+      mesh.normals.push_back(normal.z());
+      record.fSurfaceArea += 0.5*cross.mag();
+      record.fCubicVolume += v[0].dot(v[1].cross(v[2]))/6.;
+    }
+    record.fNameLength = std::uint32_t(mesh.name.size());
+    record.fVertices = std::uint32_t(mesh.vertices.size()/3);
+    record.fTriangles = nTriangles;
+    record.fNodes = std::uint32_t(mesh.nodes.size());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MeshFile::Write(const G4String& fileName,
+                         const std::vector<const G4TessellatedSolid*>& solids)
+{
+  std::vector<MeshData> meshes(solids.size());
+  for (std::size_t i = 0; i < solids.size(); ++i)
+  {
+    BuildMesh(solids[i], meshes[i]);
+  }
+
+  // Layout
+  //
+  Header header;
+  std::memcpy(header.fMagic, magic, sizeof(magic));
+  header.fVersion = version;
+  header.fMeshes = std::uint32_t(meshes.size());
+  header.fMeshTableOffset = Align(sizeof(Header));
+
+  std::uint64_t offset = header.fMeshTableOffset
+                       + meshes.size()*sizeof(MeshRecord);
+  for (std::size_t i = 0; i < meshes.size(); ++i)
+  {
+    MeshRecord& record = meshes[i].record;
+    record.fNameOffset = offset = Align(offset);
+    offset += record.fNameLength;
+    record.fVerticesOffset = offset = Align(offset);
+    offset += 3*sizeof(double)*record.fVertices;
+    record.fTrianglesOffset = offset = Align(offset);
+    offset += 3*sizeof(std::uint32_t)*record.fTriangles;
+    record.fNormalsOffset = offset = Align(offset);
+    offset += 3*sizeof(double)*record.fTriangles;
+    record.fNodesOffset = offset = Align(offset);
+    offset += sizeof(Node)*record.fNodes;
+  }
+  header.fFileSize = Align(offset);
+
+  std::ofstream out(fileName, std::ios::binary);
+  if (!out)
+  {
+    G4cerr << "G02MeshFile: cannot open " << fileName << G4endl;
+    return false;
+  }
+
+  std::uint64_t position = 0;
+  auto put = [&](std::uint64_t at, const void* data, std::size_t size)
+  {
+    static const char zeros[8] = { 0 };
+    out.write(zeros, std::streamsize(at - position));
+    out.write(static_cast<const char*>(data), std::streamsize(size));
+    position = at + size;
+  };
+
+  put(0, &header, sizeof(header));
+  for (std::size_t i = 0; i < meshes.size(); ++i)
+  {
+    put(header.fMeshTableOffset + i*sizeof(MeshRecord),
+        &meshes[i].record, sizeof(MeshRecord));
+  }
+  for (std::size_t i = 0; i < meshes.size(); ++i)
+  {
+    const MeshData& mesh = meshes[i];
+    const MeshRecord& record = mesh.record;
+    put(record.fNameOffset, mesh.name.data(), mesh.name.size());
+    put(record.fVerticesOffset, mesh.vertices.data(),
+        mesh.vertices.size()*sizeof(double));
+    put(record.fTrianglesOffset, mesh.triangles.data(),
+        mesh.triangles.size()*sizeof(std::uint32_t));
+    put(record.fNormalsOffset, mesh.normals.data(),
+        mesh.normals.size()*sizeof(double));
+    put(record.fNodesOffset, mesh.nodes.data(),
+        mesh.nodes.size()*sizeof(Node));
+  }
+  put(header.fFileSize, 0, 0);
+
+  return bool(out);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G02MeshFile* G02MeshFile::Map(const G4String& fileName)
+{
+  // The mappings live until the end of the job: the solids using them
+  // are not tracked
+  //
+  static std::map<G4String, G02MeshFile*> files;
+
+  std::map<G4String, G02MeshFile*>::const_iterator it = files.find(fileName);
+  if (it != files.end()) { return it->second; }
+
+  G02MeshFile* file = new G02MeshFile(fileName);
+  if (!file->Open() || !file->Validate())
+  {
+    delete file;
+    return 0;
+  }
+  files[fileName] = file;
+  return file;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MeshFile::G02MeshFile(const G4String& fileName)
+  : fFileName(fileName), fData(0), fSize(0), fMapped(false)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MeshFile::~G02MeshFile()
+{
+  if (fData == 0) { return; }
+#if !defined(_WIN32)
+  if (fMapped)
+  {
+    munmap(const_cast<char*>(fData), fSize);
+    return;
+  }
+#endif
+  delete [] fData;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MeshFile::Open()
+{
+#if !defined(_WIN32)
+  int fd = open(fFileName.c_str(), O_RDONLY);
+  struct stat info;
+  if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size > 0)
+  {
+    // Read-only shared mapping: the page cache is shared between processes
+    //
+    void* data = mmap(0, std::size_t(info.st_size), PROT_READ, MAP_SHARED,
+                      fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+      G4cerr << "G02MeshFile: cannot map " << fFileName << G4endl;
+      return false;
+    }
+    fData = static_cast<const char*>(data);
+    fSize = std::size_t(info.st_size);
+    fMapped = true;
+    return true;
+  }
+  if (fd >= 0) { close(fd); }
+  G4cerr << "G02MeshFile: cannot open " << fFileName << G4endl;
+  return false;
+#else
+  // No shared mapping: the file is read in the memory of the process
+  //
+  std::ifstream in(fFileName, std::ios::binary | std::ios::ate);
+  if (!in)
+  {
+    G4cerr << "G02MeshFile: cannot open " << fFileName << G4endl;
+    return false;
+  }
+  fSize = std::size_t(in.tellg());
+  char* data = new char[fSize];
+  in.seekg(0);
+  in.read(data, std::streamsize(fSize));
+  fData = data;
+  return bool(in);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MeshFile::Validate()
+{
+  const Header* header = reinterpret_cast<const Header*>(fData);
+  if (fSize < sizeof(Header)
+   || std::memcmp(header->fMagic, magic, sizeof(magic)) != 0
+   || header->fVersion != version
+   || header->fFileSize != fSize
+   || header->fMeshTableOffset % 8 != 0
+   || header->fMeshTableOffset + header->fMeshes*sizeof(MeshRecord) > fSize)
+  {
+    G4cerr << "G02MeshFile: " << fFileName << " is not a valid mesh file"
+           << G4endl;
+    return false;
+  }
+
+  const MeshRecord* records = reinterpret_cast<const MeshRecord*>(
+    fData + header->fMeshTableOffset);
+  for (std::uint32_t i = 0; i < header->fMeshes; ++i)
+  {
+    const MeshRecord& record = records[i];
+    G4bool valid =
+         record.fNameOffset + record.fNameLength <= fSize
+      && record.fVerticesOffset % 8 == 0
+      && record.fVerticesOffset + 3*sizeof(double)*record.fVertices <= fSize
+      && record.fTrianglesOffset % 8 == 0
+      && record.fTrianglesOffset
+         + 3*sizeof(std::uint32_t)*record.fTriangles <= fSize
+      && record.fNormalsOffset % 8 == 0
+      && record.fNormalsOffset + 3*sizeof(double)*record.fTriangles <= fSize
+      && record.fNodesOffset % 8 == 0
+      && record.fNodesOffset + sizeof(Node)*record.fNodes <= fSize;
+
+    Mesh mesh;
+    mesh.fRecord = &record;
+    mesh.fVertices = reinterpret_cast<const double*>(
+      fData + record.fVerticesOffset);
+    mesh.fTriangles = reinterpret_cast<const std::uint32_t*>(
+      fData + record.fTrianglesOffset);
+    mesh.fNormals = reinterpret_cast<const double*>(
+      fData + record.fNormalsOffset);
+    mesh.fNodes = reinterpret_cast<const Node*>(fData + record.fNodesOffset);
+
+    // Indices are checked once here, not at each use
+    //
+    for (std::uint32_t t = 0; valid && t < 3*record.fTriangles; ++t)
+    {
+      valid = mesh.fTriangles[t] < record.fVertices;
+    }
+    // The children follow their parents, so the depth of a node is known
+    // when it is reached; a node with several parents takes the deepest
+    //
+    std::vector<G4int> depth(valid ? record.fNodes : 0, 0);
+    for (std::uint32_t n = 0; valid && n < record.fNodes; ++n)
+    {
+      const Node& node = mesh.fNodes[n];
+      valid = node.fCount > 0
+            ? node.fFirst + node.fCount <= record.fTriangles
+            : node.fFirst > n && node.fFirst < record.fNodes
+              && depth[n] < kMaxDepth;
+      if (valid && node.fCount == 0)
+      {
+        depth[n+1] = std::max(depth[n+1], depth[n] + 1);
+        depth[node.fFirst] = std::max(depth[node.fFirst], depth[n] + 1);
+      }
+    }
+    if (!valid)
+    {
+      G4cerr << "G02MeshFile: corrupted mesh " << i << " in " << fFileName
+             << G4endl;
+      return false;
+    }
+
+    // Read only once the record is known to lie in the file
+    //
+    mesh.fName.assign(fData + record.fNameOffset, record.fNameLength);
+    fMeshes[mesh.fName] = mesh;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G02MeshFile::Mesh* G02MeshFile::Find(const G4String& name) const
+{
+  std::map<G4String, Mesh>::const_iterator it = fMeshes.find(name);
+  return it != fMeshes.end() ? &it->second : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MeshFile::Matches(const Mesh& mesh, const G4VSolid* solid)
+{
+  // Triangles counted as in the file, the quadrangles being split
+  //
+  G4int triangles = -1;
+  if (const G02LazySolid* lazy = dynamic_cast<const G02LazySolid*>(solid))
+  {
+    triangles = lazy->GetNumberOfTriangles();
+  }
+  else if (const G4TessellatedSolid* tessellated
+             = dynamic_cast<const G4TessellatedSolid*>(solid))
+  {
+    triangles = 0;
+    for (G4int i = 0; i < tessellated->GetNumberOfFacets(); ++i)
+    {
+      G4int n = tessellated->GetFacet(i)->GetNumberOfVertices();
+      triangles += std::max(0, std::min(n, 4) - 2);
+    }
+  }
+  if (triangles != G4int(mesh.fRecord->fTriangles)) { return false; }
+
+  G4ThreeVector pMin, pMax;
+  solid->BoundingLimits(pMin, pMax);
+  const G4double tolerance =
+    G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  for (G4int k = 0; k < 3; ++k)
+  {
+    if (std::abs(pMin[k] - mesh.fRecord->fMin[k]) > tolerance
+     || std::abs(pMax[k] - mesh.fRecord->fMax[k]) > tolerance)
+    {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,488 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02MeshSimplifier.cc
+/// \brief Implementation of the G02MeshSimplifier class
+//
+//
+//
+// Class G02MeshSimplifier implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02MeshSimplifier.hh"
+
+#include "G4ios.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4VFacet.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MeshSimplifier::G02MeshSimplifier()
+  : fTargetFacets(0), fTolerance(0.), fAliveFaces(0),
+    fFacetsBefore(0), fFacetsAfter(0),
+    fVolumeBefore(0.), fVolumeAfter(0.), fMaxError(0.)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MeshSimplifier::~G02MeshSimplifier()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MeshSimplifier::AddPlane(Quadric& q, const G4ThreeVector& n,
+                                 G4double d)
+{
+  G4double* a = q.fQ;
+  a[0] += n.x()*n.x(); a[1] += n.x()*n.y(); a[2] += n.x()*n.z();
+  a[3] += n.x()*d;     a[4] += n.y()*n.y(); a[5] += n.y()*n.z();
+  a[6] += n.y()*d;     a[7] += n.z()*n.z(); a[8] += n.z()*d;
+  a[9] += d*d;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MeshSimplifier::Error(const Quadric& q, const G4ThreeVector& p)
+{
+  const G4double* a = q.fQ;
+  G4double x = p.x(), y = p.y(), z = p.z();
+  G4double e = a[0]*x*x + 2.*a[1]*x*y + 2.*a[2]*x*z + 2.*a[3]*x
+             + a[4]*y*y + 2.*a[5]*y*z + 2.*a[6]*y
+             + a[7]*z*z + 2.*a[8]*z
+             + a[9];
+  return std::max(e, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MeshSimplifier::Load(const G4TessellatedSolid* solid)
+{
+  fVertices.clear();
+  fFaces.clear();
+
+  // The vertices shared by facets are written with the same coordinates
+  //
+  std::map<std::tuple<double,double,double>, G4int> pool;
+  std::vector<G4int> index;
+  for (G4int i = 0; i < solid->GetNumberOfFacets(); ++i)
+  {
+    const G4VFacet* facet = solid->GetFacet(i);
+    G4int n = facet->GetNumberOfVertices();
+    index.resize(n);
+    for (G4int j = 0; j < n; ++j)
+    {
+      G4ThreeVector p = facet->GetVertex(j);
+      std::pair<std::map<std::tuple<double,double,double>, G4int>::iterator,
+                G4bool> res
+        = pool.insert(std::make_pair(std::make_tuple(p.x(), p.y(), p.z()),
+                                     G4int(fVertices.size())));
+      if (res.second)
+      {
+        Vertex vertex;
+        vertex.fPosition = p;
+        std::fill(vertex.fQuadric.fQ, vertex.fQuadric.fQ+10, 0.);
+        vertex.fVersion = 0;
+        vertex.fAlive = true;
+        fVertices.push_back(vertex);
+      }
+      index[j] = res.first->second;
+    }
+
+    // Quadrangles are split along their first diagonal
+    //
+    for (G4int k = 1; k+1 < n; ++k)
+    {
+      Face face;
+      face.fV[0] = index[0];
+      face.fV[1] = index[k];
+      face.fV[2] = index[k+1];
+      face.fAlive = face.fV[0] != face.fV[1] && face.fV[1] != face.fV[2]
+                 && face.fV[2] != face.fV[0];
+      if (face.fAlive) { fFaces.push_back(face); }
+    }
+  }
+  fFacetsBefore = G4int(fFaces.size());
+
+  // Quadrics of the planes of the facets
+  //
+  for (std::size_t f = 0; f < fFaces.size(); ++f)
+  {
+    const G4int* v = fFaces[f].fV;
+    const G4ThreeVector& a = fVertices[v[0]].fPosition;
+    G4ThreeVector normal = (fVertices[v[1]].fPosition - a)
+                    .cross(fVertices[v[2]].fPosition - a);
+    for (G4int k = 0; k < 3; ++k)
+    {
+      fVertices[v[k]].fFaces.push_back(G4int(f));
+    }
+    if (normal.mag2() == 0.) { continue; }
+    normal = normal.unit();
+    for (G4int k = 0; k < 3; ++k)
+    {
+      AddPlane(fVertices[v[k]].fQuadric, normal, -normal.dot(a));
+    }
+  }
+  fAliveFaces = G4int(fFaces.size());
+  return !fFaces.empty();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MeshSimplifier::IsClosedManifold() const
+{
+  // Each oriented edge is used once, and its reverse once
+  //
+  std::map<std::pair<G4int,G4int>, G4int> edges;
+  for (std::size_t f = 0; f < fFaces.size(); ++f)
+  {
+    const G4int* v = fFaces[f].fV;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      if (++edges[std::make_pair(v[k], v[(k+1)%3])] > 1) { return false; }
+    }
+  }
+  std::map<std::pair<G4int,G4int>, G4int>::const_iterator it;
+  for (it = edges.begin(); it != edges.end(); ++it)
+  {
+    if (edges.count(std::make_pair(it->first.second, it->first.first)) == 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MeshSimplifier::Neighbours(G4int u, std::vector<G4int>& neighbours) const
+{
+  neighbours.clear();
+  const std::vector<G4int>& faces = fVertices[u].fFaces;
+  for (std::size_t i = 0; i < faces.size(); ++i)
+  {
+    const G4int* v = fFaces[faces[i]].fV;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      if (v[k] != u) { neighbours.push_back(v[k]); }
+    }
+  }
+  std::sort(neighbours.begin(), neighbours.end());
+  neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                   neighbours.end());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02MeshSimplifier::Candidate G02MeshSimplifier::Evaluate(G4int u, G4int v) const
+{
+  const Vertex& vu = fVertices[u];
+  const Vertex& vv = fVertices[v];
+
+  Quadric q;
+  for (G4int k = 0; k < 10; ++k)
+  {
+    q.fQ[k] = vu.fQuadric.fQ[k] + vv.fQuadric.fQ[k];
+  }
+
+  Candidate candidate;
+  candidate.fU = u;
+  candidate.fV = v;
+  candidate.fVersionU = vu.fVersion;
+  candidate.fVersionV = vv.fVersion;
+
+  // The minimum of the quadric, when its matrix is well conditioned and
+  // the point stays close to the edge; else the best of the end points
+  // and the middle of the edge
+  //
+  const G4double* a = q.fQ;
+  G4double det = a[0]*(a[4]*a[7] - a[5]*a[5])
+               - a[1]*(a[1]*a[7] - a[5]*a[2])
+               + a[2]*(a[1]*a[5] - a[4]*a[2]);
+  G4double trace = (a[0] + a[4] + a[7])/3.;
+  G4ThreeVector middle = 0.5*(vu.fPosition + vv.fPosition);
+  G4double length = (vu.fPosition - vv.fPosition).mag();
+  if (std::fabs(det) > 1.e-9*trace*trace*trace)
+  {
+    G4double bx = -a[3], by = -a[6], bz = -a[8];
+    G4ThreeVector p(( bx*(a[4]*a[7] - a[5]*a[5])
+                    - a[1]*(by*a[7] - a[5]*bz)
+                    + a[2]*(by*a[5] - a[4]*bz))/det,
+                    ( a[0]*(by*a[7] - bz*a[5])
+                    - bx*(a[1]*a[7] - a[5]*a[2])
+                    + a[2]*(a[1]*bz - by*a[2]))/det,
+                    ( a[0]*(a[4]*bz - a[5]*by)
+                    - a[1]*(a[1]*bz - by*a[2])
+                    + bx*(a[1]*a[5] - a[4]*a[2]))/det);
+    if ((p - middle).mag() <= length)
+    {
+      candidate.fPosition = p;
+      candidate.fCost = Error(q, p);
+      return candidate;
+    }
+  }
+
+  const G4ThreeVector* points[3] = { &vu.fPosition, &vv.fPosition, &middle };
+  candidate.fCost = -1.;
+  for (G4int k = 0; k < 3; ++k)
+  {
+    G4double cost = Error(q, *points[k]);
+    if (candidate.fCost < 0. || cost < candidate.fCost)
+    {
+      candidate.fCost = cost;
+      candidate.fPosition = *points[k];
+    }
+  }
+  return candidate;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02MeshSimplifier::CanCollapse(G4int u, G4int v,
+                                      const G4ThreeVector& position) const
+{
+  // Link condition: the two vertices share the two opposite vertices of
+  // the edge only, otherwise the collapse pinches the surface
+  //
+  std::vector<G4int> nu, nv, common;
+  Neighbours(u, nu);
+  Neighbours(v, nv);
+  std::set_intersection(nu.begin(), nu.end(), nv.begin(), nv.end(),
+                        std::back_inserter(common));
+  if (common.size() != 2) { return false; }
+
+  // The facets kept must not turn over, nor become degenerate
+  //
+  const G4int ends[2] = { u, v };
+  for (G4int e = 0; e < 2; ++e)
+  {
+    const std::vector<G4int>& faces = fVertices[ends[e]].fFaces;
+    for (std::size_t i = 0; i < faces.size(); ++i)
+    {
+      const G4int* f = fFaces[faces[i]].fV;
+      G4bool removed = (f[0] == u || f[1] == u || f[2] == u)
+                    && (f[0] == v || f[1] == v || f[2] == v);
+      if (removed) { continue; }
+
+      G4ThreeVector p[3], q[3];
+      for (G4int k = 0; k < 3; ++k)
+      {
+        p[k] = fVertices[f[k]].fPosition;
+        q[k] = (f[k] == ends[e]) ? position : p[k];
+      }
+      G4ThreeVector before = (p[1] - p[0]).cross(p[2] - p[0]);
+      G4ThreeVector after = (q[1] - q[0]).cross(q[2] - q[0]);
+      if (after.dot(before) <= 0.2*after.mag()*before.mag()) { return false; }
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MeshSimplifier::Collapse(G4int u, G4int v,
+                                 const G4ThreeVector& position)
+{
+  Vertex& vu = fVertices[u];
+  Vertex& vv = fVertices[v];
+
+  vu.fPosition = position;
+  for (G4int k = 0; k < 10; ++k) { vu.fQuadric.fQ[k] += vv.fQuadric.fQ[k]; }
+
+  // The two facets of the edge go, the other facets of v move to u
+  //
+  for (std::size_t i = 0; i < vv.fFaces.size(); ++i)
+  {
+    Face& face = fFaces[vv.fFaces[i]];
+    if (!face.fAlive) { continue; }
+    if (face.fV[0] == u || face.fV[1] == u || face.fV[2] == u)
+    {
+      face.fAlive = false;
+      --fAliveFaces;
+      continue;
+    }
+    for (G4int k = 0; k < 3; ++k)
+    {
+      if (face.fV[k] == v) { face.fV[k] = u; }
+    }
+    vu.fFaces.push_back(vv.fFaces[i]);
+  }
+
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < vu.fFaces.size(); ++i)
+  {
+    if (fFaces[vu.fFaces[i]].fAlive) { vu.fFaces[n++] = vu.fFaces[i]; }
+  }
+  vu.fFaces.resize(n);
+  ++vu.fVersion;
+
+  vv.fAlive = false;
+  std::vector<G4int>().swap(vv.fFaces);
+
+  // The opposite vertices of the edge lose the two facets removed
+  //
+  std::vector<G4int> neighbours;
+  Neighbours(u, neighbours);
+  for (std::size_t i = 0; i < neighbours.size(); ++i)
+  {
+    std::vector<G4int>& faces = fVertices[neighbours[i]].fFaces;
+    n = 0;
+    for (std::size_t j = 0; j < faces.size(); ++j)
+    {
+      if (fFaces[faces[j]].fAlive) { faces[n++] = faces[j]; }
+    }
+    faces.resize(n);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02MeshSimplifier::Decimate()
+{
+  std::priority_queue<Candidate> heap;
+  for (std::size_t f = 0; f < fFaces.size(); ++f)
+  {
+    const G4int* v = fFaces[f].fV;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      // Each edge once: it is oriented the other way in its other facet
+      //
+      if (v[k] < v[(k+1)%3]) { heap.push(Evaluate(v[k], v[(k+1)%3])); }
+    }
+  }
+
+  G4double tolerance2 = fTolerance*fTolerance;
+  std::vector<G4int> neighbours;
+  while (!heap.empty())
+  {
+    // A tetrahedron cannot be simplified further
+    //
+    if (fTargetFacets > 0 && fAliveFaces <= fTargetFacets) { break; }
+    if (fAliveFaces <= 4) { break; }
+
+    Candidate candidate = heap.top();
+    heap.pop();
+
+    // Entries of removed vertices, or computed before a vertex moved
+    //
+    const Vertex& vu = fVertices[candidate.fU];
+    const Vertex& vv = fVertices[candidate.fV];
+    if (!vu.fAlive || !vv.fAlive
+     || vu.fVersion != candidate.fVersionU
+     || vv.fVersion != candidate.fVersionV) { continue; }
+
+    if (fTolerance > 0. && candidate.fCost > tolerance2) { break; }
+    if (!CanCollapse(candidate.fU, candidate.fV, candidate.fPosition))
+    {
+      continue;
+    }
+
+    Collapse(candidate.fU, candidate.fV, candidate.fPosition);
+    fMaxError = std::max(fMaxError, std::sqrt(candidate.fCost));
+
+    Neighbours(candidate.fU, neighbours);
+    for (std::size_t i = 0; i < neighbours.size(); ++i)
+    {
+      heap.push(Evaluate(candidate.fU, neighbours[i]));
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02MeshSimplifier::Volume() const
+{
+  G4double volume = 0.;
+  for (std::size_t f = 0; f < fFaces.size(); ++f)
+  {
+    if (!fFaces[f].fAlive) { continue; }
+    const G4int* v = fFaces[f].fV;
+    volume += fVertices[v[0]].fPosition.dot(
+                fVertices[v[1]].fPosition.cross(fVertices[v[2]].fPosition));
+  }
+  return volume/6.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4TessellatedSolid*
+G02MeshSimplifier::Simplify(const G4TessellatedSolid* solid,
+                            const G4String& name)
+{
+  fFacetsBefore = fFacetsAfter = 0;
+  fVolumeBefore = fVolumeAfter = fMaxError = 0.;
+  if (fTargetFacets <= 0 && fTolerance <= 0.) { return 0; }
+
+  if (!Load(solid)) { return 0; }
+  if (!IsClosedManifold())
+  {
+    G4ExceptionDescription msg;
+    msg << "Surface of solid " << solid->GetName() << " not closed or not"
+        << " 2-manifold; it is not simplified.";
+    G4Exception("G02MeshSimplifier::Simplify()", "G02Simplifier001",
+                JustWarning, msg);
+    fVertices.clear();
+    fFaces.clear();
+    return 0;
+  }
+
+  fVolumeBefore = Volume();
+  Decimate();
+  fVolumeAfter = Volume();
+  fFacetsAfter = fAliveFaces;
+
+  // Both counts are in triangles: a solid made of quadrangles gives no
+  // result unless the decimation removed triangles
+  //
+  G4TessellatedSolid* result = 0;
+  if (fFacetsAfter < fFacetsBefore)
+  {
+    result = new G4TessellatedSolid(name);
+    for (std::size_t f = 0; f < fFaces.size(); ++f)
+    {
+      if (!fFaces[f].fAlive) { continue; }
+      const G4int* v = fFaces[f].fV;
+      result->AddFacet(new G4TriangularFacet(fVertices[v[0]].fPosition,
+                                             fVertices[v[1]].fPosition,
+                                             fVertices[v[2]].fPosition,
+                                             ABSOLUTE));
+    }
+    result->SetSolidClosed(true);
+  }
+
+  std::vector<Vertex>().swap(fVertices);
+  std::vector<Face>().swap(fFaces);
+  return result;
+}
@@ -0,0 +1,200 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02NavigationBenchmark.cc
+/// \brief Implementation of the G02NavigationBenchmark class
+//
+//
+//
+// Class G02NavigationBenchmark implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02NavigationBenchmark.hh"
+#include "G02ResourceUsage.hh"
+
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+  // Uniform deviate in [0,1) from the 53 high bits of a 64-bit engine
+  // output: unlike std::uniform_real_distribution, the sequence does not
+  // depend on the standard library implementation
+  //
+  inline G4double Uniform(std::mt19937_64& engine)
+  {
+    return G4double(engine() >> 11) * (1.0/9007199254740992.0);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02NavigationBenchmark::Result::Result()
+  : fLocateCalls(0), fLocateTime(0.),
+    fStepCalls(0), fStepTime(0.),
+    fRelocateCalls(0), fRelocateTime(0.),
+    fPathLength(0.), fTruncatedRays(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02NavigationBenchmark::G02NavigationBenchmark(G4VPhysicalVolume* world)
+  : fWorld(world),
+    fNavigator(0),
+    fMaxSteps(100000),
+    fTimerOverhead(0.)
+{
+  fNavigator = new G4Navigator();
+  fNavigator->SetWorldVolume(fWorld);
+  fTimerOverhead = MeasureTimerOverhead();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02NavigationBenchmark::~G02NavigationBenchmark()
+{
+  delete fNavigator;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02NavigationBenchmark::GenerateRays(G4int nRays, G4long seed)
+{
+  std::mt19937_64 engine(seed);
+
+  G4ThreeVector pMin, pMax;
+  fWorld->GetLogicalVolume()->GetSolid()->BoundingLimits(pMin, pMax);
+
+  // Keep the origins off the world surface
+  //
+  G4ThreeVector centre = 0.5*(pMin + pMax);
+  G4ThreeVector halfSize = 0.499*(pMax - pMin);
+
+  fRays.resize(nRays);
+  for (G4int i = 0; i < nRays; ++i)
+  {
+    Ray& ray = fRays[i];
+    ray.fPosition = G4ThreeVector(
+      centre.x() + (2.*Uniform(engine) - 1.)*halfSize.x(),
+      centre.y() + (2.*Uniform(engine) - 1.)*halfSize.y(),
+      centre.z() + (2.*Uniform(engine) - 1.)*halfSize.z());
+
+    G4double cosTheta = 2.*Uniform(engine) - 1.;
+    G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+    G4double phi = twopi*Uniform(engine);
+    ray.fDirection = G4ThreeVector(sinTheta*std::cos(phi),
+                                   sinTheta*std::sin(phi), cosTheta);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02NavigationBenchmark::MeasureTimerOverhead() const
+{
+  const G4int nCalls = 100000;
+  G4double sum = 0.;
+  G4double start = G02ResourceUsage::WallTime();
+  for (G4int i = 0; i < nCalls; ++i)
+  {
+    G4double t0 = G02ResourceUsage::WallTime();
+    sum += G02ResourceUsage::WallTime() - t0;
+  }
+  G4double total = G02ResourceUsage::WallTime() - start;
+
+  // Each timed call costs about two clock reads; "sum" is what the timers
+  // themselves attribute to an empty call
+  //
+  return std::min(sum, total)/nCalls;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02NavigationBenchmark::Result G02NavigationBenchmark::Run()
+{
+  Result result;
+
+  for (std::size_t i = 0; i < fRays.size(); ++i)
+  {
+    G4ThreeVector position = fRays[i].fPosition;
+    const G4ThreeVector& direction = fRays[i].fDirection;
+
+    // Full location from the top, with a fresh history
+    //
+    fNavigator->ResetStackAndState();
+    G4double t0 = G02ResourceUsage::WallTime();
+    G4VPhysicalVolume* volume =
+      fNavigator->LocateGlobalPointAndSetup(position, &direction, false);
+    result.fLocateTime += G02ResourceUsage::WallTime() - t0;
+    ++result.fLocateCalls;
+
+    G4int nSteps = 0;
+    while (volume != 0)
+    {
+      if (nSteps++ == fMaxSteps)
+      {
+        ++result.fTruncatedRays;
+        break;
+      }
+
+      G4double safety = 0.;
+      t0 = G02ResourceUsage::WallTime();
+      G4double step =
+        fNavigator->ComputeStep(position, direction, kInfinity, safety);
+      result.fStepTime += G02ResourceUsage::WallTime() - t0;
+      ++result.fStepCalls;
+
+      if (step == kInfinity) { break; }
+      result.fPathLength += step;
+      position += step*direction;
+
+      // Crossing of the boundary, as done by the transportation
+      //
+      fNavigator->SetGeometricallyLimitedStep();
+      t0 = G02ResourceUsage::WallTime();
+      volume = fNavigator->LocateGlobalPointAndSetup(position, &direction,
+                                                     true);
+      result.fRelocateTime += G02ResourceUsage::WallTime() - t0;
+      ++result.fRelocateCalls;
+    }
+  }
+
+  result.fLocateTime =
+    std::max(0., result.fLocateTime - fTimerOverhead*result.fLocateCalls);
+  result.fStepTime =
+    std::max(0., result.fStepTime - fTimerOverhead*result.fStepCalls);
+  result.fRelocateTime =
+    std::max(0., result.fRelocateTime - fTimerOverhead*result.fRelocateCalls);
+
+  return result;
+}
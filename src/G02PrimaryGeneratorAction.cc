@@ -33,18 +33,80 @@
 // ----------------------------------------------------------------------------
 
 #include "G02PrimaryGeneratorAction.hh"
+#include "G02PrimaryGeneratorMessenger.hh"
 
 #include "globals.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4AutoLock.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#if !defined(_WIN32)
+#  include <sys/stat.h>
+#endif
+
+namespace
+{
+  // Rays read from file, shared by the generators of all threads. A buffer
+  // is never modified once published: reading a file again publishes a new
+  // one, while the generators still holding the previous one keep it alive
+  //
+  G4Mutex rayFileMutex = G4MUTEX_INITIALIZER;
+  G4String rayFileName;
+  std::time_t rayFileTime = 0;
+  std::shared_ptr<const G02RayBuffer> rayFileBuffer;
+
+  // Modification time of a file, 0 if unknown
+  //
+  std::time_t ModificationTime(const G4String& fileName)
+  {
+#if !defined(_WIN32)
+    struct stat status;
+    if (stat(fileName.c_str(), &status) == 0) { return status.st_mtime; }
+#endif
+    return 0;
+  }
+
+  // Counter-based generator: the value only depends on the seed and on
+  // the ray number, whatever the thread and event order
+  //
+  inline G4double Uniform(G4long seed, G4long index, G4int stream)
+  {
+    unsigned long long z = (unsigned long long)(seed)
+                         + 0x9E3779B97F4A7C15ULL*(2ULL*index + stream + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return G4double(z >> 11) * (1.0/9007199254740992.0);
+  }
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G02PrimaryGeneratorAction::G02PrimaryGeneratorAction()
  : G4VUserPrimaryGeneratorAction(),
    fParticleGun(0),
-   fParticleTable(0)
-   
+   fParticleTable(0),
+   fMessenger(0),
+   fScanMode(kGun),
+   fRaysPerEvent(1000),
+   fPosition(0.,0.,0.),
+   fDirection(0.,0.,1.),
+   fGridNx(100), fGridNy(100),
+   fGridHalfWidth(1.*m),
+   fSphereRays(100000),
+   fEtaBins(100), fPhiBins(64),
+   fEtaMin(-5.), fEtaMax(5.),
+   fSeed(12345),
+   fWarnedEndOfScan(false)
 {
   // Particle gun and particle table 
   //
@@ -63,12 +125,14 @@ G02PrimaryGeneratorAction::G02PrimaryGeneratorAction()
   fParticleGun->SetParticleMomentumDirection(err2v);
   fParticleGun->SetParticlePosition(err1);
 
+  fMessenger = new G02PrimaryGeneratorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G02PrimaryGeneratorAction::~G02PrimaryGeneratorAction()
 {
+  delete fMessenger;
   delete fParticleGun;
 }
 
@@ -76,5 +140,244 @@ G02PrimaryGeneratorAction::~G02PrimaryGeneratorAction()
 
 void G02PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
-  fParticleGun->GeneratePrimaryVertex(anEvent);
+  if (fScanMode == kGun)
+  {
+    fParticleGun->GeneratePrimaryVertex(anEvent);
+    return;
+  }
+
+  // Rays of this event
+  //
+  G4long first = G4long(anEvent->GetEventID())*fRaysPerEvent;
+  G4long nRays = std::min(G4long(fRaysPerEvent), GetNumberOfRays() - first);
+  if (nRays <= 0)
+  {
+    if (!fWarnedEndOfScan)
+    {
+      G4cout << "G02PrimaryGeneratorAction: all the " << GetNumberOfRays()
+             << " rays of the scan are generated; further events are empty."
+             << G4endl;
+      fWarnedEndOfScan = true;
+    }
+    return;
+  }
+
+  fBuffer.Resize(fRaysPerEvent);
+  switch (fScanMode)
+  {
+    case kGrid:   FillGrid(first, G4int(nRays)); break;
+    case kSphere: FillSphere(first, G4int(nRays)); break;
+    case kEtaPhi: FillEtaPhi(first, G4int(nRays)); break;
+    case kFile:   FillFromFile(first, G4int(nRays)); break;
+    default: break;
+  }
+
+  // One vertex per ray: the primaries get the track IDs 1..nRays in order
+  //
+  G4ParticleDefinition* particle = fParticleGun->GetParticleDefinition();
+  G4double energy = fParticleGun->GetParticleEnergy();
+  for (G4int k = 0; k < nRays; ++k)
+  {
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(fBuffer.GetPosition(k), 0.);
+    G4PrimaryParticle* primary = new G4PrimaryParticle(particle);
+    primary->SetKineticEnergy(energy);
+    primary->SetMomentumDirection(fBuffer.GetDirection(k));
+    vertex->SetPrimary(primary);
+    anEvent->AddPrimaryVertex(vertex);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimaryGeneratorAction::SetScanMode(const G4String& mode)
+{
+  if      (mode == "gun")    { fScanMode = kGun; }
+  else if (mode == "grid")   { fScanMode = kGrid; }
+  else if (mode == "sphere") { fScanMode = kSphere; }
+  else if (mode == "etaphi") { fScanMode = kEtaPhi; }
+  else if (mode == "file")   { fScanMode = kFile; }
+  fWarnedEndOfScan = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long G02PrimaryGeneratorAction::GetNumberOfRays() const
+{
+  switch (fScanMode)
+  {
+    case kGrid:   return G4long(fGridNx)*fGridNy;
+    case kSphere: return fSphereRays;
+    case kEtaPhi: return G4long(fEtaBins)*fPhiBins;
+    case kFile:   return fRayFile ? G4long(fRayFile->Size()) : 0;
+    default:      return 1;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimaryGeneratorAction::FillGrid(G4long first, G4int n)
+{
+  // Parallel rays along the direction, from a grid of nx*ny points in the
+  // plane through the position orthogonal to it
+  //
+  G4ThreeVector u = fDirection.orthogonal().unit();
+  G4ThreeVector v = fDirection.cross(u);
+  G4double du = fGridNx > 1 ? 2.*fGridHalfWidth/(fGridNx-1) : 0.;
+  G4double dv = fGridNy > 1 ? 2.*fGridHalfWidth/(fGridNy-1) : 0.;
+  G4double u0 = fGridNx > 1 ? -fGridHalfWidth : 0.;
+  G4double v0 = fGridNy > 1 ? -fGridHalfWidth : 0.;
+
+  G4double* x = fBuffer.X();
+  G4double* y = fBuffer.Y();
+  G4double* z = fBuffer.Z();
+  G4double* dx = fBuffer.Dx();
+  G4double* dy = fBuffer.Dy();
+  G4double* dz = fBuffer.Dz();
+  for (G4int k = 0; k < n; ++k)
+  {
+    G4long index = first + k;
+    G4double a = u0 + du*G4double(index % fGridNx);
+    G4double b = v0 + dv*G4double(index / fGridNx);
+    x[k] = fPosition.x() + a*u.x() + b*v.x();
+    y[k] = fPosition.y() + a*u.y() + b*v.y();
+    z[k] = fPosition.z() + a*u.z() + b*v.z();
+    dx[k] = fDirection.x();
+    dy[k] = fDirection.y();
+    dz[k] = fDirection.z();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimaryGeneratorAction::FillSphere(G4long first, G4int n)
+{
+  // Isotropic rays from the position
+  //
+  G4double* x = fBuffer.X();
+  G4double* y = fBuffer.Y();
+  G4double* z = fBuffer.Z();
+  G4double* dx = fBuffer.Dx();
+  G4double* dy = fBuffer.Dy();
+  G4double* dz = fBuffer.Dz();
+  for (G4int k = 0; k < n; ++k)
+  {
+    G4long index = first + k;
+    G4double cosTheta = 2.*Uniform(fSeed, index, 0) - 1.;
+    G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+    G4double phi = twopi*Uniform(fSeed, index, 1);
+    x[k] = fPosition.x();
+    y[k] = fPosition.y();
+    z[k] = fPosition.z();
+    dx[k] = sinTheta*std::cos(phi);
+    dy[k] = sinTheta*std::sin(phi);
+    dz[k] = cosTheta;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimaryGeneratorAction::FillEtaPhi(G4long first, G4int n)
+{
+  // Rays from the position through the centres of the eta/phi bins;
+  // eta runs fastest, phi covers [-pi,pi)
+  //
+  G4double dEta = (fEtaMax - fEtaMin)/fEtaBins;
+  G4double dPhi = twopi/fPhiBins;
+
+  G4double* x = fBuffer.X();
+  G4double* y = fBuffer.Y();
+  G4double* z = fBuffer.Z();
+  G4double* dx = fBuffer.Dx();
+  G4double* dy = fBuffer.Dy();
+  G4double* dz = fBuffer.Dz();
+  for (G4int k = 0; k < n; ++k)
+  {
+    G4long index = first + k;
+    G4double eta = fEtaMin + dEta*(G4double(index % fEtaBins) + 0.5);
+    G4double phi = -pi + dPhi*(G4double(index / fEtaBins) + 0.5);
+    G4double cosTheta = std::tanh(eta);
+    G4double sinTheta = 1./std::cosh(eta);
+    x[k] = fPosition.x();
+    y[k] = fPosition.y();
+    z[k] = fPosition.z();
+    dx[k] = sinTheta*std::cos(phi);
+    dy[k] = sinTheta*std::sin(phi);
+    dz[k] = cosTheta;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimaryGeneratorAction::FillFromFile(G4long first, G4int n)
+{
+  for (G4int k = 0; k < n; ++k)
+  {
+    fBuffer.Set(k, fRayFile->GetPosition(first + k),
+                   fRayFile->GetDirection(first + k));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimaryGeneratorAction::SetRayFile(const G4String& fileName)
+{
+  // Text file, one ray per line: x y z [mm] and direction dx dy dz.
+  // Empty lines and lines starting with '#' are skipped. The file is read
+  // by the first thread asking for it; the other threads share its rays,
+  // unless the file was modified since, in which case it is read again.
+  //
+  G4AutoLock lock(&rayFileMutex);
+  std::time_t fileTime = ModificationTime(fileName);
+  if (rayFileBuffer && fileName == rayFileName && fileTime == rayFileTime)
+  {
+    fRayFile = rayFileBuffer;
+    return;
+  }
+
+  std::ifstream in(fileName);
+  if (!in)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open ray file " << fileName;
+    G4Exception("G02PrimaryGeneratorAction::SetRayFile()", "G02Gen001",
+                JustWarning, ed);
+    return;
+  }
+
+  std::vector<G4ThreeVector> positions, directions;
+  std::string line;
+  G4int lineNumber = 0;
+  while (std::getline(in, line))
+  {
+    ++lineNumber;
+    std::size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line[start] == '#') { continue; }
+
+    std::istringstream fields(line);
+    G4double x, y, z, dx, dy, dz;
+    if (!(fields >> x >> y >> z >> dx >> dy >> dz))
+    {
+      G4ExceptionDescription ed;
+      ed << "Malformed line " << lineNumber << " in ray file " << fileName;
+      G4Exception("G02PrimaryGeneratorAction::SetRayFile()", "G02Gen002",
+                  JustWarning, ed);
+      return;
+    }
+    positions.push_back(G4ThreeVector(x, y, z)*mm);
+    directions.push_back(G4ThreeVector(dx, dy, dz).unit());
+  }
+
+  std::shared_ptr<G02RayBuffer> buffer(new G02RayBuffer);
+  buffer->Resize(positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i)
+  {
+    buffer->Set(i, positions[i], directions[i]);
+  }
+  rayFileBuffer = buffer;
+  rayFileName = fileName;
+  rayFileTime = fileTime;
+  fRayFile = rayFileBuffer;
+
+  G4cout << "G02PrimaryGeneratorAction: " << positions.size()
+         << " rays read from " << fileName << G4endl;
 }
@@ -0,0 +1,234 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02PrimaryGeneratorMessenger.cc
+/// \brief Implementation of the G02PrimaryGeneratorMessenger class
+//
+//
+//
+// Class G02PrimaryGeneratorMessenger implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "globals.hh"
+
+#include "G02PrimaryGeneratorMessenger.hh"
+#include "G02PrimaryGeneratorAction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWith3Vector.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02PrimaryGeneratorMessenger::
+G02PrimaryGeneratorMessenger( G02PrimaryGeneratorAction* myGen )
+  : G4UImessenger(),
+    fTheGenerator( myGen ),
+    fTheGeneratorDir(0),
+    fTheModeCommand(0),
+    fTheRaysPerEventCommand(0),
+    fThePositionCommand(0),
+    fTheDirectionCommand(0),
+    fTheGridPointsCommand(0),
+    fTheGridHalfWidthCommand(0),
+    fTheSphereRaysCommand(0),
+    fTheEtaPhiPointsCommand(0),
+    fTheEtaRangeCommand(0),
+    fTheSeedCommand(0),
+    fTheRayFileCommand(0)
+{
+  fTheGeneratorDir = new G4UIdirectory( "/mygen/" );
+  fTheGeneratorDir->SetGuidance("Primary generator control.");
+
+  fTheModeCommand = new G4UIcmdWithAString("/mygen/mode", this);
+  fTheModeCommand ->SetGuidance("Select the generation mode");
+  fTheModeCommand ->SetGuidance("  gun    : one geantino per event from the particle gun");
+  fTheModeCommand ->SetGuidance("  grid   : parallel rays from a grid of points");
+  fTheModeCommand ->SetGuidance("  sphere : isotropic rays from a point");
+  fTheModeCommand ->SetGuidance("  etaphi : rays from a point on an eta/phi grid");
+  fTheModeCommand ->SetGuidance("  file   : rays read from /mygen/rayFile");
+  fTheModeCommand ->SetParameterName("Mode", false);
+  fTheModeCommand ->SetCandidates("gun grid sphere etaphi file");
+  fTheModeCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheRaysPerEventCommand = new G4UIcmdWithAnInteger("/mygen/raysPerEvent", this);
+  fTheRaysPerEventCommand ->SetGuidance("Number of rays (primaries) per event in the scan modes");
+  fTheRaysPerEventCommand ->SetParameterName("K", false);
+  fTheRaysPerEventCommand ->SetRange("K>=1");
+  fTheRaysPerEventCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fThePositionCommand = new G4UIcmdWith3VectorAndUnit("/mygen/position", this);
+  fThePositionCommand ->SetGuidance("Grid centre, or origin of the isotropic rays");
+  fThePositionCommand ->SetParameterName("X", "Y", "Z", false);
+  fThePositionCommand ->SetDefaultUnit("mm");
+  fThePositionCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheDirectionCommand = new G4UIcmdWith3Vector("/mygen/direction", this);
+  fTheDirectionCommand ->SetGuidance("Direction of the grid rays");
+  fTheDirectionCommand ->SetParameterName("Dx", "Dy", "Dz", false);
+  fTheDirectionCommand ->SetRange("Dx != 0 || Dy != 0 || Dz != 0");
+  fTheDirectionCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheGridPointsCommand = new G4UIcommand("/mygen/gridPoints", this);
+  fTheGridPointsCommand ->SetGuidance("Number of grid points along the two axes of the plane");
+  G4UIparameter* nxParam = new G4UIparameter("Nx", 'i', false);
+  nxParam ->SetParameterRange("Nx>=1");
+  fTheGridPointsCommand ->SetParameter(nxParam);
+  G4UIparameter* nyParam = new G4UIparameter("Ny", 'i', false);
+  nyParam ->SetParameterRange("Ny>=1");
+  fTheGridPointsCommand ->SetParameter(nyParam);
+  fTheGridPointsCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheGridHalfWidthCommand = new G4UIcmdWithADoubleAndUnit("/mygen/gridHalfWidth", this);
+  fTheGridHalfWidthCommand ->SetGuidance("Half width of the square grid");
+  fTheGridHalfWidthCommand ->SetParameterName("HalfWidth", false);
+  fTheGridHalfWidthCommand ->SetRange("HalfWidth>=0");
+  fTheGridHalfWidthCommand ->SetUnitCategory("Length");
+  fTheGridHalfWidthCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheSphereRaysCommand = new G4UIcmdWithAnInteger("/mygen/sphereRays", this);
+  fTheSphereRaysCommand ->SetGuidance("Number of isotropic rays of the sphere scan");
+  fTheSphereRaysCommand ->SetParameterName("N", false);
+  fTheSphereRaysCommand ->SetRange("N>=1");
+  fTheSphereRaysCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheEtaPhiPointsCommand = new G4UIcommand("/mygen/etaPhiPoints", this);
+  fTheEtaPhiPointsCommand ->SetGuidance("Number of eta and phi bins of the eta/phi scan");
+  G4UIparameter* nEtaParam = new G4UIparameter("NEta", 'i', false);
+  nEtaParam ->SetParameterRange("NEta>=1");
+  fTheEtaPhiPointsCommand ->SetParameter(nEtaParam);
+  G4UIparameter* nPhiParam = new G4UIparameter("NPhi", 'i', false);
+  nPhiParam ->SetParameterRange("NPhi>=1");
+  fTheEtaPhiPointsCommand ->SetParameter(nPhiParam);
+  fTheEtaPhiPointsCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheEtaRangeCommand = new G4UIcommand("/mygen/etaRange", this);
+  fTheEtaRangeCommand ->SetGuidance("Pseudorapidity range of the eta/phi scan");
+  fTheEtaRangeCommand ->SetParameter(new G4UIparameter("EtaMin", 'd', false));
+  fTheEtaRangeCommand ->SetParameter(new G4UIparameter("EtaMax", 'd', false));
+  fTheEtaRangeCommand ->SetRange("EtaMax>EtaMin");
+  fTheEtaRangeCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheSeedCommand = new G4UIcmdWithAnInteger("/mygen/seed", this);
+  fTheSeedCommand ->SetGuidance("Seed of the isotropic rays");
+  fTheSeedCommand ->SetParameterName("Seed", false);
+  fTheSeedCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheRayFileCommand = new G4UIcmdWithAString("/mygen/rayFile", this);
+  fTheRayFileCommand ->SetGuidance("Read the rays of the file scan mode");
+  fTheRayFileCommand ->SetGuidance("One ray per line: x y z [mm] dx dy dz");
+  fTheRayFileCommand ->SetParameterName("FileName", false);
+  fTheRayFileCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02PrimaryGeneratorMessenger::~G02PrimaryGeneratorMessenger()
+{
+  delete fTheRayFileCommand;
+  delete fTheSeedCommand;
+  delete fTheEtaRangeCommand;
+  delete fTheEtaPhiPointsCommand;
+  delete fTheSphereRaysCommand;
+  delete fTheGridHalfWidthCommand;
+  delete fTheGridPointsCommand;
+  delete fTheDirectionCommand;
+  delete fThePositionCommand;
+  delete fTheRaysPerEventCommand;
+  delete fTheModeCommand;
+  delete fTheGeneratorDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimaryGeneratorMessenger::SetNewValue( G4UIcommand* command,
+                                                G4String newValue )
+{
+  if ( command == fTheModeCommand )
+  {
+    fTheGenerator->SetScanMode(newValue);
+  }
+  if ( command == fTheRaysPerEventCommand )
+  {
+    fTheGenerator->SetRaysPerEvent(
+      fTheRaysPerEventCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fThePositionCommand )
+  {
+    fTheGenerator->SetPosition(
+      fThePositionCommand->GetNew3VectorValue(newValue));
+  }
+  if ( command == fTheDirectionCommand )
+  {
+    fTheGenerator->SetDirection(
+      fTheDirectionCommand->GetNew3VectorValue(newValue));
+  }
+  if ( command == fTheGridPointsCommand )
+  {
+    G4int nx = 1, ny = 1;
+    std::istringstream is(newValue);
+    is >> nx >> ny;
+    fTheGenerator->SetGridPoints(nx, ny);
+  }
+  if ( command == fTheGridHalfWidthCommand )
+  {
+    fTheGenerator->SetGridHalfWidth(
+      fTheGridHalfWidthCommand->GetNewDoubleValue(newValue));
+  }
+  if ( command == fTheSphereRaysCommand )
+  {
+    fTheGenerator->SetSphereRays(
+      fTheSphereRaysCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fTheEtaPhiPointsCommand )
+  {
+    G4int nEta = 1, nPhi = 1;
+    std::istringstream is(newValue);
+    is >> nEta >> nPhi;
+    fTheGenerator->SetEtaPhiPoints(nEta, nPhi);
+  }
+  if ( command == fTheEtaRangeCommand )
+  {
+    G4double etaMin = 0., etaMax = 0.;
+    std::istringstream is(newValue);
+    is >> etaMin >> etaMax;
+    fTheGenerator->SetEtaRange(etaMin, etaMax);
+  }
+  if ( command == fTheSeedCommand )
+  {
+    fTheGenerator->SetSeed(fTheSeedCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fTheRayFileCommand )
+  {
+    fTheGenerator->SetRayFile(newValue);
+  }
+}
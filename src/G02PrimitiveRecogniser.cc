@@ -0,0 +1,694 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02PrimitiveRecogniser.cc
+/// \brief Implementation of the G02PrimitiveRecogniser class
+//
+//
+//
+// Class G02PrimitiveRecogniser implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02PrimitiveRecogniser.hh"
+#include "G02LazySolid.hh"
+
+#include "G4ios.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4VFacet.hh"
+#include "G4Box.hh"
+#include "G4Orb.hh"
+#include "G4Sphere.hh"
+#include "G4Tubs.hh"
+#include "G4Cons.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4RotationMatrix.hh"
+#include "G4Transform3D.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // Normals closer than this (component-wise) share a cluster
+  //
+  const G4double kNormalQuantum = 1.e-6;
+
+  std::tuple<long,long,long> NormalKey(const G4ThreeVector& n)
+  {
+    return std::make_tuple(std::lround(n.x()/kNormalQuantum),
+                           std::lround(n.y()/kNormalQuantum),
+                           std::lround(n.z()/kNormalQuantum));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02PrimitiveRecogniser::G02PrimitiveRecogniser()
+  : fEnabled(false), fTolerance(0.2*mm),
+    fVolume(0.), fArea(0.), fSize(0.),
+    fExamined(0), fDeferred(0), fFacetsRemoved(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02PrimitiveRecogniser::~G02PrimitiveRecogniser()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02PrimitiveRecogniser::Run(std::map<G4VSolid*, G4VSolid*>& replacements)
+{
+  fExamined = fDeferred = fFacetsRemoved = 0;
+  fReplacedByType.clear();
+  fReplaced.clear();
+
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < lvStore->size(); ++i)
+  {
+    G4VSolid* solid = (*lvStore)[i]->GetSolid();
+    if (replacements.count(solid) != 0) { continue; }
+
+    const G4TessellatedSolid* tessellated
+      = dynamic_cast<const G4TessellatedSolid*>(solid);
+    if (const G02LazySolid* lazy = dynamic_cast<const G02LazySolid*>(solid))
+    {
+      // Building a stand-in to examine it would cancel the lazy reading
+      //
+      if (!lazy->IsBuilt())
+      {
+        ++fDeferred;
+        continue;
+      }
+      tessellated = dynamic_cast<const G4TessellatedSolid*>(lazy->GetSolid());
+    }
+    if (tessellated == 0) { continue; }
+
+    ++fExamined;
+    G4VSolid* primitive = Recognise(tessellated, solid->GetName());
+    if (primitive == 0) { continue; }
+
+    replacements[solid] = primitive;
+    fFacetsRemoved += tessellated->GetNumberOfFacets();
+    ++fReplacedByType[fLastType];
+    fReplaced.push_back(std::make_pair(solid->GetName(), fLastType));
+  }
+  return G4int(fReplaced.size());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02PrimitiveRecogniser::Load(const G4TessellatedSolid* solid)
+{
+  fVertices.clear();
+  fTriangles.clear();
+  fClusters.clear();
+  fVolume = fArea = 0.;
+
+  std::map<std::tuple<double,double,double>, G4int> pool;
+  std::vector<G4int> index;
+  G4ThreeVector lower(kInfinity, kInfinity, kInfinity);
+  G4ThreeVector upper = -lower;
+  for (G4int i = 0; i < solid->GetNumberOfFacets(); ++i)
+  {
+    const G4VFacet* facet = solid->GetFacet(i);
+    G4int n = facet->GetNumberOfVertices();
+    index.resize(n);
+    for (G4int j = 0; j < n; ++j)
+    {
+      G4ThreeVector p = facet->GetVertex(j);
+      std::pair<std::map<std::tuple<double,double,double>, G4int>::iterator,
+                G4bool> res
+        = pool.insert(std::make_pair(std::make_tuple(p.x(), p.y(), p.z()),
+                                     G4int(fVertices.size())));
+      if (res.second)
+      {
+        fVertices.push_back(p);
+        for (G4int k = 0; k < 3; ++k)
+        {
+          lower[k] = std::min(lower[k], p[k]);
+          upper[k] = std::max(upper[k], p[k]);
+        }
+      }
+      index[j] = res.first->second;
+    }
+
+    for (G4int k = 1; k+1 < n; ++k)
+    {
+      Triangle t;
+      t.fV[0] = index[0];
+      t.fV[1] = index[k];
+      t.fV[2] = index[k+1];
+      const G4ThreeVector& a = fVertices[t.fV[0]];
+      const G4ThreeVector& b = fVertices[t.fV[1]];
+      const G4ThreeVector& c = fVertices[t.fV[2]];
+      G4ThreeVector cross = (b - a).cross(c - a);
+      t.fArea = 0.5*cross.mag();
+      if (t.fArea == 0.) { continue; }
+      t.fNormal = cross.unit();
+      t.fCentre = (a + b + c)/3.;
+
+      fArea += t.fArea;
+      fVolume += a.dot(b.cross(c))/6.;
+
+      Cluster& cluster = fClusters[NormalKey(t.fNormal)];
+      cluster.fNormal += t.fArea*t.fNormal;
+      cluster.fArea += t.fArea;
+      cluster.fTriangles.push_back(G4int(fTriangles.size()));
+      fTriangles.push_back(t);
+    }
+  }
+  fSize = fVertices.empty() ? 0. : (upper - lower).mag();
+
+  // Facets pointing inwards, or an open surface, are not examined
+  //
+  return !fTriangles.empty() && fVolume > 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02PrimitiveRecogniser::Group(std::vector<G4double> values,
+                                     std::vector<G4double>& means) const
+{
+  means.clear();
+  std::sort(values.begin(), values.end());
+  std::size_t first = 0;
+  for (std::size_t i = 1; i <= values.size(); ++i)
+  {
+    if (i < values.size() && values[i] - values[i-1] <= fTolerance)
+    {
+      continue;
+    }
+    if (values[i-1] - values[first] > 2.*fTolerance) { return false; }
+    G4double sum = 0.;
+    for (std::size_t j = first; j < i; ++j) { sum += values[j]; }
+    means.push_back(sum/(i - first));
+    first = i;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02PrimitiveRecogniser::VolumeMatches(G4double volume,
+                                             G4double area) const
+{
+  // The facets cut the curved surfaces by less than the tolerance
+  //
+  return std::fabs(fVolume - volume) <= fTolerance*area + 1.e-9*volume;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02PrimitiveRecogniser::Place(G4VSolid* primitive,
+                                        const G4String& name,
+                                        const G4ThreeVector& axisX,
+                                        const G4ThreeVector& axisY,
+                                        const G4ThreeVector& axisZ,
+                                        const G4ThreeVector& centre)
+{
+  fLastType = primitive->GetEntityType();
+
+  G4bool rotated = (axisX - G4ThreeVector(1., 0., 0.)).mag() > 1.e-12
+                || (axisY - G4ThreeVector(0., 1., 0.)).mag() > 1.e-12
+                || (axisZ - G4ThreeVector(0., 0., 1.)).mag() > 1.e-12;
+  if (!rotated && centre.mag() <= 1.e-9*fSize)
+  {
+    primitive->SetName(name);
+    return primitive;
+  }
+  primitive->SetName(name + "_primitive");
+  return new G4DisplacedSolid(name, primitive,
+    G4Transform3D(G4RotationMatrix(axisX, axisY, axisZ), centre));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02PrimitiveRecogniser::FitBox(const G4String& name)
+{
+  if (fClusters.size() != 6) { return 0; }
+
+  // One normal per pair of opposite faces, with its largest component
+  // positive; they are ordered as the closest axes
+  //
+  std::vector<G4ThreeVector> axes;
+  for (ClusterMap::const_iterator it = fClusters.begin();
+       it != fClusters.end(); ++it)
+  {
+    G4ThreeVector n = it->second.fNormal.unit();
+    G4int k = (std::fabs(n.x()) >= std::fabs(n.y())
+            && std::fabs(n.x()) >= std::fabs(n.z())) ? 0
+            : (std::fabs(n.y()) >= std::fabs(n.z()) ? 1 : 2);
+    if (n[k] > 0.) { axes.push_back(n); }
+  }
+  if (axes.size() != 3) { return 0; }
+
+  G4ThreeVector e[3];
+  G4bool used[3] = { false, false, false };
+  for (G4int k = 0; k < 2; ++k)
+  {
+    G4int best = -1;
+    for (G4int i = 0; i < 3; ++i)
+    {
+      if (used[i]) { continue; }
+      if (best < 0 || std::fabs(axes[i][k]) > std::fabs(axes[best][k]))
+      {
+        best = i;
+      }
+    }
+    used[best] = true;
+    e[k] = axes[best];
+  }
+  e[2] = e[0].cross(e[1]);
+
+  // Opposite faces are parallel and the three directions orthogonal
+  //
+  if (std::fabs(e[0].dot(e[1])) > kNormalQuantum) { return 0; }
+  for (ClusterMap::const_iterator it = fClusters.begin();
+       it != fClusters.end(); ++it)
+  {
+    G4ThreeVector n = it->second.fNormal.unit();
+    if (std::max(std::fabs(n.dot(e[0])), std::max(std::fabs(n.dot(e[1])),
+                 std::fabs(n.dot(e[2])))) < 1. - kNormalQuantum) { return 0; }
+  }
+
+  G4double half[3];
+  G4ThreeVector centre;
+  for (G4int k = 0; k < 3; ++k)
+  {
+    G4double lo = kInfinity, hi = -kInfinity;
+    for (std::size_t i = 0; i < fVertices.size(); ++i)
+    {
+      G4double s = fVertices[i].dot(e[k]);
+      lo = std::min(lo, s);
+      hi = std::max(hi, s);
+    }
+    half[k] = 0.5*(hi - lo);
+    centre += 0.5*(hi + lo)*e[k];
+  }
+
+  // Every vertex on a face
+  //
+  for (std::size_t i = 0; i < fVertices.size(); ++i)
+  {
+    G4ThreeVector q = fVertices[i] - centre;
+    G4double d = -kInfinity;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      d = std::max(d, std::fabs(q.dot(e[k])) - half[k]);
+    }
+    if (d < -fTolerance) { return 0; }
+  }
+
+  if (!VolumeMatches(8.*half[0]*half[1]*half[2],
+                     8.*(half[0]*half[1] + half[1]*half[2] + half[2]*half[0])))
+  {
+    return 0;
+  }
+
+  return Place(new G4Box(name, half[0], half[1], half[2]), name,
+               e[0], e[1], e[2], centre);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02PrimitiveRecogniser::FitSphere(const G4String& name)
+{
+  // Point closest to the lines along the facet normals
+  //
+  G4double m[3][3] = { {0.,0.,0.}, {0.,0.,0.}, {0.,0.,0.} };
+  G4double b[3] = { 0., 0., 0. };
+  for (std::size_t t = 0; t < fTriangles.size(); ++t)
+  {
+    const Triangle& tri = fTriangles[t];
+    for (G4int i = 0; i < 3; ++i)
+    {
+      for (G4int j = 0; j < 3; ++j)
+      {
+        G4double p = tri.fArea*((i == j ? 1. : 0.)
+                                - tri.fNormal[i]*tri.fNormal[j]);
+        m[i][j] += p;
+        b[i] += p*tri.fCentre[j];
+      }
+    }
+  }
+  G4double det = m[0][0]*(m[1][1]*m[2][2] - m[1][2]*m[2][1])
+               - m[0][1]*(m[1][0]*m[2][2] - m[1][2]*m[2][0])
+               + m[0][2]*(m[1][0]*m[2][1] - m[1][1]*m[2][0]);
+  G4double scale = (m[0][0] + m[1][1] + m[2][2])/3.;
+  if (std::fabs(det) <= 1.e-6*scale*scale*scale) { return 0; }
+
+  G4ThreeVector centre;
+  for (G4int k = 0; k < 3; ++k)
+  {
+    G4double mk[3][3];
+    for (G4int i = 0; i < 3; ++i)
+    {
+      for (G4int j = 0; j < 3; ++j) { mk[i][j] = (j == k) ? b[i] : m[i][j]; }
+    }
+    centre[k] = ( mk[0][0]*(mk[1][1]*mk[2][2] - mk[1][2]*mk[2][1])
+                - mk[0][1]*(mk[1][0]*mk[2][2] - mk[1][2]*mk[2][0])
+                + mk[0][2]*(mk[1][0]*mk[2][1] - mk[1][1]*mk[2][0]))/det;
+  }
+
+  // One radius (orb) or two (shell). The lines along the normals of an
+  // uneven tessellation miss the centre slightly: it is refined by the
+  // algebraic fit of the outer sphere to its vertices.
+  //
+  std::vector<G4double> radii(fVertices.size()), shells;
+  for (G4int pass = 0; pass < 2; ++pass)
+  {
+    for (std::size_t i = 0; i < fVertices.size(); ++i)
+    {
+      radii[i] = (fVertices[i] - centre).mag();
+    }
+    if (!Group(radii, shells) || shells.size() > 2) { return 0; }
+    if (pass == 1) { break; }
+
+    // |p|^2 = 2 c.p + k, in least squares over the outer vertices
+    //
+    G4double a[4][5];
+    for (G4int i = 0; i < 4; ++i)
+    {
+      for (G4int j = 0; j < 5; ++j) { a[i][j] = 0.; }
+    }
+    for (std::size_t v = 0; v < fVertices.size(); ++v)
+    {
+      if (std::fabs(radii[v] - shells.back()) > 2.*fTolerance) { continue; }
+      const G4ThreeVector& p = fVertices[v];
+      G4double row[5] = { 2.*p.x(), 2.*p.y(), 2.*p.z(), 1., p.mag2() };
+      for (G4int i = 0; i < 4; ++i)
+      {
+        for (G4int j = 0; j < 5; ++j) { a[i][j] += row[i]*row[j]; }
+      }
+    }
+    for (G4int i = 0; i < 4; ++i)
+    {
+      G4int pivot = i;
+      for (G4int r = i+1; r < 4; ++r)
+      {
+        if (std::fabs(a[r][i]) > std::fabs(a[pivot][i])) { pivot = r; }
+      }
+      if (a[pivot][i] == 0.) { return 0; }
+      for (G4int j = 0; j < 5; ++j) { std::swap(a[i][j], a[pivot][j]); }
+      for (G4int r = 0; r < 4; ++r)
+      {
+        if (r == i) { continue; }
+        G4double f = a[r][i]/a[i][i];
+        for (G4int j = i; j < 5; ++j) { a[r][j] -= f*a[i][j]; }
+      }
+    }
+    centre.set(a[0][4]/a[0][0], a[1][4]/a[1][1], a[2][4]/a[2][2]);
+  }
+  G4double rmax = shells.back();
+  G4double rmin = shells.size() == 2 ? shells.front() : 0.;
+  if (rmin <= fTolerance) { rmin = 0.; }
+
+  // Facets on one sphere, the outer one facing outwards
+  //
+  for (std::size_t t = 0; t < fTriangles.size(); ++t)
+  {
+    const Triangle& tri = fTriangles[t];
+    G4bool outer = std::fabs(radii[tri.fV[0]] - rmax) <= 2.*fTolerance;
+    G4double r = outer ? rmax : rmin;
+    for (G4int k = 0; k < 3; ++k)
+    {
+      if (std::fabs(radii[tri.fV[k]] - r) > fTolerance) { return 0; }
+    }
+    G4ThreeVector radial = tri.fCentre - centre;
+    if (std::fabs(radial.mag() - r) > fTolerance) { return 0; }
+    if ((tri.fNormal.dot(radial) > 0.) != outer) { return 0; }
+  }
+
+  if (!VolumeMatches(4./3.*pi*(rmax*rmax*rmax - rmin*rmin*rmin),
+                     4.*pi*(rmax*rmax + rmin*rmin))) { return 0; }
+
+  G4VSolid* primitive = rmin > 0.
+    ? static_cast<G4VSolid*>(new G4Sphere(name, rmin, rmax, 0., twopi, 0., pi))
+    : static_cast<G4VSolid*>(new G4Orb(name, rmax));
+  return Place(primitive, name, G4ThreeVector(1., 0., 0.),
+               G4ThreeVector(0., 1., 0.), G4ThreeVector(0., 0., 1.), centre);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02PrimitiveRecogniser::FitTubeOrCone(const G4String& name)
+{
+  // The caps are two planar faces of opposite normals; lateral facets
+  // may also come in opposite pairs, so the largest pairs are tried first
+  //
+  std::vector<std::pair<G4double, ClusterMap::const_iterator> > pairs;
+  for (ClusterMap::const_iterator it = fClusters.begin();
+       it != fClusters.end(); ++it)
+  {
+    const std::tuple<long,long,long>& key = it->first;
+    ClusterMap::const_iterator opposite
+      = fClusters.find(std::make_tuple(-std::get<0>(key), -std::get<1>(key),
+                                       -std::get<2>(key)));
+    if (opposite == fClusters.end() || !(key < opposite->first)) { continue; }
+    pairs.push_back(std::make_pair(it->second.fArea + opposite->second.fArea,
+                                   it));
+  }
+  std::sort(pairs.begin(), pairs.end(),
+            [](const std::pair<G4double, ClusterMap::const_iterator>& a,
+               const std::pair<G4double, ClusterMap::const_iterator>& b)
+            { return a.first > b.first; });
+
+  const std::size_t maxTries = 4;
+  for (std::size_t i = 0; i < pairs.size() && i < maxTries; ++i)
+  {
+    const std::tuple<long,long,long>& key = pairs[i].second->first;
+    const Cluster& top = pairs[i].second->second;
+    const Cluster& bottom
+      = fClusters.find(std::make_tuple(-std::get<0>(key), -std::get<1>(key),
+                                       -std::get<2>(key)))->second;
+
+    // The axis points to the cap of largest positive component
+    //
+    G4ThreeVector a = top.fNormal.unit();
+    G4int k = (std::fabs(a.x()) >= std::fabs(a.y())
+            && std::fabs(a.x()) >= std::fabs(a.z())) ? 0
+            : (std::fabs(a.y()) >= std::fabs(a.z()) ? 1 : 2);
+    G4VSolid* solid = a[k] > 0. ? FitTubeOrCone(name, top, bottom)
+                                : FitTubeOrCone(name, bottom, top);
+    if (solid != 0) { return solid; }
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02PrimitiveRecogniser::FitTubeOrCone(const G4String& name,
+                                                const Cluster& top,
+                                                const Cluster& bottom)
+{
+  G4ThreeVector a = top.fNormal.unit();
+
+  // Frame of the axis, the identity for an axis along Z
+  //
+  G4ThreeVector u = std::fabs(a.x()) < 0.9 ? G4ThreeVector(1., 0., 0.)
+                                            : G4ThreeVector(0., 1., 0.);
+  u = (u - u.dot(a)*a).unit();
+  G4ThreeVector v = a.cross(u);
+
+  // Planes of the caps
+  //
+  G4double zTop = 0., zBottom = 0.;
+  for (std::size_t i = 0; i < top.fTriangles.size(); ++i)
+  {
+    zTop += fTriangles[top.fTriangles[i]].fCentre.dot(a);
+  }
+  for (std::size_t i = 0; i < bottom.fTriangles.size(); ++i)
+  {
+    zBottom += fTriangles[bottom.fTriangles[i]].fCentre.dot(a);
+  }
+  zTop /= top.fTriangles.size();
+  zBottom /= bottom.fTriangles.size();
+  G4double dz = 0.5*(zTop - zBottom);
+  if (dz <= fTolerance) { return 0; }
+
+  // Axis: point closest to the lateral facet normals, in the cap plane
+  //
+  std::vector<G4bool> cap(fTriangles.size(), false);
+  for (std::size_t i = 0; i < top.fTriangles.size(); ++i)
+  {
+    cap[top.fTriangles[i]] = true;
+  }
+  for (std::size_t i = 0; i < bottom.fTriangles.size(); ++i)
+  {
+    cap[bottom.fTriangles[i]] = true;
+  }
+
+  G4double m00 = 0., m01 = 0., m11 = 0., b0 = 0., b1 = 0.;
+  G4int lateral = 0;
+  for (std::size_t t = 0; t < fTriangles.size(); ++t)
+  {
+    if (cap[t]) { continue; }
+    const Triangle& tri = fTriangles[t];
+    G4double nu = tri.fNormal.dot(u), nv = tri.fNormal.dot(v);
+    G4double norm = std::sqrt(nu*nu + nv*nv);
+    if (norm < 1.e-6) { return 0; }
+    nu /= norm;
+    nv /= norm;
+    G4double cu = tri.fCentre.dot(u), cv = tri.fCentre.dot(v);
+    G4double p00 = tri.fArea*(1. - nu*nu), p01 = -tri.fArea*nu*nv;
+    G4double p11 = tri.fArea*(1. - nv*nv);
+    m00 += p00; m01 += p01; m11 += p11;
+    b0 += p00*cu + p01*cv;
+    b1 += p01*cu + p11*cv;
+    ++lateral;
+  }
+  if (lateral == 0) { return 0; }
+  G4double det = m00*m11 - m01*m01;
+  G4double scale = 0.5*(m00 + m11);
+  if (det <= 1.e-6*scale*scale) { return 0; }
+
+  G4ThreeVector centre = ((b0*m11 - b1*m01)/det)*u
+                       + ((m00*b1 - m01*b0)/det)*v
+                       + (0.5*(zTop + zBottom))*a;
+
+  // Every vertex on a cap edge; radii at each end
+  //
+  std::vector<G4double> radius(fVertices.size());
+  std::vector<G4double> lowRadii, highRadii;
+  for (std::size_t i = 0; i < fVertices.size(); ++i)
+  {
+    G4ThreeVector q = fVertices[i] - centre;
+    G4double z = q.dot(a);
+    if (std::fabs(std::fabs(z) - dz) > fTolerance) { return 0; }
+    radius[i] = (q - z*a).mag();
+    (z > 0. ? highRadii : lowRadii).push_back(radius[i]);
+  }
+
+  G4double rmin[2], rmax[2];
+  std::vector<G4double>* ends[2] = { &lowRadii, &highRadii };
+  for (G4int e = 0; e < 2; ++e)
+  {
+    std::vector<G4double> groups;
+    if (!Group(*ends[e], groups) || groups.size() > 2) { return 0; }
+    rmax[e] = groups.back();
+    rmin[e] = groups.size() == 2 ? groups.front() : 0.;
+    if (rmin[e] <= fTolerance) { rmin[e] = 0.; }
+    if (rmax[e] <= fTolerance) { return 0; }
+  }
+  if ((rmin[0] == 0.) != (rmin[1] == 0.)) { return 0; }
+
+  // Lateral facets on the outer surface facing outwards, or on the inner
+  // surface facing inwards
+  //
+  for (std::size_t t = 0; t < fTriangles.size(); ++t)
+  {
+    if (cap[t]) { continue; }
+    const Triangle& tri = fTriangles[t];
+    G4ThreeVector q = tri.fCentre - centre;
+    G4double z = q.dot(a);
+    G4ThreeVector radial = q - z*a;
+    G4bool outer = tri.fNormal.dot(radial) > 0.;
+    if (!outer && rmin[0] == 0.) { return 0; }
+    G4double f = 0.5*(z + dz)/dz;
+    G4double r = outer ? rmax[0] + f*(rmax[1] - rmax[0])
+                       : rmin[0] + f*(rmin[1] - rmin[0]);
+    if (std::fabs(radial.mag() - r) > fTolerance) { return 0; }
+  }
+
+  G4double height = 2.*dz;
+  G4double volume = pi*height/3.
+    * ( rmax[0]*rmax[0] + rmax[0]*rmax[1] + rmax[1]*rmax[1]
+      - rmin[0]*rmin[0] - rmin[0]*rmin[1] - rmin[1]*rmin[1]);
+  G4double outerSlant = std::sqrt((rmax[1] - rmax[0])*(rmax[1] - rmax[0])
+                                  + height*height);
+  G4double innerSlant = std::sqrt((rmin[1] - rmin[0])*(rmin[1] - rmin[0])
+                                  + height*height);
+  G4double area = pi*(rmax[0]*rmax[0] - rmin[0]*rmin[0])
+                + pi*(rmax[1]*rmax[1] - rmin[1]*rmin[1])
+                + pi*(rmax[0] + rmax[1])*outerSlant
+                + pi*(rmin[0] + rmin[1])*innerSlant;
+  if (!VolumeMatches(volume, area)) { return 0; }
+
+  G4VSolid* primitive = 0;
+  if (std::fabs(rmin[1] - rmin[0]) <= fTolerance
+   && std::fabs(rmax[1] - rmax[0]) <= fTolerance)
+  {
+    primitive = new G4Tubs(name, 0.5*(rmin[0] + rmin[1]),
+                           0.5*(rmax[0] + rmax[1]), dz, 0., twopi);
+  }
+  else
+  {
+    primitive = new G4Cons(name, rmin[0], rmax[0], rmin[1], rmax[1],
+                           dz, 0., twopi);
+  }
+  return Place(primitive, name, u, v, a, centre);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02PrimitiveRecogniser::Recognise(const G4TessellatedSolid* solid,
+                                            const G4String& name)
+{
+  G4VSolid* primitive = 0;
+  if (Load(solid))
+  {
+    primitive = FitBox(name);
+    if (primitive == 0) { primitive = FitSphere(name); }
+    if (primitive == 0) { primitive = FitTubeOrCone(name); }
+  }
+
+  std::vector<G4ThreeVector>().swap(fVertices);
+  std::vector<Triangle>().swap(fTriangles);
+  fClusters.clear();
+  return primitive;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02PrimitiveRecogniser::PrintReport() const
+{
+  G4cout << "G02PrimitiveRecogniser: " << fReplaced.size() << " of "
+         << fExamined << " tessellated solids replaced by primitives";
+  for (std::map<G4String, G4int>::const_iterator it = fReplacedByType.begin();
+       it != fReplacedByType.end(); ++it)
+  {
+    G4cout << (it == fReplacedByType.begin() ? " (" : ", ")
+           << it->second << " " << it->first;
+  }
+  G4cout << (fReplacedByType.empty() ? "" : ")") << ", " << fFacetsRemoved
+         << " facets removed (tolerance " << fTolerance/mm << " mm)";
+  if (fDeferred > 0)
+  {
+    G4cout << "; " << fDeferred << " lazy solids not built, not examined";
+  }
+  G4cout << G4endl;
+  for (std::size_t i = 0; i < fReplaced.size(); ++i)
+  {
+    G4cout << "  " << fReplaced[i].first << " -> " << fReplaced[i].second
+           << G4endl;
+  }
+}
@@ -0,0 +1,367 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02ReflectionOptimiser.cc
+/// \brief Implementation of the G02ReflectionOptimiser class
+//
+//
+//
+// Class G02ReflectionOptimiser implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02ReflectionOptimiser.hh"
+#include "G02SolidInterner.hh"
+
+#include "G4ios.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4ReflectedSolid.hh"
+#include "G4ReflectionFactory.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4Box.hh"
+#include "G4Tubs.hh"
+#include "G4Cons.hh"
+#include "G4Trd.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  const G4double kTolerance = 1.e-9;
+
+  // Symmetries of a phi segment [start, start+delta]: about the plane y=0
+  // for a segment centred on phi=0 or pi, about x=0 for one centred on
+  // phi=+-pi/2
+  //
+  G4int PhiSymmetry(G4double start, G4double delta)
+  {
+    if (delta >= twopi - kTolerance) { return 3; }
+    G4double centre = start + 0.5*delta;
+    G4int mask = 0;
+    if (std::fabs(std::sin(centre)) < kTolerance) { mask |= 2; }
+    if (std::fabs(std::cos(centre)) < kTolerance) { mask |= 1; }
+    return mask;
+  }
+
+  // Proper rotation (determinant +1, orthonormal) and no scaling
+  //
+  G4bool IsRigid(const G4Transform3D& t)
+  {
+    G4double det = t.xx()*(t.yy()*t.zz() - t.yz()*t.zy())
+                 - t.xy()*(t.yx()*t.zz() - t.yz()*t.zx())
+                 + t.xz()*(t.yx()*t.zy() - t.yy()*t.zx());
+    G4double n1 = t.xx()*t.xx() + t.yx()*t.yx() + t.zx()*t.zx();
+    G4double n2 = t.xy()*t.xy() + t.yy()*t.yy() + t.zy()*t.zy();
+    G4double n3 = t.xz()*t.xz() + t.yz()*t.yz() + t.zz()*t.zz();
+    return std::fabs(det-1.) < kTolerance && std::fabs(n1-1.) < kTolerance
+        && std::fabs(n2-1.) < kTolerance && std::fabs(n3-1.) < kTolerance;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02ReflectionOptimiser::G02ReflectionOptimiser()
+  : fUnreflected(0), fReplacedLVs(0), fPlacements(0), fShared(0), fKept(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02ReflectionOptimiser::~G02ReflectionOptimiser()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02ReflectionOptimiser::SymmetryMask(const G4VSolid* solid)
+{
+  G4String type = solid->GetEntityType();
+  if (type == "G4Box" || type == "G4Orb")
+  {
+    return 7;
+  }
+  if (type == "G4Tubs")
+  {
+    const G4Tubs* tubs = static_cast<const G4Tubs*>(solid);
+    return 4 | PhiSymmetry(tubs->GetStartPhiAngle(),
+                           tubs->GetDeltaPhiAngle());
+  }
+  if (type == "G4Cons")
+  {
+    const G4Cons* cons = static_cast<const G4Cons*>(solid);
+    G4int mask = PhiSymmetry(cons->GetStartPhiAngle(),
+                             cons->GetDeltaPhiAngle());
+    if (cons->GetInnerRadiusMinusZ() == cons->GetInnerRadiusPlusZ()
+     && cons->GetOuterRadiusMinusZ() == cons->GetOuterRadiusPlusZ())
+    {
+      mask |= 4;
+    }
+    return mask;
+  }
+  if (type == "G4Trd")
+  {
+    const G4Trd* trd = static_cast<const G4Trd*>(solid);
+    G4int mask = 3;
+    if (trd->GetXHalfLength1() == trd->GetXHalfLength2()
+     && trd->GetYHalfLength1() == trd->GetYHalfLength2())
+    {
+      mask |= 4;
+    }
+    return mask;
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02ReflectionOptimiser::LVList
+G02ReflectionOptimiser::CollectVolumes(G4VPhysicalVolume* world)
+{
+  LVList volumes(1, world->GetLogicalVolume());
+  std::set<G4LogicalVolume*> visited(volumes.begin(), volumes.end());
+  for (std::size_t i = 0; i < volumes.size(); ++i)
+  {
+    for (std::size_t d = 0; d < volumes[i]->GetNoDaughters(); ++d)
+    {
+      G4LogicalVolume* lv = volumes[i]->GetDaughter(d)->GetLogicalVolume();
+      if (visited.insert(lv).second) { volumes.push_back(lv); }
+    }
+  }
+  return volumes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Transform3D
+G02ReflectionOptimiser::ObjectTransform(const G4VPhysicalVolume* pv)
+{
+  return G4Transform3D(pv->GetObjectRotationValue(),
+                       pv->GetObjectTranslation());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VPhysicalVolume*
+G02ReflectionOptimiser::Replace(G4VPhysicalVolume* pv, G4LogicalVolume* lv,
+                                const G4Transform3D& transform)
+{
+  // As for the flattening, the old placement is detached but left in the
+  // store, where an assembly may own it
+  //
+  G4LogicalVolume* mother = pv->GetMotherLogical();
+  G4VPhysicalVolume* placed =
+    new G4PVPlacement(transform, lv, pv->GetName(), mother, pv->IsMany(),
+                      pv->GetCopyNo(), false);
+  mother->RemoveDaughter(pv);
+  pv->SetMotherLogical(0);
+  return placed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02ReflectionOptimiser::Unreflect(G4LogicalVolume* reflectedLV,
+                                         LVList& volumes)
+{
+  G4ReflectedSolid* reflected =
+    static_cast<G4ReflectedSolid*>(reflectedLV->GetSolid());
+  G4VSolid* constituent = reflected->GetConstituentMovedSolid();
+
+  G4int mask = SymmetryMask(constituent);
+  if (mask == 0) { return false; }
+
+  // Placements of the volume, and its daughters: all must be simple
+  // placements to be recomposed
+  //
+  std::vector<G4VPhysicalVolume*> placements;
+  for (std::size_t i = 0; i < volumes.size(); ++i)
+  {
+    for (std::size_t d = 0; d < volumes[i]->GetNoDaughters(); ++d)
+    {
+      G4VPhysicalVolume* pv = volumes[i]->GetDaughter(d);
+      if (pv->GetLogicalVolume() != reflectedLV) { continue; }
+      if (pv->IsReplicated()) { return false; }
+      placements.push_back(pv);
+    }
+  }
+  std::vector<G4VPhysicalVolume*> daughters;
+  for (std::size_t d = 0; d < reflectedLV->GetNoDaughters(); ++d)
+  {
+    G4VPhysicalVolume* pv = reflectedLV->GetDaughter(d);
+    if (pv->IsReplicated()) { return false; }
+    daughters.push_back(pv);
+  }
+
+  // D(S) = D(M(S)) with D*M rigid
+  //
+  G4Scale3D mirror((mask & 1) ? -1. : 1.,
+                   (mask & 1) ? 1. : ((mask & 2) ? -1. : 1.),
+                   (mask & 3) ? 1. : -1.);
+  G4Transform3D rigid = reflected->GetDirectTransform3D() * mirror;
+  if (!IsRigid(rigid)) { return false; }
+
+  // A reflected leaf is the original volume placed with the rigid
+  // transformation; otherwise the volume keeps its (reflected) daughters,
+  // now expressed in the frame of the constituent solid
+  //
+  G4LogicalVolume* target = reflectedLV;
+  G4LogicalVolume* original =
+    G4ReflectionFactory::Instance()->GetConstituentLV(reflectedLV);
+  if (daughters.empty() && original != 0
+      && original->GetSolid() == constituent)
+  {
+    target = original;
+    ++fReplacedLVs;
+  }
+  else
+  {
+    // The volume is given the constituent solid through a copy (see
+    // G02SolidInterner::SwapSolids()), which a skin surface prevents
+    //
+    if (G4LogicalSkinSurface::GetSurface(reflectedLV) != 0) { return false; }
+    G4Transform3D inverse = rigid.inverse();
+    for (std::size_t i = 0; i < daughters.size(); ++i)
+    {
+      Replace(daughters[i], daughters[i]->GetLogicalVolume(),
+              inverse * ObjectTransform(daughters[i]));
+      ++fPlacements;
+    }
+    std::map<G4LogicalVolume*, G4VSolid*> swap;
+    swap[reflectedLV] = constituent;
+    target = G02SolidInterner::SwapSolids(swap)[reflectedLV];
+    std::replace(volumes.begin(), volumes.end(), reflectedLV, target);
+  }
+
+  for (std::size_t i = 0; i < placements.size(); ++i)
+  {
+    Replace(placements[i], target, ObjectTransform(placements[i]) * rigid);
+    ++fPlacements;
+  }
+
+  ++fUnreflected;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02ReflectionOptimiser::ShareReflectedSolids(const LVList& volumes)
+{
+  // Key: constituent solid and the 12 coefficients of the transformation
+  //
+  typedef std::pair<const G4VSolid*, std::vector<G4double> > Key;
+  std::map<Key, G4ReflectedSolid*> shared;
+  std::map<G4LogicalVolume*, G4VSolid*> swaps;
+  std::set<G4VSolid*> replaced;
+
+  for (std::size_t i = 0; i < volumes.size(); ++i)
+  {
+    G4ReflectedSolid* reflected =
+      dynamic_cast<G4ReflectedSolid*>(volumes[i]->GetSolid());
+    if (reflected == 0) { continue; }
+
+    G4Transform3D t = reflected->GetDirectTransform3D();
+    G4double coefficients[12] = { t.xx(), t.xy(), t.xz(), t.dx(),
+                                  t.yx(), t.yy(), t.yz(), t.dy(),
+                                  t.zx(), t.zy(), t.zz(), t.dz() };
+    Key key(reflected->GetConstituentMovedSolid(),
+            std::vector<G4double>(coefficients, coefficients+12));
+
+    std::pair<std::map<Key, G4ReflectedSolid*>::iterator, G4bool> entry =
+      shared.insert(std::make_pair(key, reflected));
+    if (entry.second || entry.first->second == reflected)
+    {
+      ++fKept;
+      continue;
+    }
+    swaps[volumes[i]] = entry.first->second;
+    replaced.insert(reflected);
+  }
+
+  // Given through copies of the volumes, except for the ones with a skin
+  // surface
+  //
+  G4int swapped = G4int(G02SolidInterner::SwapSolids(swaps).size());
+  fShared += swapped;
+  fKept += G4int(swaps.size()) - swapped;
+
+  // Delete the wrappers no longer used by any logical volume
+  //
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < store->size(); ++i)
+  {
+    replaced.erase((*store)[i]->GetSolid());
+  }
+  for (std::set<G4VSolid*>::iterator it = replaced.begin();
+       it != replaced.end(); ++it)
+  {
+    delete *it;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02ReflectionOptimiser::Optimise(G4VPhysicalVolume* world)
+{
+  fUnreflected = fReplacedLVs = fPlacements = fShared = fKept = 0;
+
+  LVList volumes = CollectVolumes(world);
+  for (std::size_t i = 0; i < volumes.size(); ++i)
+  {
+    if (dynamic_cast<G4ReflectedSolid*>(volumes[i]->GetSolid()) != 0)
+    {
+      Unreflect(volumes[i], volumes);
+    }
+  }
+
+  // The replaced reflected leaves are no longer in the tree
+  //
+  ShareReflectedSolids(CollectVolumes(world));
+
+  return fUnreflected;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02ReflectionOptimiser::PrintReport() const
+{
+  G4cout << G4endl
+         << "Reflection optimisation: " << fUnreflected
+         << " reflected solids replaced by rigid placements ("
+         << fReplacedLVs << " volumes by their original, " << fPlacements
+         << " placements recomposed), " << fShared
+         << " shared with an identical one, " << fKept << " kept"
+         << G4endl << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
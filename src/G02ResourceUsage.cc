@@ -0,0 +1,89 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02ResourceUsage.cc
+/// \brief Implementation of the G02ResourceUsage class
+//
+//
+//
+// Class G02ResourceUsage implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02ResourceUsage.hh"
+
+#include <chrono>
+#include <ctime>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02ResourceUsage::WallTime()
+{
+  using namespace std::chrono;
+  return duration<G4double>(steady_clock::now().time_since_epoch()).count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02ResourceUsage::CpuTime()
+{
+#if defined(_WIN32)
+  return G4double(std::clock())/CLOCKS_PER_SEC;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0.; }
+  return usage.ru_utime.tv_sec + 1.e-6*usage.ru_utime.tv_usec
+       + usage.ru_stime.tv_sec + 1.e-6*usage.ru_stime.tv_usec;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long G02ResourceUsage::PeakResidentMemory()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return 0;
+  }
+  return G4long(counters.PeakWorkingSetSize/1024);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+#  if defined(__APPLE__)
+  return G4long(usage.ru_maxrss/1024);   // reported in bytes on macOS
+#  else
+  return G4long(usage.ru_maxrss);        // reported in kilobytes on Linux
+#  endif
+#endif
+}
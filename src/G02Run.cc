@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02Run.cc
+/// \brief Implementation of the G02Run class
+//
+//
+//
+// Class G02Run implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02Run.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02Run::G02Run()
+  : G4Run(),
+    fNumberOfSteps(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02Run::~G02Run()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02Run::Merge(const G4Run* aRun)
+{
+  const G02Run* localRun = static_cast<const G02Run*>(aRun);
+
+  fNumberOfSteps += localRun->fNumberOfSteps;
+  fEventTimes.insert(fEventTimes.end(), localRun->fEventTimes.begin(),
+                     localRun->fEventTimes.end());
+
+  MaterialBudgetMap::const_iterator im;
+  for (im = localRun->fMaterialBudgets.begin();
+       im != localRun->fMaterialBudgets.end(); ++im)
+  {
+    AddMaterialStep(im->first, im->second.fPath, im->second.fX0,
+                    im->second.fLambda);
+  }
+  fRayBudgets.insert(fRayBudgets.end(), localRun->fRayBudgets.begin(),
+                     localRun->fRayBudgets.end());
+
+  VolumeStatsMap::const_iterator it;
+  for (it = localRun->fVolumeStats.begin();
+       it != localRun->fVolumeStats.end(); ++it)
+  {
+    VolumeStats& stats = fVolumeStats[it->first];
+    stats.fSteps += it->second.fSteps;
+    stats.fBoundarySteps += it->second.fBoundarySteps;
+    stats.fTime += it->second.fTime;
+  }
+
+  G4Run::Merge(aRun);
+}
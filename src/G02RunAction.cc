@@ -38,23 +38,91 @@
 #include "globals.hh"
 #include "Randomize.hh"
 #include "G02RunAction.hh"
+#include "G02RunActionMessenger.hh"
+#include "G02Run.hh"
+#include "G02DetectorConstruction.hh"
+#include "G02ResourceUsage.hh"
+#include "G02StepRecorder.hh"
+#include "G02StepWriter.hh"
+#include "G02LazySolid.hh"
 
 #include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Material.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
 #include "G4UImanager.hh"
 #include "G4VVisManager.hh"
 #include "G4VisAttributes.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+
+namespace
+{
+  typedef std::pair<G4String, G02Run::VolumeStats> NamedStats;
+
+  G4bool LessRay(const G02Run::RayBudget& a, const G02Run::RayBudget& b)
+  {
+    return a.fRay < b.fRay;
+  }
+
+  template <class T> void WriteRaw(std::ofstream& out, const T& value)
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  G4bool MoreTime(const NamedStats& a, const NamedStats& b)
+  {
+    return a.second.fTime > b.second.fTime;
+  }
+
+  // Nearest-rank percentile of sorted values
+  //
+  G4double Percentile(const std::vector<G4double>& sorted, G4double p)
+  {
+    if (sorted.empty()) { return 0.; }
+    std::size_t rank = std::size_t(std::ceil(p/100.*sorted.size()));
+    return sorted[rank > 0 ? rank-1 : 0];
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G02RunAction::G02RunAction()
- : G4UserRunAction()
+ : G4UserRunAction(),
+   fMessenger(0),
+   fProfileVolumes(false),
+   fTopN(10),
+   fMaterialBudget(false),
+   fMaterialBudgetFile("material_budget.csv"),
+   fRecordBlockSize(8192),
+   fRecordBlocks(4),
+   fStartWallTime(0.),
+   fStartCpuTime(0.)
 { 
+  fMessenger = new G02RunActionMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G02RunAction::~G02RunAction()
 {
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Run* G02RunAction::GenerateRun()
+{
+  return new G02Run;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -62,10 +130,400 @@ G02RunAction::~G02RunAction()
 void G02RunAction::BeginOfRunAction(const G4Run* aRun)
 {  
   G4cout << "### Run " << aRun->GetRunID() << " start." << G4endl;
+
+  fStartWallTime = G02ResourceUsage::WallTime();
+  fStartCpuTime = G02ResourceUsage::CpuTime();
+
+  // The solids of the logical volumes are per thread: the workers take
+  // the level of detail selected on the master
+  //
+  if (G4Threading::IsWorkerThread())
+  {
+    const G02DetectorConstruction* detector =
+      dynamic_cast<const G02DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    if (detector != 0) { detector->ApplyProxySelection(); }
+  }
+
+  // The master opens the step record file before the workers start;
+  // each tracking thread (the master itself in sequential mode) gets
+  // its own recorder
+  //
+  if (IsRecordingSteps())
+  {
+    if (G4Threading::IsMasterThread())
+    {
+      G02StepWriter::Instance()->Open(fRecordFile);
+    }
+    if (!G4Threading::IsMultithreadedApplication()
+        || G4Threading::IsWorkerThread())
+    {
+      G02StepRecorder::CreateThreadInstance(fRecordBlockSize, fRecordBlocks)
+        ->SetRun(aRun->GetRunID());
+    }
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void G02RunAction::EndOfRunAction(const G4Run*)
+void G02RunAction::EndOfRunAction(const G4Run* aRun)
 {
+  // In multi-threaded mode the worker runs are merged into the master one
+  // before this is called on the master
+  //
+  // Workers end their run before the master: their last records are
+  // queued before the master closes the file
+  //
+  G02StepRecorder* recorder = G02StepRecorder::GetThreadInstance();
+  if (recorder) { recorder->Flush(); }
+
+  if (!G4Threading::IsMasterThread()) { return; }
+
+  if (IsRecordingSteps()) { G02StepWriter::Instance()->Close(); }
+
+  PrintThroughputReport(aRun);
+  G02LazySolid::PrintStatistics();
+  if (fProfileVolumes) { PrintVolumeProfile(aRun); }
+
+  if (fMaterialBudget)
+  {
+    G02Run* run = const_cast<G02Run*>(static_cast<const G02Run*>(aRun));
+
+    // Rays are stored in order of completion, which depends on the
+    // threads: sort them by ray number
+    //
+    std::vector<G02Run::RayBudget>& rays = run->GetRayBudgets();
+    std::sort(rays.begin(), rays.end(), LessRay);
+
+    PrintMaterialBudget(run);
+    if (!fMaterialBudgetFile.empty())
+    {
+      G4String::size_type n = fMaterialBudgetFile.size();
+      G4bool csv = n > 4 && fMaterialBudgetFile.substr(n-4) == ".csv";
+      G4bool ok = csv ? WriteMaterialBudgetCSV(run, fMaterialBudgetFile)
+                      : WriteMaterialBudgetBinary(run, fMaterialBudgetFile);
+      if (ok)
+      {
+        G4cout << "Material budget of " << rays.size() << " rays written to "
+               << fMaterialBudgetFile << G4endl;
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02RunAction::PrintThroughputReport(const G4Run* aRun) const
+{
+  const G02Run* run = static_cast<const G02Run*>(aRun);
+
+  G4double wall = G02ResourceUsage::WallTime() - fStartWallTime;
+  G4double cpu = G02ResourceUsage::CpuTime() - fStartCpuTime;
+  G4int nEvents = run->GetNumberOfEvent();
+  G4long nSteps = run->GetNumberOfSteps();
+  G4long peakMemory = G02ResourceUsage::PeakResidentMemory();
+  G4int nThreads = G4Threading::IsMultithreadedApplication()
+                 ? G4Threading::GetNumberOfRunningWorkerThreads() : 1;
+
+  G4double eventRate = wall > 0. ? nEvents/wall : 0.;
+  G4double stepRate = wall > 0. ? nSteps/wall : 0.;
+
+  // Event latencies, in milliseconds
+  //
+  std::vector<G4double> latencies(run->GetEventTimes());
+  std::sort(latencies.begin(), latencies.end());
+  G4double p50 = 1.e3*Percentile(latencies, 50.);
+  G4double p95 = 1.e3*Percentile(latencies, 95.);
+  G4double p99 = 1.e3*Percentile(latencies, 99.);
+  G4double pMax = latencies.empty() ? 0. : 1.e3*latencies.back();
+
+  G4cout << G4endl
+         << "=================== Run " << aRun->GetRunID()
+         << " throughput ===================" << G4endl
+         << std::fixed << std::setprecision(3)
+         << " Events           : " << nEvents << G4endl
+         << " Steps            : " << nSteps << G4endl
+         << " Threads          : " << nThreads << G4endl
+         << " Wall time [s]    : " << wall << G4endl
+         << " CPU time [s]     : " << cpu << G4endl
+         << std::setprecision(1)
+         << " Events/s         : " << eventRate << G4endl
+         << " Steps/s          : " << stepRate << G4endl
+         << std::setprecision(3)
+         << " Event latency [ms] p50/p95/p99/max : " << p50 << " / " << p95
+         << " / " << p99 << " / " << pMax << G4endl
+         << std::setprecision(1)
+         << " Peak RSS [MB]    : " << peakMemory/1024. << G4endl;
+  G4cout.unsetf(std::ios::fixed);
+  G4cout << std::setprecision(6);
+
+  // The same figures on one JSON line, with fixed keys
+  //
+  std::ostringstream json;
+  json << std::setprecision(6)
+       << "{\"run\":" << aRun->GetRunID()
+       << ",\"events\":" << nEvents
+       << ",\"steps\":" << nSteps
+       << ",\"threads\":" << nThreads
+       << ",\"wall_s\":" << wall
+       << ",\"cpu_s\":" << cpu
+       << ",\"events_per_s\":" << eventRate
+       << ",\"steps_per_s\":" << stepRate
+       << ",\"event_ms_p50\":" << p50
+       << ",\"event_ms_p95\":" << p95
+       << ",\"event_ms_p99\":" << p99
+       << ",\"event_ms_max\":" << pMax
+       << ",\"peak_rss_kb\":" << peakMemory << "}";
+
+  G4cout << "G02RUNREPORT " << json.str() << G4endl
+         << "==============================================================="
+         << G4endl << G4endl;
+
+  if (!fReportFile.empty())
+  {
+    std::ofstream out(fReportFile, std::ios::app);
+    if (out) { out << json.str() << std::endl; }
+    if (!out)
+    {
+      G4cerr << "G02RunAction: cannot append run report to "
+             << fReportFile << G4endl;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02RunAction::PrintVolumeProfile(const G4Run* aRun) const
+{
+  const G02Run::VolumeStatsMap& volumeStats =
+    static_cast<const G02Run*>(aRun)->GetVolumeStats();
+  if (volumeStats.empty()) { return; }
+
+  // Collect the statistics per volume and per solid type
+  //
+  std::vector<NamedStats> volumes;
+  std::map<G4String, G02Run::VolumeStats> solidTypes;
+  G02Run::VolumeStats total;
+
+  G02Run::VolumeStatsMap::const_iterator it;
+  for (it = volumeStats.begin(); it != volumeStats.end(); ++it)
+  {
+    const G4LogicalVolume* volume = it->first;
+    const G02Run::VolumeStats& stats = it->second;
+    volumes.push_back(NamedStats(volume->GetName(), stats));
+
+    G02Run::VolumeStats& typeStats =
+      solidTypes[volume->GetSolid()->GetEntityType()];
+    typeStats.fSteps += stats.fSteps;
+    typeStats.fBoundarySteps += stats.fBoundarySteps;
+    typeStats.fTime += stats.fTime;
+
+    total.fSteps += stats.fSteps;
+    total.fBoundarySteps += stats.fBoundarySteps;
+    total.fTime += stats.fTime;
+  }
+  std::vector<NamedStats> types(solidTypes.begin(), solidTypes.end());
+
+  std::size_t nVolumes = std::min(volumes.size(), std::size_t(fTopN));
+  std::partial_sort(volumes.begin(), volumes.begin()+nVolumes,
+                    volumes.end(), MoreTime);
+  std::sort(types.begin(), types.end(), MoreTime);
+
+  // Times are summed over the worker threads
+  //
+  G4cout << G4endl
+         << "=================== Volume profile (run " << aRun->GetRunID()
+         << ") ===================" << G4endl
+         << " Top " << nVolumes << " of " << volumes.size()
+         << " logical volumes by wall time:" << G4endl;
+  PrintStatsHeader("Logical volume");
+  for (std::size_t i = 0; i < nVolumes; ++i)
+  {
+    PrintStats(volumes[i].first, volumes[i].second, total.fTime);
+  }
+
+  G4cout << G4endl << " Per solid type:" << G4endl;
+  PrintStatsHeader("Solid type");
+  for (std::size_t i = 0; i < types.size(); ++i)
+  {
+    PrintStats(types[i].first, types[i].second, total.fTime);
+  }
+  PrintStats("Total", total, total.fTime);
+
+  G4cout << "=============================================================="
+         << G4endl << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02RunAction::PrintStatsHeader(const G4String& title) const
+{
+  G4cout << " " << std::setw(28) << std::left << title << std::right
+         << std::setw(12) << "steps" << std::setw(12) << "boundary"
+         << std::setw(11) << "time [s]" << std::setw(8) << "time %"
+         << std::setw(11) << "us/step" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02RunAction::PrintStats(const G4String& name,
+                              const G02Run::VolumeStats& stats,
+                              G4double totalTime) const
+{
+  G4cout << " " << std::setw(28) << std::left << name << std::right
+         << std::setw(12) << stats.fSteps
+         << std::setw(12) << stats.fBoundarySteps
+         << std::fixed << std::setprecision(4)
+         << std::setw(11) << stats.fTime
+         << std::setprecision(1)
+         << std::setw(8) << (totalTime > 0. ? 100.*stats.fTime/totalTime : 0.)
+         << std::setprecision(3)
+         << std::setw(11) << (stats.fSteps ? 1.e6*stats.fTime/stats.fSteps : 0.)
+         << G4endl;
+  G4cout.unsetf(std::ios::fixed);
+  G4cout << std::setprecision(6);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02RunAction::PrintMaterialBudget(const G02Run* run) const
+{
+  const G02Run::MaterialBudgetMap& materials = run->GetMaterialBudgets();
+  std::size_t nRays = run->GetRayBudgets().size();
+  if (nRays == 0) { return; }
+
+  // Thickness per ray, averaged over the rays of the scan
+  //
+  G4cout << G4endl
+         << "=================== Material budget (" << nRays
+         << " rays) ===================" << G4endl
+         << " " << std::setw(28) << std::left << "Material" << std::right
+         << std::setw(14) << "<path> [mm]" << std::setw(12) << "<X0>"
+         << std::setw(12) << "<lambda>" << G4endl;
+
+  G02Run::Budget total;
+  G02Run::MaterialBudgetMap::const_iterator it;
+  for (it = materials.begin(); it != materials.end(); ++it)
+  {
+    G4cout << " " << std::setw(28) << std::left << it->first->GetName()
+           << std::right << std::fixed << std::setprecision(3)
+           << std::setw(14) << it->second.fPath/nRays/mm
+           << std::setprecision(5)
+           << std::setw(12) << it->second.fX0/nRays
+           << std::setw(12) << it->second.fLambda/nRays << G4endl;
+    total.fPath += it->second.fPath;
+    total.fX0 += it->second.fX0;
+    total.fLambda += it->second.fLambda;
+  }
+  G4cout << " " << std::setw(28) << std::left << "Total" << std::right
+         << std::setprecision(3)
+         << std::setw(14) << total.fPath/nRays/mm
+         << std::setprecision(5)
+         << std::setw(12) << total.fX0/nRays
+         << std::setw(12) << total.fLambda/nRays << G4endl;
+  G4cout.unsetf(std::ios::fixed);
+  G4cout << std::setprecision(6)
+         << "==============================================================="
+         << G4endl << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02RunAction::WriteMaterialBudgetCSV(const G02Run* run,
+                                            const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (!out)
+  {
+    G4cerr << "G02RunAction: cannot open material budget file "
+           << fileName << G4endl;
+    return false;
+  }
+
+  // Per ray map, followed by the per material totals in a second file
+  //
+  const std::vector<G02Run::RayBudget>& rays = run->GetRayBudgets();
+  out << "ray,x_mm,y_mm,z_mm,dx,dy,dz,eta,phi,path_mm,x0,lambda\n"
+      << std::setprecision(9);
+  for (std::size_t i = 0; i < rays.size(); ++i)
+  {
+    const G02Run::RayBudget& ray = rays[i];
+    out << ray.fRay << ','
+        << ray.fOrigin.x()/mm << ',' << ray.fOrigin.y()/mm << ','
+        << ray.fOrigin.z()/mm << ','
+        << ray.fDirection.x() << ',' << ray.fDirection.y() << ','
+        << ray.fDirection.z() << ','
+        << ray.fDirection.eta() << ',' << ray.fDirection.phi() << ','
+        << ray.fBudget.fPath/mm << ',' << ray.fBudget.fX0 << ','
+        << ray.fBudget.fLambda << '\n';
+  }
+
+  G4String materialFile = fileName.substr(0, fileName.size()-4)
+                        + "_materials.csv";
+  std::ofstream mout(materialFile);
+  if (mout)
+  {
+    mout << "material,path_mm,x0,lambda\n" << std::setprecision(9);
+    const G02Run::MaterialBudgetMap& materials = run->GetMaterialBudgets();
+    G02Run::MaterialBudgetMap::const_iterator it;
+    for (it = materials.begin(); it != materials.end(); ++it)
+    {
+      mout << it->first->GetName() << ',' << it->second.fPath/mm << ','
+           << it->second.fX0 << ',' << it->second.fLambda << '\n';
+    }
+  }
+
+  return bool(out) && bool(mout);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02RunAction::WriteMaterialBudgetBinary(const G02Run* run,
+                                               const G4String& fileName) const
+{
+  std::ofstream out(fileName, std::ios::binary);
+  if (!out)
+  {
+    G4cerr << "G02RunAction: cannot open material budget file "
+           << fileName << G4endl;
+    return false;
+  }
+
+  // Native byte order; lengths in mm:
+  //   char[8] "G02MB001", uint64 nRays,
+  //   nRays x { int64 ray, double x,y,z,dx,dy,dz,path,x0,lambda },
+  //   uint64 nMaterials,
+  //   nMaterials x { uint32 nameLength, char name[nameLength],
+  //                  double path,x0,lambda }
+  //
+  out.write("G02MB001", 8);
+
+  const std::vector<G02Run::RayBudget>& rays = run->GetRayBudgets();
+  WriteRaw(out, std::uint64_t(rays.size()));
+  for (std::size_t i = 0; i < rays.size(); ++i)
+  {
+    const G02Run::RayBudget& ray = rays[i];
+    G4double values[9] = { ray.fOrigin.x()/mm, ray.fOrigin.y()/mm,
+                           ray.fOrigin.z()/mm, ray.fDirection.x(),
+                           ray.fDirection.y(), ray.fDirection.z(),
+                           ray.fBudget.fPath/mm, ray.fBudget.fX0,
+                           ray.fBudget.fLambda };
+    WriteRaw(out, std::int64_t(ray.fRay));
+    out.write(reinterpret_cast<const char*>(values), sizeof(values));
+  }
+
+  const G02Run::MaterialBudgetMap& materials = run->GetMaterialBudgets();
+  WriteRaw(out, std::uint64_t(materials.size()));
+  G02Run::MaterialBudgetMap::const_iterator it;
+  for (it = materials.begin(); it != materials.end(); ++it)
+  {
+    const G4String& name = it->first->GetName();
+    WriteRaw(out, std::uint32_t(name.size()));
+    out.write(name.data(), name.size());
+    G4double values[3] = { it->second.fPath/mm, it->second.fX0,
+                           it->second.fLambda };
+    out.write(reinterpret_cast<const char*>(values), sizeof(values));
+  }
+
+  return bool(out);
 }
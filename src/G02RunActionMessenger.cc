@@ -0,0 +1,172 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02RunActionMessenger.cc
+/// \brief Implementation of the G02RunActionMessenger class
+//
+//
+//
+// Class G02RunActionMessenger implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "globals.hh"
+
+#include "G02RunActionMessenger.hh"
+#include "G02RunAction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02RunActionMessenger::G02RunActionMessenger( G02RunAction* myRun )
+  : G4UImessenger(),
+    fTheRunAction( myRun ),
+    fTheRunDir(0),
+    fTheProfileVolumesCommand(0),
+    fTheTopNCommand(0),
+    fTheReportFileCommand(0),
+    fTheMaterialBudgetCommand(0),
+    fTheMaterialBudgetFileCommand(0),
+    fTheRecordDir(0),
+    fTheRecordFileCommand(0),
+    fTheRecordBlockSizeCommand(0),
+    fTheRecordBlocksCommand(0)
+{
+  fTheRunDir = new G4UIdirectory( "/myrun/" );
+  fTheRunDir->SetGuidance("Run control.");
+
+  fTheProfileVolumesCommand = new G4UIcmdWithABool("/myrun/profileVolumes", this);
+  fTheProfileVolumesCommand ->SetGuidance("Account steps and wall time per logical volume and solid type");
+  fTheProfileVolumesCommand ->SetGuidance("The hottest volumes are printed at the end of each run.");
+  fTheProfileVolumesCommand ->SetParameterName("Enable", true);
+  fTheProfileVolumesCommand ->SetDefaultValue(true);
+  fTheProfileVolumesCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheTopNCommand = new G4UIcmdWithAnInteger("/myrun/profileTopN", this);
+  fTheTopNCommand ->SetGuidance("Number of volumes printed by the volume profiling");
+  fTheTopNCommand ->SetParameterName("N", false);
+  fTheTopNCommand ->SetRange("N>=1");
+  fTheTopNCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheReportFileCommand = new G4UIcmdWithAString("/myrun/reportFile", this);
+  fTheReportFileCommand ->SetGuidance("Append the JSON run report of each run to the given file");
+  fTheReportFileCommand ->SetParameterName("FileName", false);
+  fTheReportFileCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheMaterialBudgetCommand = new G4UIcmdWithABool("/myrun/materialBudget", this);
+  fTheMaterialBudgetCommand ->SetGuidance("Sum the X0 and lambda thickness crossed by the primary rays");
+  fTheMaterialBudgetCommand ->SetGuidance("To be used with the /mygen/ scan modes and geantinos.");
+  fTheMaterialBudgetCommand ->SetParameterName("Enable", true);
+  fTheMaterialBudgetCommand ->SetDefaultValue(true);
+  fTheMaterialBudgetCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheMaterialBudgetFileCommand = new G4UIcmdWithAString("/myrun/materialBudgetFile", this);
+  fTheMaterialBudgetFileCommand ->SetGuidance("Output file of the per-ray material budget map");
+  fTheMaterialBudgetFileCommand ->SetGuidance("CSV if the name ends with .csv, binary otherwise.");
+  fTheMaterialBudgetFileCommand ->SetParameterName("FileName", false);
+  fTheMaterialBudgetFileCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheRecordDir = new G4UIdirectory( "/myrun/record/" );
+  fTheRecordDir->SetGuidance("Binary step record output.");
+
+  fTheRecordFileCommand = new G4UIcmdWithAString("/myrun/record/file", this);
+  fTheRecordFileCommand ->SetGuidance("Stream the step records to the given binary file");
+  fTheRecordFileCommand ->SetGuidance("\"none\" disables the recording (default).");
+  fTheRecordFileCommand ->SetParameterName("FileName", false);
+  fTheRecordFileCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheRecordBlockSizeCommand = new G4UIcmdWithAnInteger("/myrun/record/blockSize", this);
+  fTheRecordBlockSizeCommand ->SetGuidance("Number of step records per block (default 8192)");
+  fTheRecordBlockSizeCommand ->SetParameterName("N", false);
+  fTheRecordBlockSizeCommand ->SetRange("N>=1");
+  fTheRecordBlockSizeCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTheRecordBlocksCommand = new G4UIcmdWithAnInteger("/myrun/record/blocks", this);
+  fTheRecordBlocksCommand ->SetGuidance("Number of blocks in the ring of each thread (default 4)");
+  fTheRecordBlocksCommand ->SetParameterName("N", false);
+  fTheRecordBlocksCommand ->SetRange("N>=2");
+  fTheRecordBlocksCommand ->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02RunActionMessenger::~G02RunActionMessenger()
+{
+  delete fTheRecordBlocksCommand;
+  delete fTheRecordBlockSizeCommand;
+  delete fTheRecordFileCommand;
+  delete fTheRecordDir;
+  delete fTheMaterialBudgetFileCommand;
+  delete fTheMaterialBudgetCommand;
+  delete fTheReportFileCommand;
+  delete fTheTopNCommand;
+  delete fTheProfileVolumesCommand;
+  delete fTheRunDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02RunActionMessenger::SetNewValue( G4UIcommand* command, G4String newValue )
+{
+  if ( command == fTheProfileVolumesCommand )
+  {
+    fTheRunAction->SetProfileVolumes(
+      fTheProfileVolumesCommand->GetNewBoolValue(newValue));
+  }
+  if ( command == fTheTopNCommand )
+  {
+    fTheRunAction->SetTopN(fTheTopNCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fTheReportFileCommand )
+  {
+    fTheRunAction->SetReportFile(newValue);
+  }
+  if ( command == fTheMaterialBudgetCommand )
+  {
+    fTheRunAction->SetMaterialBudget(
+      fTheMaterialBudgetCommand->GetNewBoolValue(newValue));
+  }
+  if ( command == fTheMaterialBudgetFileCommand )
+  {
+    fTheRunAction->SetMaterialBudgetFile(newValue);
+  }
+  if ( command == fTheRecordFileCommand )
+  {
+    fTheRunAction->SetRecordFile(newValue == "none" ? G4String() : newValue);
+  }
+  if ( command == fTheRecordBlockSizeCommand )
+  {
+    fTheRunAction->SetRecordBlockSize(
+      fTheRecordBlockSizeCommand->GetNewIntValue(newValue));
+  }
+  if ( command == fTheRecordBlocksCommand )
+  {
+    fTheRunAction->SetRecordBlocks(
+      fTheRecordBlocksCommand->GetNewIntValue(newValue));
+  }
+}
@@ -0,0 +1,578 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02SolidInterner.cc
+/// \brief Implementation of the G02SolidInterner class
+//
+//
+//
+// Class G02SolidInterner implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02SolidInterner.hh"
+
+#include "G4ios.hh"
+#include "G4VSolid.hh"
+#include "G4Box.hh"
+#include "G4Tubs.hh"
+#include "G4Cons.hh"
+#include "G4Trd.hh"
+#include "G4Trap.hh"
+#include "G4Para.hh"
+#include "G4Sphere.hh"
+#include "G4Orb.hh"
+#include "G4Torus.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VisAttributes.hh"
+#include "G4ReflectionFactory.hh"
+#include "G4BooleanSolid.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4ReflectedSolid.hh"
+#include "G4ScaledSolid.hh"
+#include "G4MultiUnion.hh"
+#include "G4SolidStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4Region.hh"
+#include "G4LogicalBorderSurface.hh"
+
+#include <set>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // Exact decimal form of the parameters
+  //
+  class ParameterStream
+  {
+    public:
+
+      explicit ParameterStream(const G4String& type)
+        { fOut.precision(17); fOut << type; }
+
+      ParameterStream& operator<<(G4double value)
+        { fOut << ' ' << value; return *this; }
+
+      ParameterStream& operator<<(const G4ThreeVector& value)
+        { return *this << value.x() << value.y() << value.z(); }
+
+      std::string str() const { return fOut.str(); }
+
+    private:
+
+      std::ostringstream fOut;
+  };
+
+  // Post-order of the logical volumes below the given one
+  //
+  void PostOrder(G4LogicalVolume* lv, std::set<G4LogicalVolume*>& visited,
+                 std::vector<G4LogicalVolume*>& order)
+  {
+    if (!visited.insert(lv).second) { return; }
+    for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+    {
+      PostOrder(lv->GetDaughter(i)->GetLogicalVolume(), visited, order);
+    }
+    order.push_back(lv);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02SolidInterner::G02SolidInterner()
+  : fEnabled(false),
+    fCreatedDuplicates(0), fSolidDuplicates(0), fVolumeDuplicates(0),
+    fPlacements(0), fVolumesBefore(0), fVolumesAfter(0),
+    fSolidsFreed(0), fVolumesFreed(0)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02SolidInterner::~G02SolidInterner()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string G02SolidInterner::Fingerprint(const G4VSolid* solid)
+{
+  G4String type = solid->GetEntityType();
+  ParameterStream key(type);
+
+  if (type == "G4Box")
+  {
+    const G4Box* s = static_cast<const G4Box*>(solid);
+    key << s->GetXHalfLength() << s->GetYHalfLength() << s->GetZHalfLength();
+  }
+  else if (type == "G4Tubs")
+  {
+    const G4Tubs* s = static_cast<const G4Tubs*>(solid);
+    key << s->GetInnerRadius() << s->GetOuterRadius() << s->GetZHalfLength()
+        << s->GetStartPhiAngle() << s->GetDeltaPhiAngle();
+  }
+  else if (type == "G4Cons")
+  {
+    const G4Cons* s = static_cast<const G4Cons*>(solid);
+    key << s->GetInnerRadiusMinusZ() << s->GetOuterRadiusMinusZ()
+        << s->GetInnerRadiusPlusZ() << s->GetOuterRadiusPlusZ()
+        << s->GetZHalfLength()
+        << s->GetStartPhiAngle() << s->GetDeltaPhiAngle();
+  }
+  else if (type == "G4Trd")
+  {
+    const G4Trd* s = static_cast<const G4Trd*>(solid);
+    key << s->GetXHalfLength1() << s->GetXHalfLength2()
+        << s->GetYHalfLength1() << s->GetYHalfLength2()
+        << s->GetZHalfLength();
+  }
+  else if (type == "G4Trap")
+  {
+    const G4Trap* s = static_cast<const G4Trap*>(solid);
+    key << s->GetZHalfLength() << s->GetSymAxis()
+        << s->GetYHalfLength1() << s->GetXHalfLength1()
+        << s->GetXHalfLength2() << s->GetTanAlpha1()
+        << s->GetYHalfLength2() << s->GetXHalfLength3()
+        << s->GetXHalfLength4() << s->GetTanAlpha2();
+  }
+  else if (type == "G4Para")
+  {
+    const G4Para* s = static_cast<const G4Para*>(solid);
+    key << s->GetXHalfLength() << s->GetYHalfLength() << s->GetZHalfLength()
+        << s->GetTanAlpha() << s->GetSymAxis();
+  }
+  else if (type == "G4Sphere")
+  {
+    const G4Sphere* s = static_cast<const G4Sphere*>(solid);
+    key << s->GetInnerRadius() << s->GetOuterRadius()
+        << s->GetStartPhiAngle() << s->GetDeltaPhiAngle()
+        << s->GetStartThetaAngle() << s->GetDeltaThetaAngle();
+  }
+  else if (type == "G4Orb")
+  {
+    key << static_cast<const G4Orb*>(solid)->GetRadius();
+  }
+  else if (type == "G4Torus")
+  {
+    const G4Torus* s = static_cast<const G4Torus*>(solid);
+    key << s->GetRmin() << s->GetRmax() << s->GetRtor()
+        << s->GetSPhi() << s->GetDPhi();
+  }
+  else
+  {
+    return std::string();
+  }
+  return key.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02SolidInterner::CollectConstituents(
+  std::set<const G4VSolid*>& constituents)
+{
+  G4SolidStore* solidStore = G4SolidStore::GetInstance();
+  for (std::size_t i = 0; i < solidStore->size(); ++i)
+  {
+    const G4VSolid* solid = (*solidStore)[i];
+    if (const G4BooleanSolid* boolean
+          = dynamic_cast<const G4BooleanSolid*>(solid))
+    {
+      constituents.insert(boolean->GetConstituentSolid(0));
+      constituents.insert(boolean->GetConstituentSolid(1));
+    }
+    else if (const G4DisplacedSolid* displaced
+               = dynamic_cast<const G4DisplacedSolid*>(solid))
+    {
+      constituents.insert(displaced->GetConstituentMovedSolid());
+    }
+    else if (const G4ReflectedSolid* reflected
+               = dynamic_cast<const G4ReflectedSolid*>(solid))
+    {
+      constituents.insert(reflected->GetConstituentMovedSolid());
+    }
+    else if (const G4ScaledSolid* scaled
+               = dynamic_cast<const G4ScaledSolid*>(solid))
+    {
+      constituents.insert(scaled->GetUnscaledSolid());
+    }
+    else if (const G4MultiUnion* multi
+               = dynamic_cast<const G4MultiUnion*>(solid))
+    {
+      for (G4int j = 0; j < multi->GetNumberOfSolids(); ++j)
+      {
+        constituents.insert(multi->GetSolid(j));
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::map<G4LogicalVolume*, G4LogicalVolume*>
+G02SolidInterner::SwapSolids(const std::map<G4LogicalVolume*, G4VSolid*>& solids)
+{
+  std::map<G4LogicalVolume*, G4LogicalVolume*> copies;
+  for (std::map<G4LogicalVolume*, G4VSolid*>::const_iterator it
+         = solids.begin(); it != solids.end(); ++it)
+  {
+    G4LogicalVolume* lv = it->first;
+    if (G4LogicalSkinSurface::GetSurface(lv) != 0) { continue; }
+
+    G4LogicalVolume* copy =
+      new G4LogicalVolume(it->second, lv->GetMaterial(), lv->GetName(),
+                          lv->GetFieldManager(), lv->GetSensitiveDetector(),
+                          lv->GetUserLimits(), lv->IsToOptimise());
+    copy->SetVisAttributes(lv->GetVisAttributes());
+    copy->SetSmartless(lv->GetSmartless());
+    copy->SetBiasWeight(lv->GetBiasWeight());
+
+    std::vector<G4VPhysicalVolume*> daughters;
+    for (std::size_t d = 0; d < lv->GetNoDaughters(); ++d)
+    {
+      daughters.push_back(lv->GetDaughter(d));
+    }
+    lv->ClearDaughters();
+    for (std::size_t d = 0; d < daughters.size(); ++d)
+    {
+      copy->AddDaughter(daughters[d]);
+      daughters[d]->SetMotherLogical(copy);
+    }
+
+    if (lv->IsRootRegion())
+    {
+      G4Region* region = lv->GetRegion();
+      region->RemoveRootLogicalVolume(lv, false);
+      region->AddRootLogicalVolume(copy);
+    }
+    copies[lv] = copy;
+  }
+
+  // The placements, in one pass over the store, then the volumes
+  // replaced
+  //
+  G4PhysicalVolumeStore* pvStore = G4PhysicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < pvStore->size(); ++i)
+  {
+    G4VPhysicalVolume* pv = (*pvStore)[i];
+    std::map<G4LogicalVolume*, G4LogicalVolume*>::const_iterator it =
+      copies.find(pv->GetLogicalVolume());
+    if (it != copies.end()) { pv->SetLogicalVolume(it->second); }
+  }
+  for (std::map<G4LogicalVolume*, G4LogicalVolume*>::const_iterator it
+         = copies.begin(); it != copies.end(); ++it)
+  {
+    delete it->first;
+  }
+  return copies;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02SolidInterner::Lookup(G4VSolid* solid)
+{
+  std::string key = Fingerprint(solid);
+  if (key.empty()) { return solid; }
+  return fSolids.insert(std::make_pair(key, solid)).first->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VSolid* G02SolidInterner::Intern(G4VSolid* solid)
+{
+  if (!fEnabled) { return solid; }
+
+  G4VSolid* interned = Lookup(solid);
+  if (interned != solid)
+  {
+    delete solid;
+    ++fCreatedDuplicates;
+  }
+  return interned;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4VisAttributes*
+G02SolidInterner::CanonicalVis(const G4VisAttributes* vis)
+{
+  if (vis == 0) { return 0; }
+  for (std::size_t i = 0; i < fVisAttributes.size(); ++i)
+  {
+    if (fVisAttributes[i] == vis || *fVisAttributes[i] == *vis)
+    {
+      return fVisAttributes[i];
+    }
+  }
+  fVisAttributes.push_back(vis);
+  return vis;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string G02SolidInterner::
+LVFingerprint(const G4LogicalVolume* lv,
+              const std::map<G4LogicalVolume*, G4LogicalVolume*>& merged)
+{
+  std::ostringstream key;
+  key.precision(17);
+  key << lv->GetSolid() << ' ' << lv->GetMaterial() << ' '
+      << CanonicalVis(lv->GetVisAttributes()) << ' '
+      << lv->GetSensitiveDetector() << ' ' << lv->GetFieldManager() << ' '
+      << lv->GetUserLimits();
+
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i)
+  {
+    const G4VPhysicalVolume* pv = lv->GetDaughter(i);
+    G4LogicalVolume* daughterLV = pv->GetLogicalVolume();
+    std::map<G4LogicalVolume*, G4LogicalVolume*>::const_iterator it =
+      merged.find(daughterLV);
+    if (it != merged.end()) { daughterLV = it->second; }
+
+    G4RotationMatrix rot = pv->GetObjectRotationValue();
+    G4ThreeVector pos = pv->GetObjectTranslation();
+    key << " | " << daughterLV << ' ' << pv->GetName() << ' '
+        << pv->GetCopyNo() << ' ' << pv->IsMany()
+        << ' ' << rot.xx() << ' ' << rot.xy() << ' ' << rot.xz()
+        << ' ' << rot.yx() << ' ' << rot.yy() << ' ' << rot.yz()
+        << ' ' << rot.zx() << ' ' << rot.zy() << ' ' << rot.zz()
+        << ' ' << pos.x() << ' ' << pos.y() << ' ' << pos.z();
+  }
+  return key.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02SolidInterner::
+Free(const std::map<G4LogicalVolume*, G4LogicalVolume*>& merged,
+     const std::set<G4VSolid*>& replaced)
+{
+  fSolidsFreed = fVolumesFreed = 0;
+
+  // The merged volumes still placed out of the tree are kept; the
+  // placements inside the merged volumes go with them
+  //
+  std::set<const G4LogicalVolume*> placed;
+  G4PhysicalVolumeStore* pvStore = G4PhysicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < pvStore->size(); ++i)
+  {
+    const G4VPhysicalVolume* pv = (*pvStore)[i];
+    if (merged.count(pv->GetMotherLogical())) { continue; }
+    placed.insert(pv->GetLogicalVolume());
+  }
+
+  for (std::map<G4LogicalVolume*, G4LogicalVolume*>::const_iterator it
+         = merged.begin(); it != merged.end(); ++it)
+  {
+    G4LogicalVolume* lv = it->first;
+    if (placed.count(lv)) { continue; }
+    std::vector<G4VPhysicalVolume*> daughters;
+    for (std::size_t d = 0; d < lv->GetNoDaughters(); ++d)
+    {
+      daughters.push_back(lv->GetDaughter(d));
+    }
+    lv->ClearDaughters();
+    for (std::size_t d = 0; d < daughters.size(); ++d)
+    {
+      delete daughters[d];
+    }
+    delete lv;
+    ++fVolumesFreed;
+  }
+
+  // The solids replaced, unless still used by a volume or another solid
+  //
+  std::set<const G4VSolid*> used;
+  CollectConstituents(used);
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for (std::size_t i = 0; i < lvStore->size(); ++i)
+  {
+    used.insert((*lvStore)[i]->GetSolid());
+  }
+  for (std::set<G4VSolid*>::const_iterator it = replaced.begin();
+       it != replaced.end(); ++it)
+  {
+    if (used.count(*it)) { continue; }
+    delete *it;
+    ++fSolidsFreed;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G02SolidInterner::Run(G4VPhysicalVolume* world)
+{
+  fSolidDuplicates = fVolumeDuplicates = fPlacements = 0;
+
+  std::set<G4LogicalVolume*> visited;
+  std::vector<G4LogicalVolume*> order;
+  PostOrder(world->GetLogicalVolume(), visited, order);
+  fVolumesBefore = G4int(order.size());
+
+  // Volumes placed by replicas and parameterisations: ComputeDimensions()
+  // resizes their solids, which cannot be shared with other volumes
+  //
+  std::set<const G4LogicalVolume*> replicated;
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    for (std::size_t d = 0; d < order[i]->GetNoDaughters(); ++d)
+    {
+      const G4VPhysicalVolume* pv = order[i]->GetDaughter(d);
+      if (pv->IsReplicated()) { replicated.insert(pv->GetLogicalVolume()); }
+    }
+  }
+
+  // Solids, given to copies of the logical volumes (see SwapSolids());
+  // the volumes known to the reflection factory are kept, as it refers
+  // to them
+  //
+  G4ReflectionFactory* reflections = G4ReflectionFactory::Instance();
+  std::map<G4LogicalVolume*, G4VSolid*> swaps;
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    G4LogicalVolume* lv = order[i];
+    if (replicated.count(lv)
+        || reflections->IsReflected(lv) || reflections->IsConstituent(lv))
+    {
+      continue;
+    }
+    G4VSolid* interned = Lookup(lv->GetSolid());
+    if (interned != lv->GetSolid()) { swaps[lv] = interned; }
+  }
+  std::set<G4VSolid*> replacedSolids;
+  for (std::map<G4LogicalVolume*, G4VSolid*>::const_iterator it
+         = swaps.begin(); it != swaps.end(); ++it)
+  {
+    replacedSolids.insert(it->first->GetSolid());
+  }
+  std::map<G4LogicalVolume*, G4LogicalVolume*> copies = SwapSolids(swaps);
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    std::map<G4LogicalVolume*, G4LogicalVolume*>::const_iterator it =
+      copies.find(order[i]);
+    if (it != copies.end()) { order[i] = it->second; }
+  }
+  fSolidDuplicates = G4int(copies.size());
+
+  // Placements bounding a border surface, which refers to them
+  //
+  std::set<const G4VPhysicalVolume*> bordering;
+  const G4LogicalBorderSurfaceTable* borders =
+    G4LogicalBorderSurface::GetSurfaceTable();
+  if (borders != 0)
+  {
+    for (G4LogicalBorderSurfaceTable::const_iterator it = borders->begin();
+         it != borders->end(); ++it)
+    {
+      bordering.insert(it->first.first);
+      bordering.insert(it->first.second);
+    }
+  }
+
+  // Logical volumes, the daughters before their mothers so that the
+  // fingerprint of a mother refers to the interned daughters
+  //
+  std::map<G4LogicalVolume*, G4LogicalVolume*> merged;
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    G4LogicalVolume* lv = order[i];
+    if (lv == world->GetLogicalVolume() || lv->IsRootRegion()
+        || replicated.count(lv)
+        || reflections->IsReflected(lv) || reflections->IsConstituent(lv)
+        || G4LogicalSkinSurface::GetSurface(lv) != 0)
+    {
+      continue;
+    }
+    G4bool shareable = true;
+    for (std::size_t d = 0; d < lv->GetNoDaughters(); ++d)
+    {
+      const G4VPhysicalVolume* pv = lv->GetDaughter(d);
+      if (pv->IsReplicated() || bordering.count(pv)) { shareable = false; }
+    }
+    if (!shareable) { continue; }
+
+    G4LogicalVolume* interned =
+      fVolumes.insert(std::make_pair(LVFingerprint(lv, merged), lv))
+        .first->second;
+    if (interned != lv)
+    {
+      merged[lv] = interned;
+      ++fVolumeDuplicates;
+    }
+  }
+
+  // Placements of the merged volumes
+  //
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    G4LogicalVolume* lv = order[i];
+    if (merged.count(lv)) { continue; }
+    for (std::size_t d = 0; d < lv->GetNoDaughters(); ++d)
+    {
+      G4VPhysicalVolume* pv = lv->GetDaughter(d);
+      std::map<G4LogicalVolume*, G4LogicalVolume*>::const_iterator it =
+        merged.find(pv->GetLogicalVolume());
+      if (it == merged.end()) { continue; }
+      pv->SetLogicalVolume(it->second);
+      ++fPlacements;
+    }
+  }
+
+  // The tables refer to this geometry only
+  //
+  fSolids.clear();
+  fVolumes.clear();
+  fVisAttributes.clear();
+
+  Free(merged, replacedSolids);
+
+  visited.clear();
+  order.clear();
+  PostOrder(world->GetLogicalVolume(), visited, order);
+  fVolumesAfter = G4int(order.size());
+
+  return fSolidDuplicates + fVolumeDuplicates;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02SolidInterner::PrintReport() const
+{
+  G4cout << G4endl
+         << "Interning: " << fCreatedDuplicates
+         << " duplicate solids deleted at creation, " << fSolidDuplicates
+         << " replaced in the tree; " << fVolumeDuplicates
+         << " duplicate logical volumes merged (" << fPlacements
+         << " placements), " << fVolumesBefore << " -> " << fVolumesAfter
+         << " logical volumes in the tree; " << fVolumesFreed
+         << " logical volumes and " << fSolidsFreed << " solids deleted"
+         << G4endl << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,308 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02StartupProfiler.cc
+/// \brief Implementation of the G02StartupProfiler class
+//
+//
+//
+// Class G02StartupProfiler implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02StartupProfiler.hh"
+#include "G02ResourceUsage.hh"
+
+#include "G4ios.hh"
+#include "G4StateManager.hh"
+#include "G4GeometryManager.hh"
+#include "G4Threading.hh"
+
+#include <fstream>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // Phase names as JSON string contents
+  //
+  std::string JsonEscape(const G4String& text)
+  {
+    static const char hex[] = "0123456789abcdef";
+    std::string escaped;
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+      unsigned char c = text[i];
+      if      (c == '"')  { escaped += "\\\""; }
+      else if (c == '\\') { escaped += "\\\\"; }
+      else if (c == '\n') { escaped += "\\n"; }
+      else if (c == '\t') { escaped += "\\t"; }
+      else if (c < 0x20)
+      {
+        escaped += "\\u00";
+        escaped += hex[c >> 4];
+        escaped += hex[c & 0xF];
+      }
+      else { escaped += char(c); }
+    }
+    return escaped;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StartupProfiler* G02StartupProfiler::Instance()
+{
+  static G02StartupProfiler* theInstance = new G02StartupProfiler;
+  return theInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StartupProfiler::G02StartupProfiler()
+  : G4VStateDependent(),
+    fOrigin(G02ResourceUsage::WallTime()),
+    fKernelPhase(-1),
+    fEnabled(false),
+    fTrialVoxelisation(false)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StartupProfiler::~G02StartupProfiler()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StartupProfiler::Sample G02StartupProfiler::TakeSample() const
+{
+  Sample sample;
+  sample.fWall = G02ResourceUsage::WallTime();
+  sample.fCpu = G02ResourceUsage::CpuTime();
+  sample.fPeakMemory = G02ResourceUsage::PeakResidentMemory();
+  return sample;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StartupProfiler::Sample G02StartupProfiler::EndOf(const Phase& phase) const
+{
+  // Phases still open are reported up to now
+  //
+  return phase.fClosed ? phase.fEnd : TakeSample();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StartupProfiler::BeginPhase(const G4String& name)
+{
+  if (!G4Threading::IsMasterThread()) { return; }
+
+  Phase phase;
+  phase.fName = name;
+  phase.fDepth = G4int(fOpenPhases.size());
+  phase.fBegin = TakeSample();
+  phase.fEnd = phase.fBegin;
+  phase.fClosed = false;
+
+  fOpenPhases.push_back(fPhases.size());
+  fPhases.push_back(phase);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StartupProfiler::EndPhase()
+{
+  if (!G4Threading::IsMasterThread() || fOpenPhases.empty()) { return; }
+
+  // The kernel phase is closed by the state transitions only
+  //
+  std::size_t index = fOpenPhases.back();
+  if (G4int(index) == fKernelPhase) { return; }
+
+  fPhases[index].fEnd = TakeSample();
+  fPhases[index].fClosed = true;
+  fOpenPhases.pop_back();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StartupProfiler::CloseKernelPhase()
+{
+  if (fKernelPhase < 0) { return; }
+
+  // Close everything opened within the kernel phase, which may have been
+  // left open by an exception
+  //
+  Sample now = TakeSample();
+  while (!fOpenPhases.empty())
+  {
+    std::size_t index = fOpenPhases.back();
+    fOpenPhases.pop_back();
+    fPhases[index].fEnd = now;
+    fPhases[index].fClosed = true;
+    if (G4int(index) == fKernelPhase) { break; }
+  }
+  fKernelPhase = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02StartupProfiler::Notify(G4ApplicationState requestedState)
+{
+  G4ApplicationState currentState =
+    G4StateManager::GetStateManager()->GetCurrentState();
+  if (currentState == requestedState) { return true; }
+
+  if (requestedState == G4State_Init && fKernelPhase < 0)
+  {
+    // PreInit->Init is "/run/initialize"; Idle->Init is the run set-up done
+    // by the kernel at "/run/beamOn" (physics tables and voxelisation), or a
+    // re-initialisation after a geometry or physics change
+    //
+    BeginPhase(currentState == G4State_PreInit ? "run/initialize"
+                                               : "run/setup");
+    fKernelPhase = G4int(fOpenPhases.size()) - 1;
+  }
+  else if (requestedState == G4State_Idle && currentState == G4State_Init
+           && fKernelPhase >= 0)
+  {
+    if (fTrialVoxelisation && fPhases[fKernelPhase].fName == "run/initialize")
+    {
+      // The kernel voxelises the geometry at the first run together with
+      // the building of the physics tables. Optimise it once here, on its
+      // own, to split the two contributions; the kernel redoes it later.
+      //
+      BeginPhase("voxelisation (trial)");
+      G4GeometryManager* geomManager = G4GeometryManager::GetInstance();
+      geomManager->CloseGeometry(true);
+      geomManager->OpenGeometry();
+      EndPhase();
+    }
+    CloseKernelPhase();
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G02StartupProfiler::ChildrenWall(std::size_t index) const
+{
+  G4double wall = 0.;
+  for (std::size_t i = index+1; i < fPhases.size(); ++i)
+  {
+    if (fPhases[i].fDepth <= fPhases[index].fDepth) { break; }
+    if (fPhases[i].fDepth == fPhases[index].fDepth+1)
+    {
+      wall += EndOf(fPhases[i]).fWall - fPhases[i].fBegin.fWall;
+    }
+  }
+  return wall;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StartupProfiler::Print() const
+{
+  G4cout << G4endl
+         << "=================== Start-up profile ===================" << G4endl
+         << std::setw(44) << std::left << " Phase" << std::right
+         << std::setw(10) << "wall [s]" << std::setw(10) << "self [s]"
+         << std::setw(10) << "cpu [s]" << std::setw(13) << "+peakRSS [MB]"
+         << std::setw(12) << "peakRSS [MB]" << G4endl;
+
+  for (std::size_t i = 0; i < fPhases.size(); ++i)
+  {
+    const Phase& phase = fPhases[i];
+    Sample end = EndOf(phase);
+    G4double wall = end.fWall - phase.fBegin.fWall;
+
+    G4String label = " " + std::string(2*phase.fDepth, ' ') + phase.fName;
+    if (!phase.fClosed) { label += " (open)"; }
+
+    G4cout << std::setw(44) << std::left << label << std::right
+           << std::fixed << std::setprecision(3)
+           << std::setw(10) << wall
+           << std::setw(10) << wall - ChildrenWall(i)
+           << std::setw(10) << end.fCpu - phase.fBegin.fCpu
+           << std::setprecision(1)
+           << std::setw(13) << (end.fPeakMemory - phase.fBegin.fPeakMemory)/1024.
+           << std::setw(12) << end.fPeakMemory/1024.
+           << G4endl;
+  }
+  G4cout.unsetf(std::ios::fixed);
+  G4cout << std::setprecision(6)
+         << "========================================================" << G4endl
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02StartupProfiler::WriteChromeTrace(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (!out)
+  {
+    G4cerr << "G02StartupProfiler: cannot open trace file "
+           << fileName << G4endl;
+    return false;
+  }
+
+  // "Complete" events; times are in microseconds since the profiler start
+  //
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (std::size_t i = 0; i < fPhases.size(); ++i)
+  {
+    const Phase& phase = fPhases[i];
+    Sample end = EndOf(phase);
+    out << (i ? "," : "") << "\n {\"name\":\"" << JsonEscape(phase.fName)
+        << "\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+        << std::fixed << std::setprecision(1)
+        << ",\"ts\":" << 1.e6*(phase.fBegin.fWall - fOrigin)
+        << ",\"dur\":" << 1.e6*(end.fWall - phase.fBegin.fWall)
+        << std::setprecision(6)
+        << ",\"args\":{\"cpu_s\":" << end.fCpu - phase.fBegin.fCpu
+        << ",\"peak_rss_kb\":" << end.fPeakMemory
+        << ",\"peak_rss_delta_kb\":"
+        << end.fPeakMemory - phase.fBegin.fPeakMemory << "}}";
+  }
+  out << "\n]}" << std::endl;
+
+  return bool(out);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StartupProfiler::Finish()
+{
+  if (fEnabled) { Print(); }
+  if (!fTraceFile.empty() && WriteChromeTrace(fTraceFile))
+  {
+    G4cout << "Start-up trace written to " << fTraceFile << G4endl;
+  }
+}
@@ -0,0 +1,134 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02StepRecorder.cc
+/// \brief Implementation of the G02StepRecorder class
+//
+//
+//
+// Class G02StepRecorder implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02StepRecorder.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+
+namespace
+{
+  G4ThreadLocal G02StepRecorder* theThreadRecorder = 0;
+  G4ThreadLocal std::size_t theBlockSize = 0;
+  G4ThreadLocal G4int theNumberOfBlocks = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepRecorder::G02StepRecorder(std::size_t blockSize, G4int nBlocks)
+  : fWriter(G02StepWriter::Instance()),
+    fCurrentIndex(0),
+    fCurrent(0),
+    fRun(0),
+    fThread(G4Threading::G4GetThreadId())
+{
+  // At least two blocks, so that one can be filled while the other
+  // is written
+  //
+  for (G4int i = 0; i < std::max(nBlocks, 2); ++i)
+  {
+    fBlocks.push_back(new G02StepWriter::Block(std::max(blockSize,
+                                                        std::size_t(1))));
+    fBlocks.back()->fThread = fThread;
+  }
+  fCurrent = fBlocks[0];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepRecorder::~G02StepRecorder()
+{
+  // Blocks may still be in the writer queue
+  //
+  Flush();
+  for (std::size_t i = 0; i < fBlocks.size(); ++i)
+  {
+    fWriter->WaitUntilWritten(fBlocks[i]);
+    delete fBlocks[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepRecorder* G02StepRecorder::GetThreadInstance()
+{
+  return theThreadRecorder;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepRecorder* G02StepRecorder::CreateThreadInstance(std::size_t blockSize,
+                                                       G4int nBlocks)
+{
+  if (theThreadRecorder != 0
+      && (blockSize != theBlockSize || nBlocks != theNumberOfBlocks))
+  {
+    DeleteThreadInstance();
+  }
+  if (theThreadRecorder == 0)
+  {
+    theThreadRecorder = new G02StepRecorder(blockSize, nBlocks);
+    theBlockSize = blockSize;
+    theNumberOfBlocks = nBlocks;
+  }
+  return theThreadRecorder;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StepRecorder::DeleteThreadInstance()
+{
+  delete theThreadRecorder;
+  theThreadRecorder = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StepRecorder::Flush()
+{
+  if (fCurrent->fSize > 0) { NextBlock(); }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StepRecorder::NextBlock()
+{
+  fWriter->Submit(fCurrent);
+
+  fCurrentIndex = (fCurrentIndex + 1) % fBlocks.size();
+  fCurrent = fBlocks[fCurrentIndex];
+  fWriter->WaitUntilWritten(fCurrent);
+  fCurrent->fRun = fRun;
+}
@@ -0,0 +1,370 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02StepWriter.cc
+/// \brief Implementation of the G02StepWriter class
+//
+//
+//
+// Class G02StepWriter implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02StepWriter.hh"
+#include "G02ResourceUsage.hh"
+
+#include "G4ios.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(_WIN32)
+#  include <fcntl.h>
+#  include <limits.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#  if !defined(IOV_MAX)
+#    define IOV_MAX 1024
+#  endif
+#endif
+
+namespace
+{
+  // Header of a block chunk
+  //
+  struct BlockHeader
+  {
+    char          fTag[4];
+    std::uint32_t fSize;
+    std::int32_t  fRun;
+    std::int32_t  fThread;
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepWriter::Block::Block(std::size_t capacity)
+  : fCapacity(capacity), fSize(0), fRun(0), fThread(0), fQueued(false),
+    fEvent(capacity), fTrack(capacity), fVolume(capacity),
+    fX(capacity), fY(capacity), fZ(capacity), fEdep(capacity), fTime(capacity)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepWriter* G02StepWriter::Instance()
+{
+  static G02StepWriter* theInstance = new G02StepWriter;
+  return theInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepWriter::G02StepWriter()
+  : fStop(false), fOpen(false),
+#if defined(_WIN32)
+    fFile(0),
+#else
+    fFile(-1),
+#endif
+    fRecords(0), fBytes(0), fWrites(0), fStalls(0), fStallTime(0.),
+    fError(false)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02StepWriter::~G02StepWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02StepWriter::Open(const G4String& fileName)
+{
+  if (fOpen) { Close(); }
+
+  G4bool append = (fileName == fLastFileName);
+#if defined(_WIN32)
+  fFile = std::fopen(fileName.c_str(), append ? "ab" : "wb");
+  G4bool ok = (fFile != 0);
+#else
+  fFile = ::open(fileName.c_str(),
+                 O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+  G4bool ok = (fFile >= 0);
+#endif
+  if (!ok)
+  {
+    G4cerr << "G02StepWriter: cannot open step record file "
+           << fileName << G4endl;
+    return false;
+  }
+
+  fFileName = fileName;
+  fLastFileName = fileName;
+  fRecords = fBytes = fWrites = fStalls = 0;
+  fStallTime = 0.;
+  fError = false;
+
+  if (!append)
+  {
+    std::vector<const void*> data(1, "G02STEP1");
+    std::vector<std::size_t> sizes(1, 8);
+    fError = !WriteBuffers(data, sizes);
+  }
+
+  fStop = false;
+  fOpen = true;
+  fThread = std::thread(&G02StepWriter::WriterLoop, this);
+
+  return !fError;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StepWriter::Close()
+{
+  if (!fOpen) { return; }
+
+  // The writer thread drains the queue before stopping
+  //
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fQueuedCondition.notify_all();
+  fThread.join();
+
+  if (!WriteVolumeTable()) { fError = true; }
+
+#if defined(_WIN32)
+  std::fclose(fFile);
+  fFile = 0;
+#else
+  ::close(fFile);
+  fFile = -1;
+#endif
+  fOpen = false;
+
+  G4cout << "G02StepWriter: " << fRecords << " step records, "
+         << fBytes/1024 << " kB in " << fWrites << " writes to "
+         << fFileName << "; " << fStalls << " tracking stalls ("
+         << fStallTime << " s)" << G4endl;
+  if (fError)
+  {
+    G4cerr << "G02StepWriter: write error on " << fFileName
+           << ", the file is incomplete" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StepWriter::Submit(Block* block)
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fOpen || fStop)
+    {
+      // Nothing to write to: the records are dropped
+      //
+      block->fSize = 0;
+      return;
+    }
+    block->fQueued = true;
+    fQueue.push_back(block);
+  }
+  fQueuedCondition.notify_one();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StepWriter::WaitUntilWritten(Block* block)
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  if (!block->fQueued) { return; }
+
+  ++fStalls;
+  G4double start = G02ResourceUsage::WallTime();
+  fWrittenCondition.wait(lock, [block]{ return !block->fQueued; });
+  fStallTime += G02ResourceUsage::WallTime() - start;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02StepWriter::WriterLoop()
+{
+  std::vector<Block*> batch;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fQueuedCondition.wait(lock, [this]{ return fStop || !fQueue.empty(); });
+      if (fQueue.empty()) { break; }   // Stopped, and nothing left
+      batch.assign(fQueue.begin(), fQueue.end());
+      fQueue.clear();
+    }
+
+    // Written without holding the lock: the tracking threads keep
+    // filling their other blocks meanwhile
+    //
+    G4bool ok = WriteBlocks(batch);
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      if (!ok) { fError = true; }
+      for (std::size_t i = 0; i < batch.size(); ++i)
+      {
+        fRecords += batch[i]->fSize;
+        batch[i]->fSize = 0;
+        batch[i]->fQueued = false;
+      }
+    }
+    fWrittenCondition.notify_all();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02StepWriter::WriteBlocks(const std::vector<Block*>& blocks)
+{
+  // One header and eight columns per block, gathered in a single
+  // vectored write
+  //
+  std::vector<BlockHeader> headers(blocks.size());
+  std::vector<const void*> data;
+  std::vector<std::size_t> sizes;
+  data.reserve(9*blocks.size());
+  sizes.reserve(9*blocks.size());
+
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+  {
+    const Block* block = blocks[i];
+    std::size_t n = block->fSize;
+    if (n == 0) { continue; }
+
+    BlockHeader& header = headers[i];
+    std::memcpy(header.fTag, "BLK0", 4);
+    header.fSize = std::uint32_t(n);
+    header.fRun = block->fRun;
+    header.fThread = block->fThread;
+
+    data.push_back(&header);        sizes.push_back(sizeof(header));
+    data.push_back(&block->fEvent[0]);  sizes.push_back(n*sizeof(std::int32_t));
+    data.push_back(&block->fTrack[0]);  sizes.push_back(n*sizeof(std::int32_t));
+    data.push_back(&block->fVolume[0]); sizes.push_back(n*sizeof(std::int32_t));
+    data.push_back(&block->fX[0]);      sizes.push_back(n*sizeof(G4double));
+    data.push_back(&block->fY[0]);      sizes.push_back(n*sizeof(G4double));
+    data.push_back(&block->fZ[0]);      sizes.push_back(n*sizeof(G4double));
+    data.push_back(&block->fEdep[0]);   sizes.push_back(n*sizeof(G4double));
+    data.push_back(&block->fTime[0]);   sizes.push_back(n*sizeof(G4double));
+  }
+
+  return WriteBuffers(data, sizes);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02StepWriter::WriteVolumeTable()
+{
+  const G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+
+  std::vector<std::int32_t> ids(store->size());
+  std::vector<std::uint32_t> lengths(store->size());
+  std::uint32_t count = std::uint32_t(store->size());
+
+  std::vector<const void*> data;
+  std::vector<std::size_t> sizes;
+  data.push_back("VOL0");  sizes.push_back(4);
+  data.push_back(&count);  sizes.push_back(sizeof(count));
+  for (std::size_t i = 0; i < store->size(); ++i)
+  {
+    const G4String& name = (*store)[i]->GetName();
+    ids[i] = (*store)[i]->GetInstanceID();
+    lengths[i] = std::uint32_t(name.size());
+    data.push_back(&ids[i]);      sizes.push_back(sizeof(std::int32_t));
+    data.push_back(&lengths[i]);  sizes.push_back(sizeof(std::uint32_t));
+    data.push_back(name.data());  sizes.push_back(name.size());
+  }
+
+  return WriteBuffers(data, sizes);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02StepWriter::WriteBuffers(const std::vector<const void*>& data,
+                                   const std::vector<std::size_t>& sizes)
+{
+#if defined(_WIN32)
+  // No vectored write: one buffered write per column
+  //
+  for (std::size_t i = 0; i < data.size(); ++i)
+  {
+    if (std::fwrite(data[i], 1, sizes[i], fFile) != sizes[i]) { return false; }
+    fBytes += sizes[i];
+  }
+  ++fWrites;
+  return true;
+#else
+  std::vector<struct iovec> iov(data.size());
+  for (std::size_t i = 0; i < data.size(); ++i)
+  {
+    iov[i].iov_base = const_cast<void*>(data[i]);
+    iov[i].iov_len = sizes[i];
+  }
+
+  // writev() may write less than asked: resume from where it stopped
+  //
+  std::size_t first = 0;
+  while (first < iov.size())
+  {
+    G4int count = G4int(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+    ssize_t written = ::writev(fFile, &iov[first], count);
+    if (written < 0)
+    {
+      if (errno == EINTR) { continue; }
+      return false;
+    }
+    fBytes += written;
+    ++fWrites;
+
+    std::size_t left = std::size_t(written);
+    while (first < iov.size() && left >= iov[first].iov_len)
+    {
+      left -= iov[first].iov_len;
+      ++first;
+    }
+    if (left > 0)
+    {
+      iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+      iov[first].iov_len -= left;
+    }
+  }
+  return true;
+#endif
+}
@@ -0,0 +1,125 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02SteppingAction.cc
+/// \brief Implementation of the G02SteppingAction class
+//
+//
+//
+// Class G02SteppingAction implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02SteppingAction.hh"
+#include "G02RunAction.hh"
+#include "G02Run.hh"
+#include "G02ResourceUsage.hh"
+#include "G02StepRecorder.hh"
+
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Track.hh"
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02SteppingAction::G02SteppingAction(const G02RunAction* runAction)
+  : G4UserSteppingAction(),
+    fRunAction(runAction),
+    fLastTime(0.)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02SteppingAction::~G02SteppingAction()
+{
+  // The recorder of this thread, if any, goes with its stepping action
+  //
+  G02StepRecorder::DeleteThreadInstance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02SteppingAction::ResetClock()
+{
+  if (fRunAction->IsProfilingVolumes())
+  {
+    fLastTime = G02ResourceUsage::WallTime();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02SteppingAction::UserSteppingAction(const G4Step* aStep)
+{
+  // The run is thread-local: no locking is needed
+  //
+  G02Run* run = static_cast<G02Run*>(
+    G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->CountStep();
+
+  const G4StepPoint* preStepPoint = aStep->GetPreStepPoint();
+
+  if (fRunAction->IsRecordingSteps())
+  {
+    const G4StepPoint* postStepPoint = aStep->GetPostStepPoint();
+    G02StepRecorder::GetThreadInstance()->Record(
+      G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
+      aStep->GetTrack()->GetTrackID(),
+      preStepPoint->GetPhysicalVolume()->GetLogicalVolume()->GetInstanceID(),
+      postStepPoint->GetPosition(), aStep->GetTotalEnergyDeposit(),
+      postStepPoint->GetGlobalTime());
+  }
+
+  if (fRunAction->IsScanningMaterialBudget()
+      && aStep->GetTrack()->GetParentID() == 0)
+  {
+    const G4Material* material = preStepPoint->GetMaterial();
+    G4double length = aStep->GetStepLength();
+    G4double x0 = length/material->GetRadlen();
+    G4double lambda = length/material->GetNuclearInterLength();
+
+    fRayBudget.fPath += length;
+    fRayBudget.fX0 += x0;
+    fRayBudget.fLambda += lambda;
+    run->AddMaterialStep(material, length, x0, lambda);
+  }
+
+  if (!fRunAction->IsProfilingVolumes()) { return; }
+
+  G4double now = G02ResourceUsage::WallTime();
+  G4double elapsed = now - fLastTime;
+  fLastTime = now;
+
+  G4bool boundary =
+    aStep->GetPostStepPoint()->GetStepStatus() == fGeomBoundary;
+
+  run->AddStep(preStepPoint->GetPhysicalVolume()->GetLogicalVolume(),
+               boundary, elapsed);
+}
@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02TrackingAction.cc
+/// \brief Implementation of the G02TrackingAction class
+//
+//
+//
+// Class G02TrackingAction implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02TrackingAction.hh"
+#include "G02SteppingAction.hh"
+#include "G02RunAction.hh"
+#include "G02PrimaryGeneratorAction.hh"
+#include "G02Run.hh"
+
+#include "G4Track.hh"
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02TrackingAction::G02TrackingAction(const G02RunAction* runAction,
+                                     G02SteppingAction* steppingAction)
+  : G4UserTrackingAction(),
+    fRunAction(runAction),
+    fSteppingAction(steppingAction)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02TrackingAction::~G02TrackingAction()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02TrackingAction::PreUserTrackingAction(const G4Track*)
+{
+  fSteppingAction->ResetClock();
+  fSteppingAction->ResetRayBudget();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02TrackingAction::PostUserTrackingAction(const G4Track* aTrack)
+{
+  if (!fRunAction->IsScanningMaterialBudget() || aTrack->GetParentID() != 0)
+  {
+    return;
+  }
+
+  // The primaries of an event get the track IDs 1..K in the order of
+  // the rays
+  //
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  const G02PrimaryGeneratorAction* generator =
+    static_cast<const G02PrimaryGeneratorAction*>(
+      runManager->GetUserPrimaryGeneratorAction());
+
+  G02Run::RayBudget ray;
+  ray.fRay = G4long(runManager->GetCurrentEvent()->GetEventID())
+             *generator->GetRaysPerEvent() + aTrack->GetTrackID() - 1;
+  ray.fOrigin = aTrack->GetVertexPosition();
+  ray.fDirection = aTrack->GetVertexMomentumDirection();
+  ray.fBudget = fSteppingAction->GetRayBudget();
+
+  static_cast<G02Run*>(runManager->GetNonConstCurrentRun())->AddRayBudget(ray);
+}
@@ -0,0 +1,375 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file persistency/gdml/G02/src/G02VoxelMap.cc
+/// \brief Implementation of the G02VoxelMap class
+//
+//
+//
+// Class G02VoxelMap implementation
+//
+// ----------------------------------------------------------------------------
+
+#include "G02VoxelMap.hh"
+#include "G02ResourceUsage.hh"
+#include "G02CoherentNavigator.hh"
+
+#include "G4ios.hh"
+#include "G4VSolid.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Material.hh"
+#include "G4GeometryManager.hh"
+#include "G4GeometryWorkspace.hh"
+#include "G4SolidsWorkspace.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  const char magic[8] = { 'G','0','2','V','O','X','L','1' };
+  const std::uint32_t version = 1;
+  const std::uint16_t outside = 0xFFFF;
+
+  // Zero steps in a row after which the walk restarts at the next voxel
+  //
+  const G4int maxZeroSteps = 10;
+
+  std::uint64_t Align(std::uint64_t offset)
+  {
+    return (offset + 7) & ~std::uint64_t(7);
+  }
+
+  std::uint16_t MaterialOf(const G4VPhysicalVolume* volume)
+  {
+    if (volume == 0) { return outside; }
+    const G4Material* material = volume->GetLogicalVolume()->GetMaterial();
+    return material ? std::uint16_t(material->GetIndex()) : outside;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02VoxelMap::G02VoxelMap()
+  : fThreads(0), fLocateCalls(0), fRelocateCalls(0)
+{
+  fBins[0] = fBins[1] = fBins[2] = 128;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G02VoxelMap::~G02VoxelMap()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G02VoxelMap::Walk(const G4VPhysicalVolume* world,
+                       std::atomic<G4int>& nextSlice, G4bool workspace)
+{
+  // Copies of the per-thread data of the volumes and solids, as for a
+  // worker thread
+  //
+#ifdef G4MULTITHREADED
+  G4GeometryWorkspace* geometryWorkspace = 0;
+  G4SolidsWorkspace* solidsWorkspace = 0;
+  if (workspace)
+  {
+    geometryWorkspace = G4GeometryWorkspace::GetPool()->CreateAndUseWorkspace();
+    solidsWorkspace = G4SolidsWorkspace::GetPool()->CreateAndUseWorkspace();
+  }
+#else
+  (void)workspace;
+#endif
+
+  G02CoherentNavigator navigator;
+  navigator.SetWorldVolume(const_cast<G4VPhysicalVolume*>(world));
+
+  const G4int nx = fBins[0];
+  const G4int ny = fBins[1];
+  const G4double dx = fSize.x();
+  const G4double x0 = fMin.x() + 0.5*dx;
+  const G4double length = (nx-1)*dx;    // From the first to the last centre
+  G4long locateCalls = 0, relocateCalls = 0;
+
+  // The rows of a slice are walked back and forth, so that each row starts
+  // next to where the previous one ended and is located from there
+  //
+  for (G4int slice = nextSlice++; slice < fBins[2]; slice = nextSlice++)
+  {
+    for (G4int j = 0; j < ny; ++j)
+    {
+      const G4long row = G4long(slice)*ny + j;
+      std::uint16_t* voxels = &fGrid[row*nx];
+      const G4bool forward = (j % 2 == 0);
+      const G4ThreeVector direction(forward ? 1. : -1., 0., 0.);
+      G4ThreeVector position(forward ? x0 : x0 + length,
+                             fMin.y() + (j + 0.5)*fSize.y(),
+                             fMin.z() + (slice + 0.5)*fSize.z());
+
+      G4VPhysicalVolume* volume = navigator.Locate(position, &direction);
+      ++locateCalls;
+
+      // i: voxels done along the walk, t: distance of the current point
+      // from the first centre
+      //
+      G4int i = 0;
+      G4double t = 0.;
+      G4int zeroSteps = 0;
+      while (i < nx)
+      {
+        std::uint16_t material = MaterialOf(volume);
+        G4double step = 0.;
+        if (volume != 0)
+        {
+          G4double safety = 0.;
+          step = navigator.ComputeStep(position, direction, length - t,
+                                       safety);
+        }
+        zeroSteps = (volume != 0 && step <= 0.) ? zeroSteps+1 : 0;
+
+        if (volume == 0 || zeroSteps > maxZeroSteps)
+        {
+          // Outside the world, or stuck: the next voxel is located on its
+          // own, from scratch when stuck
+          //
+          voxels[forward ? i : nx-1-i] = material;
+          if (++i == nx) { break; }
+          t = i*dx;
+          position.setX(forward ? x0 + t : x0 + length - t);
+          if (zeroSteps > maxZeroSteps) { navigator.ResetStackAndState(); }
+          volume = navigator.Locate(position, &direction);
+          ++locateCalls;
+          zeroSteps = 0;
+          continue;
+        }
+
+        // The centres before the boundary are in the current volume
+        //
+        G4double boundary = (step >= length - t) ? kInfinity : t + step;
+        while (i < nx && i*dx < boundary)
+        {
+          voxels[forward ? i : nx-1-i] = material;
+          ++i;
+        }
+        if (i == nx) { break; }
+
+        t = boundary;
+        position.setX(forward ? x0 + t : x0 + length - t);
+        navigator.SetGeometricallyLimitedStep();
+        volume = navigator.LocateGlobalPointAndSetup(position, &direction,
+                                                     true);
+        ++relocateCalls;
+      }
+    }
+  }
+
+  fLocateCalls += locateCalls;
+  fRelocateCalls += relocateCalls;
+  {
+    std::lock_guard<std::mutex> lock(fStatisticsMutex);
+    fLocateStatistics.Add(navigator.GetStatistics());
+  }
+
+#ifdef G4MULTITHREADED
+  if (workspace)
+  {
+    G4SolidsWorkspace::GetPool()->ReleaseAndDestroyWorkspace(solidsWorkspace);
+    G4GeometryWorkspace::GetPool()
+      ->ReleaseAndDestroyWorkspace(geometryWorkspace);
+  }
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G02VoxelMap::Export(const G4VPhysicalVolume* world,
+                           const G4String& fileName)
+{
+  if (world == 0)
+  {
+    G4cerr << "G02VoxelMap: no geometry" << G4endl;
+    return false;
+  }
+  G4double startTime = G02ResourceUsage::WallTime();
+
+  // Grid on the bounding box of the world, placed at the origin
+  //
+  G4ThreeVector pMin, pMax;
+  world->GetLogicalVolume()->GetSolid()->BoundingLimits(pMin, pMax);
+  fMin = pMin;
+  fSize = G4ThreeVector((pMax.x()-pMin.x())/fBins[0],
+                        (pMax.y()-pMin.y())/fBins[1],
+                        (pMax.z()-pMin.z())/fBins[2]);
+  const G4long nVoxels = G4long(fBins[0])*fBins[1]*fBins[2];
+  fGrid.assign(nVoxels, outside);
+  fLocateCalls = 0;
+  fRelocateCalls = 0;
+  fLocateStatistics = G02CoherentNavigator::Statistics();
+
+  // The navigation needs the smart voxels of the volumes; the geometry is
+  // left open, as found, if it was
+  //
+  G4GeometryManager* geomManager = G4GeometryManager::GetInstance();
+  G4bool wasOpen = !geomManager->IsGeometryClosed();
+  if (wasOpen) { geomManager->CloseGeometry(true); }
+
+  G4int nThreads = fThreads > 0 ? fThreads : G4Threading::G4GetNumberOfCores();
+#ifndef G4MULTITHREADED
+  // Without per-thread copies of the volumes, the navigation of the
+  // replicas and parameterised volumes of a thread would change them
+  // for the others
+  //
+  nThreads = 1;
+#endif
+  nThreads = std::min(std::max(1, nThreads), fBins[2]);
+  std::atomic<G4int> nextSlice(0);
+  if (nThreads == 1)
+  {
+    Walk(world, nextSlice, false);
+  }
+  else
+  {
+    std::vector<std::thread> pool;
+    for (G4int t = 0; t < nThreads; ++t)
+    {
+      pool.push_back(std::thread(&G02VoxelMap::Walk, this, world,
+                                 std::ref(nextSlice), true));
+    }
+    for (std::size_t t = 0; t < pool.size(); ++t) { pool[t].join(); }
+  }
+
+  if (wasOpen) { geomManager->OpenGeometry(); }
+  G4double walkTime = G02ResourceUsage::WallTime() - startTime;
+
+  // Material table, with the number of voxels of each material
+  //
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  std::vector<MaterialRecord> records(materials->size());
+  std::vector<std::uint64_t> counts(materials->size()+1, 0);
+  for (G4long v = 0; v < nVoxels; ++v)
+  {
+    std::uint16_t index = fGrid[v];
+    ++counts[index == outside ? materials->size() : index];
+  }
+
+  Header header;
+  std::memcpy(header.fMagic, magic, sizeof(magic));
+  header.fVersion = version;
+  header.fMaterials = std::uint32_t(materials->size());
+  header.fOutside = outside;
+  for (G4int k = 0; k < 3; ++k)
+  {
+    header.fBins[k] = std::uint32_t(fBins[k]);
+    header.fMin[k] = pMin[k]/mm;
+    header.fMax[k] = pMax[k]/mm;
+  }
+  header.fMaterialTableOffset = Align(sizeof(Header));
+
+  std::uint64_t offset = header.fMaterialTableOffset
+                       + records.size()*sizeof(MaterialRecord);
+  for (std::size_t m = 0; m < records.size(); ++m)
+  {
+    const G4Material* material = (*materials)[m];
+    MaterialRecord& record = records[m];
+    record.fNameOffset = offset;
+    record.fNameLength = std::uint32_t(material->GetName().size());
+    record.fReserved = 0;
+    record.fDensity = material->GetDensity()/(g/cm3);
+    record.fRadiationLength = material->GetRadlen()/mm;
+    record.fInteractionLength = material->GetNuclearInterLength()/mm;
+    record.fVoxels = counts[m];
+    offset += record.fNameLength;
+  }
+  header.fGridOffset = Align(offset);
+  header.fFileSize =
+    Align(header.fGridOffset + nVoxels*sizeof(std::uint16_t));
+
+  std::ofstream out(fileName, std::ios::binary);
+  if (!out)
+  {
+    G4cerr << "G02VoxelMap: cannot open " << fileName << G4endl;
+    return false;
+  }
+
+  std::uint64_t position = 0;
+  auto put = [&](std::uint64_t at, const void* data, std::size_t size)
+  {
+    static const char zeros[8] = { 0 };
+    out.write(zeros, std::streamsize(at - position));
+    out.write(static_cast<const char*>(data), std::streamsize(size));
+    position = at + size;
+  };
+
+  put(0, &header, sizeof(header));
+  put(header.fMaterialTableOffset, records.data(),
+      records.size()*sizeof(MaterialRecord));
+  for (std::size_t m = 0; m < records.size(); ++m)
+  {
+    put(records[m].fNameOffset, (*materials)[m]->GetName().data(),
+        records[m].fNameLength);
+  }
+  put(header.fGridOffset, fGrid.data(), fGrid.size()*sizeof(std::uint16_t));
+  put(header.fFileSize, 0, 0);
+  if (!out)
+  {
+    G4cerr << "G02VoxelMap: cannot write " << fileName << G4endl;
+    return false;
+  }
+  out.close();
+
+  G4cout << "G02VoxelMap: " << fBins[0] << "x" << fBins[1] << "x" << fBins[2]
+         << " voxels of " << fSize.x()/mm << "x" << fSize.y()/mm << "x"
+         << fSize.z()/mm << " mm3 written to " << fileName << G4endl
+         << "  walked in " << walkTime << " s with " << nThreads
+         << " threads: " << fLocateCalls << " locations, "
+         << fRelocateCalls << " boundary crossings" << G4endl
+         << "  ";
+  fLocateStatistics.Print(G4cout);
+  G4cout << G4endl;
+  for (std::size_t m = 0; m < records.size(); ++m)
+  {
+    if (counts[m] == 0) { continue; }
+    G4cout << "  " << (*materials)[m]->GetName() << ": " << counts[m]
+           << " voxels" << G4endl;
+  }
+  if (counts.back() != 0)
+  {
+    G4cout << "  outside the world: " << counts.back() << " voxels"
+           << G4endl;
+  }
+
+  // The grid is not kept
+  //
+  std::vector<std::uint16_t>().swap(fGrid);
+  return true;
+}
@@ -31,6 +31,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 //
 MLMaterial::MLMaterial ()
+  : materialMessenger(0), verboseLevel(2)
 {
   Material.clear();
   Element.clear();
@@ -300,11 +301,15 @@ void MLMaterial::AddMaterial (G4String name, G4String formula, G4double density,
 
   delete[] sname;
   Material.push_back(aMaterial);
-  G4cout <<" Material:" <<name <<" with formula: " <<formula <<" added! "
-         <<G4endl;
-  G4cout <<"     Nb of Material = " <<Material.size() <<G4endl;
-  G4cout <<"     Nb of Isotope =  " <<Isotope.size() <<G4endl;
-  G4cout <<"     Nb of Element =  " <<Element.size() <<G4endl;
+  if (verboseLevel > 0) {
+    G4cout <<" Material:" <<name <<" with formula: " <<formula <<" added! "
+           <<G4endl;
+  }
+  if (verboseLevel > 1) {
+    G4cout <<"     Nb of Material = " <<Material.size() <<G4endl;
+    G4cout <<"     Nb of Isotope =  " <<Isotope.size() <<G4endl;
+    G4cout <<"     Nb of Element =  " <<Element.size() <<G4endl;
+  }
 }
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -331,8 +336,10 @@ void MLMaterial::AddNISTMaterial (G4String nist_name)
     G4cerr << "G4NIST material " << nist_name << " is unknown to the G4NistManager."<<G4endl;
   } else {
     Material.push_back( aMaterial);
-    G4cout <<" Material:" << nist_name <<" added from G4NistManager tables." << G4endl
-	   <<G4endl;
+    if (verboseLevel > 0) {
+      G4cout <<" Material:" << nist_name <<" added from G4NistManager tables." << G4endl
+	     <<G4endl;
+    }
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
@@ -91,6 +91,15 @@ MLMaterialMessenger::MLMaterialMessenger (MLMaterial * MLMat)
   ListCmd = new G4UIcmdWithoutParameter("/geometry/material/list",this);
   ListCmd->SetGuidance("List the materials defined");
   ListCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  //
+  VerboseCmd = new G4UIcmdWithAnInteger("/geometry/material/verbose",this);
+  VerboseCmd->SetGuidance("Printout when adding materials");
+  VerboseCmd->SetGuidance("  0: none, 1: one line per material,");
+  VerboseCmd->SetGuidance("  2: also the number of materials/elements/isotopes");
+  VerboseCmd->SetGuidance("Use /geometry/material/list for a summary on demand.");
+  VerboseCmd->SetParameterName("level",false);
+  VerboseCmd->SetRange("level>=0 && level<=2");
+  VerboseCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -103,6 +112,7 @@ MLMaterialMessenger::~MLMaterialMessenger ()
   delete DeleteNameCmd;
   delete ListCmd;
   delete ListNISTCmd;
+  delete VerboseCmd;
 }
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -117,6 +127,9 @@ void MLMaterialMessenger::SetNewValue (G4UIcommand* command,G4String newValue)
   } else if (command == ListCmd) {
     materialsManager->ListMaterial();
 
+  } else if (command == VerboseCmd) {
+    materialsManager->SetVerbose(VerboseCmd->GetNewIntValue(newValue));
+
   } else if (command == AddCmd) {
     G4double den, tem, pres ;
     G4String state;